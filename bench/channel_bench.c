@@ -0,0 +1,142 @@
+/* BSD 2-Clause License
+*
+* Copyright (c) 2025, nguyenvannam142@gmail.com
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*
+* 1. Redistributions of source code must retain the above copyright notice, this
+*    list of conditions and the following disclaimer.
+*
+* 2. Redistributions in binary form must reproduce the above copyright notice,
+*    this list of conditions and the following disclaimer in the documentation
+*    and/or other materials provided with the distribution.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+/*
+ * Fan-out of a channel against one queue per subscriber.
+ *
+ * A publisher sends BENCH_NUM_MSGS messages of each size to BENCH_SUBS
+ * subscribers, either published once on a blocking channel or sent into
+ * one SPSC queue per subscriber. The subscribers receive with a blocking
+ * receive and the rate of published messages is printed.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <pthread.h>
+#include <dmosal/osal.h>
+
+#define BENCH_NUM_MSGS 200000
+#define BENCH_QUEUE_SIZE 64
+#define BENCH_SUBS 4
+#define BENCH_RECV_TIMEOUT_USEC OSAL_SEC_USEC
+
+static uint8_t s_msg[4096];
+
+typedef struct {
+	osal_channel_sub_t *sub;
+	osal_queue_t *queue;
+} bench_arg_t;
+
+static void *bench_subscriber(void *arg)
+{
+	bench_arg_t *barg = arg;
+	uint8_t buf[sizeof(s_msg)];
+	osal_error_t res;
+	uint32_t len;
+	uint32_t i;
+
+	for (i = 0; i < BENCH_NUM_MSGS; i++) {
+		if (barg->sub != NULL) {
+			res = osal_channel_recv(barg->sub, buf, sizeof(buf), &len,
+									BENCH_RECV_TIMEOUT_USEC);
+		} else {
+			res = osal_queue_recv(barg->queue, buf, sizeof(buf), BENCH_RECV_TIMEOUT_USEC);
+		}
+		if (res != OSAL_E_OK) {
+			break;
+		}
+	}
+	return NULL;
+}
+
+static void bench_run(uint32_t msglen, bool channel)
+{
+	osal_channel_cfg_t ccfg = {
+		.msglen = msglen,
+		.qsize = BENCH_QUEUE_SIZE,
+		.policy = OSAL_CHANNEL_BLOCK,
+	};
+	osal_queue_cfg_t qcfg = {
+		.msglen = msglen,
+		.qsize = BENCH_QUEUE_SIZE,
+		.type = OSAL_QUEUE_TYPE_SPSC,
+	};
+	bench_arg_t bargs[BENCH_SUBS];
+	pthread_t tids[BENCH_SUBS];
+	osal_channel_t *chan = NULL;
+	uint64_t start = 0;
+	uint64_t end = 0;
+	uint32_t i;
+	uint32_t j;
+
+	memset(bargs, 0, sizeof(bargs));
+	if (channel) {
+		chan = osal_channel_create(&ccfg);
+	}
+	for (j = 0; j < BENCH_SUBS; j++) {
+		if (channel) {
+			bargs[j].sub = osal_channel_subscribe(chan);
+		} else {
+			bargs[j].queue = osal_queue_create(&qcfg);
+		}
+		pthread_create(&tids[j], NULL, bench_subscriber, &bargs[j]);
+	}
+
+	osal_clock_time(&start);
+	for (i = 0; i < BENCH_NUM_MSGS; i++) {
+		if (channel) {
+			osal_channel_publish(chan, s_msg, msglen, BENCH_RECV_TIMEOUT_USEC);
+			continue;
+		}
+		for (j = 0; j < BENCH_SUBS; j++) {
+			osal_queue_send_timed(bargs[j].queue, s_msg, msglen, BENCH_RECV_TIMEOUT_USEC);
+		}
+	}
+	for (j = 0; j < BENCH_SUBS; j++) {
+		pthread_join(tids[j], NULL);
+	}
+	osal_clock_time(&end);
+
+	printf("%-7s %4u bytes x %d subs: %8.0f msg/s\n", channel ? "channel" : "queues",
+		   msglen, BENCH_SUBS, BENCH_NUM_MSGS * 1e9 / (double)(end - start));
+	for (j = 0; j < BENCH_SUBS; j++) {
+		osal_queue_delete(bargs[j].queue);
+	}
+	osal_channel_delete(chan);
+}
+
+int main(void)
+{
+	if (osal_init(NULL) != OSAL_E_OK) {
+		return -1;
+	}
+	bench_run(64, false);
+	bench_run(64, true);
+	bench_run(sizeof(s_msg), false);
+	bench_run(sizeof(s_msg), true);
+	osal_deinit();
+	return 0;
+}
@@ -0,0 +1,115 @@
+/* BSD 2-Clause License
+*
+* Copyright (c) 2025, nguyenvannam142@gmail.com
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*
+* 1. Redistributions of source code must retain the above copyright notice, this
+*    list of conditions and the following disclaimer.
+*
+* 2. Redistributions in binary form must reproduce the above copyright notice,
+*    this list of conditions and the following disclaimer in the documentation
+*    and/or other materials provided with the distribution.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+/*
+ * Contention of an osal mutex against a pthread mutex.
+ *
+ * 1 to BENCH_NUM_THREADS threads lock, increment a shared counter and
+ * unlock BENCH_NUM_LOOPS times each, a short critical section as in the
+ * resource pools, and the mean time of a lock/unlock pair is printed. The
+ * osal mutex is the futex one when built with OSAL_CONFIG_MUTEX_FUTEX=1.
+ */
+
+#include <stdio.h>
+#include <stdbool.h>
+#include <pthread.h>
+#include <dmosal/osal.h>
+
+#define BENCH_NUM_THREADS 4
+#define BENCH_NUM_LOOPS 1000000
+
+static osal_mutex_t *s_mutex;
+static pthread_mutex_t s_pthmutex = PTHREAD_MUTEX_INITIALIZER;
+static uint64_t s_counter;
+
+static void *bench_osal(void *arg)
+{
+	uint32_t i;
+	(void)arg;
+
+	for (i = 0; i < BENCH_NUM_LOOPS; i++) {
+		osal_mutex_lock(s_mutex);
+		s_counter++;
+		osal_mutex_unlock(s_mutex);
+	}
+	return NULL;
+}
+
+static void *bench_pthread(void *arg)
+{
+	uint32_t i;
+	(void)arg;
+
+	for (i = 0; i < BENCH_NUM_LOOPS; i++) {
+		pthread_mutex_lock(&s_pthmutex);
+		s_counter++;
+		pthread_mutex_unlock(&s_pthmutex);
+	}
+	return NULL;
+}
+
+static void bench_run(uint32_t n_threads, bool osal)
+{
+	pthread_t tids[BENCH_NUM_THREADS];
+	uint64_t start = 0;
+	uint64_t end = 0;
+	uint32_t i;
+
+	s_counter = 0;
+	osal_clock_time(&start);
+	for (i = 0; i < n_threads; i++) {
+		pthread_create(&tids[i], NULL, osal ? bench_osal : bench_pthread, NULL);
+	}
+	for (i = 0; i < n_threads; i++) {
+		pthread_join(tids[i], NULL);
+	}
+	osal_clock_time(&end);
+
+	printf("%-7s %u threads: %6.1f ns/lock%s\n",
+		   osal ? (OSAL_MUTEX_FUTEX ? "futex" : "osal") : "pthread", n_threads,
+		   (double)(end - start) / ((double)n_threads * BENCH_NUM_LOOPS),
+		   (s_counter == (uint64_t)n_threads * BENCH_NUM_LOOPS) ? "" : " (lost updates)");
+}
+
+int main(void)
+{
+	uint32_t n;
+
+	if (osal_init(NULL) != OSAL_E_OK) {
+		return -1;
+	}
+	s_mutex = osal_mutex_create();
+	if (s_mutex == NULL) {
+		return -1;
+	}
+	for (n = 1; n <= BENCH_NUM_THREADS; n *= 2) {
+		bench_run(n, false);
+		bench_run(n, true);
+	}
+	osal_mutex_delete(s_mutex);
+	osal_deinit();
+	return 0;
+}
@@ -0,0 +1,246 @@
+/* BSD 2-Clause License
+*
+* Copyright (c) 2025, nguyenvannam142@gmail.com
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*
+* 1. Redistributions of source code must retain the above copyright notice, this
+*    list of conditions and the following disclaimer.
+*
+* 2. Redistributions in binary form must reproduce the above copyright notice,
+*    this list of conditions and the following disclaimer in the documentation
+*    and/or other materials provided with the distribution.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+/*
+ * Throughput of the queue types.
+ *
+ * The producers send NUM_MSGS messages in total, retrying while the queue
+ * is full, and the consumers receive them with a blocking receive. The
+ * POSIX and the MPMC queues are measured from 1 to BENCH_THREADS_MAX
+ * producers and consumers.
+ *
+ * The in-process queues are then measured with large messages, built and
+ * consumed either in a local buffer or in place with reserve/commit and
+ * peek/release. Last, each queue type moves small messages in batches of
+ * BENCH_BATCH against one message per call.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sched.h>
+#include <pthread.h>
+#include <dmosal/osal.h>
+
+#define BENCH_NUM_MSGS 1000000
+#define BENCH_MSG_LEN 64
+#define BENCH_MSG_LEN_LARGE 4096
+#define BENCH_QUEUE_SIZE 10 /* the default limit of the POSIX queues */
+#define BENCH_THREADS_MAX 8
+#define BENCH_BATCH 8
+
+typedef enum {
+	BENCH_MODE_COPY = 0, /* send and recv */
+	BENCH_MODE_ZEROCOPY, /* reserve/commit and peek/release */
+	BENCH_MODE_BATCH, /* send_batch and recv_batch of BENCH_BATCH messages */
+} bench_mode_t;
+
+static const char s_mode_tag[] = {' ', 'z', 'b'};
+
+typedef struct {
+	osal_queue_t *queue;
+	uint32_t msglen;
+	bench_mode_t mode;
+	uint32_t n_msgs;
+	uint32_t *received;
+} bench_arg_t;
+
+static void bench_send_batch(bench_arg_t *barg, uint8_t *msg, uint32_t n)
+{
+	uint8_t *msgs[BENCH_BATCH];
+	uint32_t lens[BENCH_BATCH];
+	uint32_t sent;
+	uint32_t i;
+
+	for (i = 0; i < n; i++) {
+		msgs[i] = msg;
+		lens[i] = barg->msglen;
+	}
+	while (n > 0) {
+		if (osal_queue_send_batch(barg->queue, msgs, lens, n, &sent) != OSAL_E_OK) {
+			sched_yield();
+		}
+		n -= sent;
+	}
+}
+
+static void *bench_producer(void *arg)
+{
+	bench_arg_t *barg = arg;
+	uint8_t msg[BENCH_MSG_LEN_LARGE];
+	uint8_t *ptr;
+	uint32_t i;
+
+	for (i = 0; i < barg->n_msgs; i++) {
+		switch (barg->mode) {
+		case BENCH_MODE_ZEROCOPY:
+			while (osal_queue_reserve(barg->queue, &ptr) == OSAL_E_QFULL) {
+				sched_yield();
+			}
+			memset(ptr, i, barg->msglen);
+			osal_queue_commit(barg->queue, ptr, barg->msglen);
+			break;
+		case BENCH_MODE_BATCH:
+			memset(msg, i, barg->msglen);
+			if (barg->n_msgs - i < BENCH_BATCH) {
+				bench_send_batch(barg, msg, barg->n_msgs - i);
+				return NULL;
+			}
+			bench_send_batch(barg, msg, BENCH_BATCH);
+			i += BENCH_BATCH - 1;
+			break;
+		default:
+			memset(msg, i, barg->msglen);
+			while (osal_queue_send(barg->queue, msg, barg->msglen) == OSAL_E_QFULL) {
+				sched_yield();
+			}
+			break;
+		}
+	}
+	return NULL;
+}
+
+static void *bench_consumer(void *arg)
+{
+	bench_arg_t *barg = arg;
+	uint8_t bufs[BENCH_BATCH][BENCH_MSG_LEN_LARGE];
+	uint8_t *ptrs[BENCH_BATCH];
+	uint32_t lens[BENCH_BATCH];
+	volatile uint8_t sink;
+	uint32_t got;
+	uint32_t i;
+
+	for (i = 0; i < BENCH_BATCH; i++) {
+		ptrs[i] = bufs[i];
+	}
+	while (__atomic_load_n(barg->received, __ATOMIC_RELAXED) < BENCH_NUM_MSGS) {
+		got = 0;
+		switch (barg->mode) {
+		case BENCH_MODE_ZEROCOPY:
+			if (osal_queue_peek(barg->queue, &ptrs[0], &lens[0], 10000) == OSAL_E_OK) {
+				sink = ptrs[0][lens[0] - 1];
+				osal_queue_release(barg->queue, ptrs[0]);
+				got = 1;
+			}
+			break;
+		case BENCH_MODE_BATCH:
+			osal_queue_recv_batch(barg->queue, ptrs, lens, BENCH_MSG_LEN_LARGE,
+								  BENCH_BATCH, &got, 10000);
+			for (i = 0; i < got; i++) {
+				sink = ptrs[i][lens[i] - 1];
+			}
+			break;
+		default:
+			if (osal_queue_recv(barg->queue, bufs[0], BENCH_MSG_LEN_LARGE,
+								10000) == OSAL_E_OK) {
+				sink = bufs[0][barg->msglen - 1];
+				got = 1;
+			}
+			break;
+		}
+		__atomic_fetch_add(barg->received, got, __ATOMIC_RELAXED);
+	}
+	(void)sink;
+	return NULL;
+}
+
+static void bench_run(const char *name, osal_queue_type_t type, uint32_t msglen,
+					  bench_mode_t mode, uint32_t n_producers, uint32_t n_consumers)
+{
+	osal_queue_cfg_t cfg = {
+		.name = "osal_queue_bench",
+		.msglen = msglen,
+		.qsize = BENCH_QUEUE_SIZE,
+		.type = type,
+	};
+	pthread_t producers[BENCH_THREADS_MAX];
+	pthread_t consumers[BENCH_THREADS_MAX];
+	bench_arg_t parg;
+	bench_arg_t carg;
+	uint32_t received = 0;
+	uint64_t start;
+	uint64_t end;
+	uint32_t i;
+
+	parg.queue = osal_queue_create(&cfg);
+	if (parg.queue == NULL) {
+		printf("%-6s: failed to create the queue\n", name);
+		return;
+	}
+	parg.msglen = msglen;
+	parg.mode = mode;
+	parg.n_msgs = BENCH_NUM_MSGS / n_producers;
+	parg.received = &received;
+	carg = parg;
+
+	osal_clock_time(&start);
+	for (i = 0; i < n_consumers; i++) {
+		pthread_create(&consumers[i], NULL, bench_consumer, &carg);
+	}
+	for (i = 0; i < n_producers; i++) {
+		pthread_create(&producers[i], NULL, bench_producer, &parg);
+	}
+	for (i = 0; i < n_producers; i++) {
+		pthread_join(producers[i], NULL);
+	}
+	for (i = 0; i < n_consumers; i++) {
+		pthread_join(consumers[i], NULL);
+	}
+	osal_clock_time(&end);
+
+	printf("%-6s %4u%c %u:%u %8.1f ns/msg\n", name, msglen, s_mode_tag[mode],
+		   n_producers, n_consumers,
+		   (double)(end - start) / BENCH_NUM_MSGS);
+	osal_queue_delete(parg.queue);
+}
+
+int main(void)
+{
+	bench_mode_t mode;
+	uint32_t n;
+
+	if (osal_init(NULL) != OSAL_E_OK) {
+		return -1;
+	}
+	bench_run("spsc", OSAL_QUEUE_TYPE_SPSC, BENCH_MSG_LEN, BENCH_MODE_COPY, 1, 1);
+	for (n = 1; n <= BENCH_THREADS_MAX; n <<= 1) {
+		bench_run("posix", OSAL_QUEUE_TYPE_POSIX, BENCH_MSG_LEN, BENCH_MODE_COPY, n, n);
+		bench_run("mpmc", OSAL_QUEUE_TYPE_MPMC, BENCH_MSG_LEN, BENCH_MODE_COPY, n, n);
+	}
+	bench_run("spsc", OSAL_QUEUE_TYPE_SPSC, BENCH_MSG_LEN_LARGE, BENCH_MODE_COPY, 1, 1);
+	bench_run("spsc", OSAL_QUEUE_TYPE_SPSC, BENCH_MSG_LEN_LARGE, BENCH_MODE_ZEROCOPY, 1, 1);
+	bench_run("mpmc", OSAL_QUEUE_TYPE_MPMC, BENCH_MSG_LEN_LARGE, BENCH_MODE_COPY, 4, 4);
+	bench_run("mpmc", OSAL_QUEUE_TYPE_MPMC, BENCH_MSG_LEN_LARGE, BENCH_MODE_ZEROCOPY, 4, 4);
+	for (n = 0; n < 2; n++) {
+		mode = (n == 0) ? BENCH_MODE_COPY : BENCH_MODE_BATCH;
+		bench_run("posix", OSAL_QUEUE_TYPE_POSIX, BENCH_MSG_LEN, mode, 1, 1);
+		bench_run("spsc", OSAL_QUEUE_TYPE_SPSC, BENCH_MSG_LEN, mode, 1, 1);
+		bench_run("mpmc", OSAL_QUEUE_TYPE_MPMC, BENCH_MSG_LEN, mode, 4, 4);
+		bench_run("shm", OSAL_QUEUE_TYPE_SHM, BENCH_MSG_LEN, mode, 1, 1);
+	}
+	osal_deinit();
+	return 0;
+}
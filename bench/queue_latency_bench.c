@@ -0,0 +1,155 @@
+/* BSD 2-Clause License
+*
+* Copyright (c) 2025, nguyenvannam142@gmail.com
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*
+* 1. Redistributions of source code must retain the above copyright notice, this
+*    list of conditions and the following disclaimer.
+*
+* 2. Redistributions in binary form must reproduce the above copyright notice,
+*    this list of conditions and the following disclaimer in the documentation
+*    and/or other materials provided with the distribution.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+/*
+ * Wake up latency of the queue types.
+ *
+ * A pinger sends its send time to a ponger blocked in a receive with a
+ * timeout, which echoes it back on a second queue. Half of each round trip
+ * is taken as the latency of a blocking receive, and the percentiles of
+ * BENCH_ROUNDS rounds are printed for each queue type, with the receivers
+ * sleeping and then spinning before they sleep.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <dmosal/osal.h>
+
+#define BENCH_ROUNDS 20000
+#define BENCH_MSG_LEN 64
+#define BENCH_QUEUE_SIZE 10 /* the default limit of the POSIX queues */
+#define BENCH_RECV_TIMEOUT_USEC OSAL_SEC_USEC
+
+typedef struct {
+	osal_queue_t *ping;
+	osal_queue_t *pong;
+} bench_arg_t;
+
+static uint64_t s_latency[BENCH_ROUNDS];
+
+static void *bench_ponger(void *arg)
+{
+	bench_arg_t *barg = arg;
+	uint8_t buf[BENCH_MSG_LEN];
+	uint32_t len;
+	uint32_t i;
+
+	for (i = 0; i < BENCH_ROUNDS; i++) {
+		if (osal_queue_recv_len(barg->ping, buf, sizeof(buf), &len,
+								BENCH_RECV_TIMEOUT_USEC) != OSAL_E_OK) {
+			break;
+		}
+		osal_queue_send(barg->pong, buf, len);
+	}
+	return NULL;
+}
+
+static int bench_cmp(const void *a, const void *b)
+{
+	uint64_t x = *(const uint64_t *)a;
+	uint64_t y = *(const uint64_t *)b;
+
+	return (x > y) - (x < y);
+}
+
+static osal_queue_t *bench_queue(const char *name, osal_queue_type_t type)
+{
+	osal_queue_cfg_t cfg = {
+		.msglen = BENCH_MSG_LEN,
+		.qsize = BENCH_QUEUE_SIZE,
+		.type = type,
+	};
+
+	snprintf((char *)cfg.name, sizeof(cfg.name), "%s", name);
+	return osal_queue_create(&cfg);
+}
+
+static void bench_run(const char *name, osal_queue_type_t type,
+					  osal_queue_recv_mode_t mode)
+{
+	uint8_t buf[BENCH_MSG_LEN];
+	bench_arg_t barg;
+	pthread_t ponger;
+	uint64_t start;
+	uint64_t end;
+	uint32_t len;
+	uint32_t i;
+
+	barg.ping = bench_queue("osal_latency_ping", type);
+	barg.pong = bench_queue("osal_latency_pong", type);
+	if ((barg.ping == NULL) || (barg.pong == NULL)) {
+		printf("%-11s: failed to create the queues\n", name);
+		osal_queue_delete(barg.ping);
+		osal_queue_delete(barg.pong);
+		return;
+	}
+	osal_queue_recv_mode(barg.ping, mode, 0);
+	osal_queue_recv_mode(barg.pong, mode, 0);
+
+	pthread_create(&ponger, NULL, bench_ponger, &barg);
+	for (i = 0; i < BENCH_ROUNDS; i++) {
+		osal_clock_time(&start);
+		memcpy(buf, &start, sizeof(start));
+		osal_queue_send(barg.ping, buf, sizeof(start));
+		if (osal_queue_recv_len(barg.pong, buf, sizeof(buf), &len,
+								BENCH_RECV_TIMEOUT_USEC) != OSAL_E_OK) {
+			break;
+		}
+		osal_clock_time(&end);
+		memcpy(&start, buf, sizeof(start));
+		s_latency[i] = (end - start) / 2;
+	}
+	pthread_join(ponger, NULL);
+
+	qsort(s_latency, i, sizeof(s_latency[0]), bench_cmp);
+	if (i != 0) {
+		printf("%-11s p50 %7lu ns p99 %7lu ns max %7lu ns\n", name,
+			   (unsigned long)s_latency[i / 2],
+			   (unsigned long)s_latency[i * 99 / 100],
+			   (unsigned long)s_latency[i - 1]);
+	}
+	osal_queue_delete(barg.ping);
+	osal_queue_delete(barg.pong);
+}
+
+int main(void)
+{
+	if (osal_init(NULL) != OSAL_E_OK) {
+		return -1;
+	}
+	bench_run("posix", OSAL_QUEUE_TYPE_POSIX, OSAL_QUEUE_RECV_BLOCK);
+	bench_run("spsc", OSAL_QUEUE_TYPE_SPSC, OSAL_QUEUE_RECV_BLOCK);
+	bench_run("mpmc", OSAL_QUEUE_TYPE_MPMC, OSAL_QUEUE_RECV_BLOCK);
+	bench_run("shm", OSAL_QUEUE_TYPE_SHM, OSAL_QUEUE_RECV_BLOCK);
+	bench_run("posix-spin", OSAL_QUEUE_TYPE_POSIX, OSAL_QUEUE_RECV_SPIN);
+	bench_run("spsc-spin", OSAL_QUEUE_TYPE_SPSC, OSAL_QUEUE_RECV_SPIN);
+	bench_run("mpmc-spin", OSAL_QUEUE_TYPE_MPMC, OSAL_QUEUE_RECV_SPIN);
+	bench_run("shm-spin", OSAL_QUEUE_TYPE_SHM, OSAL_QUEUE_RECV_SPIN);
+	osal_deinit();
+	return 0;
+}
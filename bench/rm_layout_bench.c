@@ -0,0 +1,132 @@
+/* BSD 2-Clause License
+*
+* Copyright (c) 2025, nguyenvannam142@gmail.com
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*
+* 1. Redistributions of source code must retain the above copyright notice, this
+*    list of conditions and the following disclaimer.
+*
+* 2. Redistributions in binary form must reproduce the above copyright notice,
+*    this list of conditions and the following disclaimer in the documentation
+*    and/or other materials provided with the distribution.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+/*
+ * Compare the packed and the cache-line layout of a resource manager pool.
+ *
+ * Each thread takes one object from the pool, then locks, updates and
+ * unlocks the pthread mutex embedded in it. The objects of the threads are
+ * neighbours in the pool, so with the packed layout they share cache lines.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <pthread.h>
+#include <dmosal/osal.h>
+
+#define BENCH_NUM_THREADS 4
+#define BENCH_NUM_LOOPS 2000000
+
+typedef struct {
+	pthread_mutex_t mutex;
+	uint64_t count;
+} bench_obj_t;
+
+static struct {
+	OSAL_RM_USEROBJMAN_DECLARE_PACKED(bench_obj_t, BENCH_NUM_THREADS)
+} s_packed;
+
+static struct {
+	OSAL_RM_USEROBJMAN_DECLARE_CACHELINE(bench_obj_t, BENCH_NUM_THREADS)
+} s_cacheline;
+
+static void *bench_thread(void *arg)
+{
+	bench_obj_t *obj = arg;
+	uint32_t i;
+
+	for (i = 0; i < BENCH_NUM_LOOPS; i++) {
+		pthread_mutex_lock(&obj->mutex);
+		obj->count++;
+		pthread_mutex_unlock(&obj->mutex);
+	}
+	return NULL;
+}
+
+static uint64_t bench_run(osal_rm_t *rm, uint32_t n_threads)
+{
+	pthread_t threads[BENCH_NUM_THREADS];
+	osal_resrc_t *resrces[BENCH_NUM_THREADS];
+	bench_obj_t *obj;
+	uint64_t start;
+	uint64_t end;
+	uint32_t i;
+
+	for (i = 0; i < n_threads; i++) {
+		resrces[i] = osal_rm_alloc(rm);
+		OSAL_RUNTIME_ASSERT(resrces[i] != NULL);
+		obj = resrces[i]->data;
+		pthread_mutex_init(&obj->mutex, NULL);
+		obj->count = 0;
+	}
+	osal_clock_time(&start);
+	for (i = 0; i < n_threads; i++) {
+		pthread_create(&threads[i], NULL, bench_thread, resrces[i]->data);
+	}
+	for (i = 0; i < n_threads; i++) {
+		pthread_join(threads[i], NULL);
+	}
+	osal_clock_time(&end);
+	for (i = 0; i < n_threads; i++) {
+		obj = resrces[i]->data;
+		OSAL_RUNTIME_ASSERT(obj->count == BENCH_NUM_LOOPS);
+		pthread_mutex_destroy(&obj->mutex);
+		osal_rm_free(rm, resrces[i]);
+	}
+	return end - start;
+}
+
+int main(int argc, char **argv)
+{
+	uint32_t n_threads = BENCH_NUM_THREADS;
+	uint64_t packed;
+	uint64_t cacheline;
+	uint64_t n_ops;
+
+	if (argc > 1) {
+		n_threads = atoi(argv[1]);
+		if ((n_threads == 0) || (n_threads > BENCH_NUM_THREADS)) {
+			printf("usage: %s [threads <= %d]\n", argv[0], BENCH_NUM_THREADS);
+			return -1;
+		}
+	}
+
+	OSAL_RM_USEROBJMAN_INIT_LAYOUT(&s_packed, BENCH_NUM_THREADS, NULL, PACKED);
+	OSAL_RM_USEROBJMAN_INIT_LAYOUT(&s_cacheline, BENCH_NUM_THREADS, NULL, CACHELINE);
+
+	packed = bench_run(&s_packed.rm, n_threads);
+	cacheline = bench_run(&s_cacheline.rm, n_threads);
+
+	n_ops = (uint64_t)n_threads * BENCH_NUM_LOOPS;
+	printf("threads: %u, object size: %zu\n", n_threads, sizeof(bench_obj_t));
+	printf("packed:    %8.2f ns/op\n", (double)packed / n_ops);
+	printf("cacheline: %8.2f ns/op\n", (double)cacheline / n_ops);
+
+	osal_rm_deinit(&s_packed.rm);
+	osal_rm_deinit(&s_cacheline.rm);
+	return 0;
+}
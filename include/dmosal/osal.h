@@ -48,14 +48,21 @@ extern "C" {
 #include "osal_time.h"
 #include "osal_sem.h"
 #include "osal_queue.h"
+#include "osal_channel.h"
+#include "osal_msgbuf.h"
+#include "osal_mempool.h"
+#include "osal_mem.h"
 #include "osal_rm.h"
+#include "osal_handle.h"
 #include "osal_tmcheck.h"
 #include "osal_lifo.h"
+#include "osal_fifo.h"
 #include "osal_version.h"
 
 typedef struct {
 	osal_log_output_t log_output; /**< Pointer to the logging output function. Set NULL to use the default output */
 	osal_log_level_t osal_level; /**< Log level of the OSAL layer */
+	osal_mem_cfg_t mem; /**< Memory region of the memory pool and the queue rings */
 } osal_config_t;
 
 /**
@@ -0,0 +1,189 @@
+/* BSD 2-Clause License
+*
+* Copyright (c) 2025, nguyenvannam142@gmail.com
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*
+* 1. Redistributions of source code must retain the above copyright notice, this
+*    list of conditions and the following disclaimer.
+*
+* 2. Redistributions in binary form must reproduce the above copyright notice,
+*    this list of conditions and the following disclaimer in the documentation
+*    and/or other materials provided with the distribution.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+/**
+ * @addtogroup dmosal
+ * @{
+ * @file osal_channel.h
+ * @brief OS Abstraction Layer Broadcast Channel Definitions
+ * @copyright Copyright (c) 2025, nguyenvannam142@gmail.com
+ * @author Nam Nguyen Van(nguyenvannam142@gmail.com)
+ */
+#ifndef OSAL_CHANNEL_H
+#define OSAL_CHANNEL_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include "osal_error.h"
+#include "osal_config.h"
+#include "osal_mutex.h"
+
+/**
+ * @brief Forward declaration of the OS abstraction layer channel structure.
+ */
+typedef struct osal_channel osal_channel_t;
+
+/**
+ * @brief Forward declaration of a subscription to a channel.
+ */
+typedef struct osal_channel_sub osal_channel_sub_t;
+
+/**
+ * @brief What the publisher does when the slowest subscriber is a ring behind.
+ */
+typedef enum {
+	OSAL_CHANNEL_DROP_OLDEST = 0, /**< Overwrite the oldest message, the late subscriber skips it. */
+	OSAL_CHANNEL_BLOCK, /**< Wait for the slowest subscriber, or fail with OSAL_E_QFULL. */
+	OSAL_CHANNEL_POLICY_MAX, /**< Number of policies. */
+} osal_channel_policy_t;
+
+/**
+ * @brief Structure defining the configuration of a channel.
+ */
+typedef struct {
+	uint32_t msglen; /**< max len of a message */
+	uint32_t qsize; /**< number of messages kept in the ring */
+	osal_channel_policy_t policy; /**< policy for the slow subscribers */
+} osal_channel_cfg_t;
+
+/**
+ * @brief Initializes the OS abstraction layer channel subsystem.
+ *
+ * @param mutex Mutex to protect the internal resource.
+ * @return An error code indicating the status of the initialization.
+ */
+osal_error_t osal_channel_init(osal_mutex_t *mutex);
+
+/**
+ * @brief Deinitializes the OS abstraction layer channel subsystem.
+ */
+void osal_channel_deinit(void);
+
+/**
+ * @brief Creates a one-to-many channel.
+ *
+ * A message is copied once into the ring of the channel and every
+ * subscriber reads it through its own cursor. The channel has a single
+ * publisher, several publishing threads have to serialize their calls.
+ *
+ * @param cfg Pointer to the channel configuration.
+ * @return Pointer to the created channel, NULL on error.
+ */
+osal_channel_t *osal_channel_create(osal_channel_cfg_t *cfg);
+
+/**
+ * @brief Deletes a channel, its subscriptions end with it.
+ *
+ * The ring comes from osal_mem_alloc() and goes back to the memory region
+ * for the next channel of the same size.
+ *
+ * @param channel Pointer to the channel.
+ */
+void osal_channel_delete(osal_channel_t *channel);
+
+/**
+ * @brief Publishes a message to all the subscribers.
+ *
+ * @param channel Pointer to the channel.
+ * @param msg Pointer to the message data.
+ * @param msglen Length of the message.
+ * @param timeout_usec Timeout to wait for the slowest subscriber of an
+ *                     OSAL_CHANNEL_BLOCK channel, unused otherwise.
+ * @return An error code indicating the status of the publish,
+ *         OSAL_E_QFULL or OSAL_E_TIMEOUT when a subscriber stays behind.
+ */
+osal_error_t osal_channel_publish(osal_channel_t *channel, uint8_t *msg,
+								  uint32_t msglen, uint32_t timeout_usec);
+
+/**
+ * @brief Subscribes to a channel.
+ *
+ * The subscriber gets the messages published from now on.
+ *
+ * @param channel Pointer to the channel.
+ * @return Pointer to the subscription, NULL if the channel has
+ *         OSAL_CHANNEL_SUB_MAX subscribers already.
+ */
+osal_channel_sub_t *osal_channel_subscribe(osal_channel_t *channel);
+
+/**
+ * @brief Ends a subscription.
+ *
+ * @param sub Pointer to the subscription.
+ */
+void osal_channel_unsubscribe(osal_channel_sub_t *sub);
+
+/**
+ * @brief Receives the next message of a subscription.
+ *
+ * A subscription is read by a single thread.
+ *
+ * @param sub Pointer to the subscription.
+ * @param buf Pointer to the received buffer.
+ * @param bufsize Size of the buffer.
+ * @param msglen Pointer to the length of the received message.
+ * @param timeout_usec Timeout to wait when having no message.
+ * @return An error code indicating the status of the receive,
+ *         OSAL_E_PARAM if the message is longer than the buffer.
+ */
+osal_error_t osal_channel_recv(osal_channel_sub_t *sub, uint8_t *buf, uint32_t bufsize,
+							   uint32_t *msglen, uint32_t timeout_usec);
+
+/**
+ * @brief Retrieves the number of messages a subscription missed.
+ *
+ * They were overwritten before it read them on an OSAL_CHANNEL_DROP_OLDEST
+ * channel.
+ *
+ * @param sub Pointer to the subscription.
+ * @return The number of dropped messages.
+ */
+uint64_t osal_channel_dropped(osal_channel_sub_t *sub);
+
+/**
+ * @brief Retrieves the count of used channels.
+ *
+ * @return The count of currently used channels.
+ */
+uint32_t osal_channel_use(void);
+
+/**
+ * @brief Retrieves the count of available channels.
+ *
+ * @return The count of currently available (unused) channels.
+ */
+uint32_t osal_channel_avail(void);
+
+#ifdef __cplusplus	/* extern "C" */
+}
+#endif
+
+#endif //OSAL_CHANNEL_H
+
+/** @}*/
@@ -55,6 +55,7 @@ typedef enum {
 	OSAL_E_QFULL, /**< Queue is full */
 	OSAL_E_QEMPTY, /**< Queue is empty*/
 	OSAL_E_INUSE, /**< Resource is in use */
+	OSAL_E_NOSUPPORT, /**< Operation is not supported */
 	OSAL_E_MAX, /**< Maximum error code (for range checking) */
 } osal_error_t;
 
@@ -0,0 +1,131 @@
+/* BSD 2-Clause License
+*
+* Copyright (c) 2025, nguyenvannam142@gmail.com
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*
+* 1. Redistributions of source code must retain the above copyright notice, this
+*    list of conditions and the following disclaimer.
+*
+* 2. Redistributions in binary form must reproduce the above copyright notice,
+*    this list of conditions and the following disclaimer in the documentation
+*    and/or other materials provided with the distribution.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+/**
+ * @addtogroup dmosal
+ * @{
+ * @file osal_fifo.h
+ * @brief OS Abstraction Layer First-In-First-Out (FIFO) Definitions
+ * @copyright Copyright (c) 2025, nguyenvannam142@gmail.com
+ * @author Nam Nguyen Van(nguyenvannam142@gmail.com)
+ */
+#ifndef OSAL_FIFO_H
+#define OSAL_FIFO_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+/**
+ * @brief Structure defining a node for a First-In-First-Out (FIFO) data structure.
+ */
+typedef struct osal_fifo_node {
+	struct osal_fifo_node *next; /**< Pointer to the next node in the FIFO. */
+} osal_fifo_node_t;
+
+/**
+ * @brief Structure defining a multi-producer single-consumer FIFO.
+ *
+ * The FIFO is an intrusive Vyukov queue: the producers swap themselves in
+ * as the new head with one atomic exchange, the consumer follows the next
+ * pointers from the tail. A stub node keeps the list non-empty, so the FIFO
+ * must not be moved once initialized.
+ */
+typedef struct {
+	osal_fifo_node_t *head; /**< Last pushed node, shared by the producers. */
+	osal_fifo_node_t *tail; /**< Next node to pop, owned by the consumer. */
+	osal_fifo_node_t stub; /**< Node standing in for an empty FIFO. */
+	uint32_t size; /**< Current size of the FIFO. */
+} osal_fifo_t;
+
+/**
+ * @brief Initializes a First-In-First-Out (FIFO) data structure.
+ *
+ * @param fifo Pointer to the FIFO structure to be initialized.
+ */
+void osal_fifo_init(osal_fifo_t *fifo);
+
+/**
+ * @brief Pushes a node to the First-In-First-Out (FIFO) data structure.
+ *
+ * It is wait-free and can be called by any number of threads.
+ *
+ * @param fifo Pointer to the FIFO structure where the node will be pushed.
+ * @param node Pointer to the node to be pushed to the FIFO.
+ */
+void osal_fifo_push(osal_fifo_t *fifo, osal_fifo_node_t *node);
+
+/**
+ * @brief Pops the oldest node from the First-In-First-Out (FIFO) data structure.
+ *
+ * It must be called by a single thread at a time. A push that is not
+ * complete yet hides the nodes pushed after it, NULL is returned then even
+ * if the size is not 0.
+ *
+ * @param fifo Pointer to the FIFO structure from where the node will be popped.
+ * @return Pointer to the popped node, or NULL if the FIFO is empty.
+ */
+osal_fifo_node_t *osal_fifo_pop(osal_fifo_t *fifo);
+
+/**
+ * @brief Pops up to n nodes from the First-In-First-Out (FIFO) data structure.
+ *
+ * It must be called by the consumer thread, as osal_fifo_pop().
+ *
+ * @param fifo Pointer to the FIFO structure from where the nodes will be popped.
+ * @param nodes Array receiving the popped nodes in the FIFO order.
+ * @param n Maximum number of nodes to pop.
+ * @return Number of popped nodes.
+ */
+uint32_t osal_fifo_drain(osal_fifo_t *fifo, osal_fifo_node_t *nodes[], uint32_t n);
+
+/**
+ * @brief Gets the current size of the First-In-First-Out (FIFO) data structure.
+ *
+ * @param fifo Pointer to the FIFO structure for which the size will be retrieved.
+ * @return Current size of the FIFO.
+ */
+uint32_t osal_fifo_size(osal_fifo_t *fifo);
+
+/**
+ * @brief Checks if the First-In-First-Out (FIFO) data structure is empty.
+ *
+ * @param fifo Pointer to the FIFO structure to be checked.
+ * @return true if the FIFO is empty, false otherwise.
+ */
+bool osal_fifo_is_empty(osal_fifo_t *fifo);
+
+#ifdef __cplusplus	/* extern "C" */
+}
+#endif
+
+#endif //OSAL_FIFO_H
+
+/** @}*/
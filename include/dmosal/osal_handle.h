@@ -0,0 +1,75 @@
+/* BSD 2-Clause License
+*
+* Copyright (c) 2025, nguyenvannam142@gmail.com
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*
+* 1. Redistributions of source code must retain the above copyright notice, this
+*    list of conditions and the following disclaimer.
+*
+* 2. Redistributions in binary form must reproduce the above copyright notice,
+*    this list of conditions and the following disclaimer in the documentation
+*    and/or other materials provided with the distribution.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+/**
+ * @addtogroup dmosal
+ * @{
+ * @file osal_handle.h
+ * @brief OS Abstraction Layer Resource Handle Definitions
+ * @copyright Copyright (c) 2025, nguyenvannam142@gmail.com
+ * @author Nam Nguyen Van(nguyenvannam142@gmail.com)
+ */
+#ifndef OSAL_HANDLE_H
+#define OSAL_HANDLE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+
+/**
+ * @brief Integer handle of a resource.
+ *
+ * The handle packs the index of the resource in its pool (low 16 bits) and
+ * a generation (high 16 bits) changed every time the resource is freed, so a
+ * handle kept after the free no longer resolves.
+ */
+typedef uint32_t osal_handle_t;
+
+/**
+ * @brief Value of a handle not referring to any resource.
+ */
+#define OSAL_HANDLE_INVALID 0
+
+/**
+ * @brief Number of bits of the resource index in a handle.
+ */
+#define OSAL_HANDLE_INDEX_BITS 16
+
+/**
+ * @brief Highest resource index a handle carries, the resources of a pool
+ * past it have no handle.
+ */
+#define OSAL_HANDLE_INDEX_MAX ((1U << OSAL_HANDLE_INDEX_BITS) - 1)
+
+#ifdef __cplusplus	/* extern "C" */
+}
+#endif
+
+#endif //OSAL_HANDLE_H
+
+/** @}*/
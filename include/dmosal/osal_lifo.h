@@ -59,6 +59,21 @@ typedef struct {
 	uint32_t size; /**< Current size of the LIFO. */
 } osal_lifo_t;
 
+/**
+ * @brief Structure defining a lock-free Last-In-First-Out (LIFO) data structure.
+ *
+ * The lock-free LIFO is a Treiber stack over a static array of nodes. The head
+ * packs the array index of the top node together with a generation tag in one
+ * 64-bit word, so a single compare-and-swap detects a node that was popped and
+ * pushed back in between (the ABA case).
+ */
+typedef struct {
+	uint64_t head; /**< Top node index+1 (low 32 bits) and ABA tag (high 32 bits). */
+	uint32_t size; /**< Current size of the LIFO. */
+	uint8_t *base; /**< Address of the node of the first array element. */
+	uint32_t stride; /**< Distance in bytes between two consecutive nodes. */
+} osal_lifo_atomic_t;
+
 /**
  * @brief Initializes a Last-In-First-Out (LIFO) data structure.
  *
@@ -82,6 +97,31 @@ void osal_lifo_push(osal_lifo_t *lifo, osal_lifo_node_t *node);
  */
 osal_lifo_node_t *osal_lifo_pop(osal_lifo_t *lifo);
 
+/**
+ * @brief Pushes a chain of nodes onto the Last-In-First-Out (LIFO) data structure.
+ *
+ * The nodes are linked from @p first to @p last through their next pointer,
+ * @p first becomes the new head of the LIFO.
+ *
+ * @param lifo Pointer to the LIFO structure where the nodes will be pushed.
+ * @param first Pointer to the first node of the chain.
+ * @param last Pointer to the last node of the chain.
+ * @param n Number of nodes in the chain.
+ */
+void osal_lifo_push_chain(osal_lifo_t *lifo, osal_lifo_node_t *first,
+						  osal_lifo_node_t *last, uint32_t n);
+
+/**
+ * @brief Pops up to n nodes from the Last-In-First-Out (LIFO) data structure.
+ *
+ * @param lifo Pointer to the LIFO structure from where the nodes will be popped.
+ * @param n Maximum number of nodes to pop.
+ * @param popped Pointer to store the number of popped nodes.
+ * @return Pointer to the first popped node, the chain is terminated by NULL.
+ * NULL if the LIFO is empty.
+ */
+osal_lifo_node_t *osal_lifo_pop_n(osal_lifo_t *lifo, uint32_t n, uint32_t *popped);
+
 /**
  * @brief Gets the current size of the Last-In-First-Out (LIFO) data structure.
  *
@@ -98,6 +138,66 @@ uint32_t osal_lifo_size(osal_lifo_t *lifo);
  */
 bool osal_lifo_is_empty(osal_lifo_t *lifo);
 
+/**
+ * @brief Initializes a lock-free Last-In-First-Out (LIFO) data structure.
+ *
+ * All nodes pushed onto this LIFO must belong to the same array, described by
+ * the node of its first element and the size of one element.
+ *
+ * @param lifo Pointer to the LIFO structure to be initialized.
+ * @param base Pointer to the node of the first array element.
+ * @param stride Distance in bytes between two consecutive nodes.
+ */
+void osal_lifo_atomic_init(osal_lifo_atomic_t *lifo, osal_lifo_node_t *base,
+						   uint32_t stride);
+
+/**
+ * @brief Pushes a node onto the lock-free LIFO, safe to call from any thread.
+ *
+ * @param lifo Pointer to the LIFO structure where the node will be pushed.
+ * @param node Pointer to the node to be pushed onto the LIFO.
+ */
+void osal_lifo_atomic_push(osal_lifo_atomic_t *lifo, osal_lifo_node_t *node);
+
+/**
+ * @brief Pops a node from the lock-free LIFO, safe to call from any thread.
+ *
+ * @param lifo Pointer to the LIFO structure from where the node will be popped.
+ * @return Pointer to the popped node, or NULL if the LIFO is empty.
+ */
+osal_lifo_node_t *osal_lifo_atomic_pop(osal_lifo_atomic_t *lifo);
+
+/**
+ * @brief Pushes a chain of nodes onto the lock-free LIFO in one step.
+ *
+ * @param lifo Pointer to the LIFO structure where the nodes will be pushed.
+ * @param first Pointer to the first node of the chain.
+ * @param last Pointer to the last node of the chain.
+ * @param n Number of nodes in the chain.
+ */
+void osal_lifo_atomic_push_chain(osal_lifo_atomic_t *lifo, osal_lifo_node_t *first,
+								 osal_lifo_node_t *last, uint32_t n);
+
+/**
+ * @brief Pops up to n nodes from the lock-free LIFO in one step.
+ *
+ * @param lifo Pointer to the LIFO structure from where the nodes will be popped.
+ * @param n Maximum number of nodes to pop.
+ * @param popped Pointer to store the number of popped nodes.
+ * @return Pointer to the first popped node, the chain is terminated by NULL.
+ * NULL if the LIFO is empty.
+ */
+osal_lifo_node_t *osal_lifo_atomic_pop_n(osal_lifo_atomic_t *lifo, uint32_t n,
+										 uint32_t *popped);
+
+/**
+ * @brief Gets the current size of the lock-free LIFO.
+ *
+ * @param lifo Pointer to the LIFO structure for which the size will be retrieved.
+ * @return Current size of the LIFO.
+ */
+uint32_t osal_lifo_atomic_size(osal_lifo_atomic_t *lifo);
+
 /**
  * @brief Macro for iterating through a Last-In-First-Out (LIFO) data structure.
  *
@@ -0,0 +1,130 @@
+/* BSD 2-Clause License
+*
+* Copyright (c) 2025, nguyenvannam142@gmail.com
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*
+* 1. Redistributions of source code must retain the above copyright notice, this
+*    list of conditions and the following disclaimer.
+*
+* 2. Redistributions in binary form must reproduce the above copyright notice,
+*    this list of conditions and the following disclaimer in the documentation
+*    and/or other materials provided with the distribution.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+/**
+ * @addtogroup dmosal
+ * @{
+ * @file osal_mem.h
+ * @brief OS Abstraction Layer Memory Region Definitions
+ * @copyright Copyright (c) 2025, nguyenvannam142@gmail.com
+ * @author Nam Nguyen Van(nguyenvannam142@gmail.com)
+ */
+#ifndef OSAL_MEM_H
+#define OSAL_MEM_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stddef.h>
+#include "osal_error.h"
+
+/**
+ * @brief Alignment of the memory returned by osal_mem_alloc().
+ */
+#define OSAL_MEM_ALIGN 64
+
+/**
+ * @brief Configuration of the OSAL memory region.
+ *
+ * The region is mapped once at init, backed by huge pages when available,
+ * and all of its pages are faulted in before osal_mem_init() returns.
+ */
+typedef struct {
+	size_t size; /**< Size in bytes of the region, 0 to allocate from the heap */
+	bool hugepage; /**< Try to back the region with huge pages */
+	bool lock; /**< Lock the region in RAM */
+	bool lock_all; /**< Lock all the current and future pages of the process in RAM */
+} osal_mem_cfg_t;
+
+/**
+ * @brief State of the OSAL memory region.
+ */
+typedef struct {
+	size_t size; /**< Size in bytes of the region. */
+	size_t used; /**< Bytes carved from the region, headers and freed blocks included. */
+	size_t free; /**< Bytes of the freed blocks kept for the next allocations. */
+	size_t heap_allocs; /**< Allocations served by the heap as the region was exhausted. */
+	bool hugepage; /**< The region is backed by huge pages. */
+	bool locked; /**< The region is locked in RAM. */
+} osal_mem_info_t;
+
+/**
+ * @brief Initializes the OSAL memory region.
+ *
+ * Locking is done on a best effort basis, a failure is reported in
+ * osal_mem_info() only.
+ *
+ * @param cfg Pointer to the configuration, NULL to allocate from the heap.
+ * @return An error code indicating the status of the initialization.
+ */
+osal_error_t osal_mem_init(osal_mem_cfg_t *cfg);
+
+/**
+ * @brief Unmaps the OSAL memory region.
+ *
+ * The memory allocated from the region must not be used anymore.
+ */
+void osal_mem_deinit(void);
+
+/**
+ * @brief Allocates memory from the OSAL memory region.
+ *
+ * The memory comes from the heap when there is no region or the region is
+ * exhausted, see osal_mem_info_t.heap_allocs. A block of the region takes
+ * OSAL_MEM_ALIGN more bytes for its header, and is handed out again after
+ * osal_mem_free() to an allocation of about the same size.
+ *
+ * @param size Size in bytes of the memory.
+ * @return Pointer to memory aligned to OSAL_MEM_ALIGN, or NULL on failure.
+ */
+void *osal_mem_alloc(size_t size);
+
+/**
+ * @brief Frees memory returned by osal_mem_alloc().
+ *
+ * A block of the region is kept for reuse and only unmapped by
+ * osal_mem_deinit().
+ *
+ * @param ptr Pointer to the memory.
+ */
+void osal_mem_free(void *ptr);
+
+/**
+ * @brief Retrieves the state of the OSAL memory region.
+ *
+ * @param info Pointer to the state to be filled.
+ */
+void osal_mem_info(osal_mem_info_t *info);
+
+#ifdef __cplusplus	/* extern "C" */
+}
+#endif
+
+#endif //OSAL_MEM_H
+
+/** @}*/
@@ -0,0 +1,122 @@
+/* BSD 2-Clause License
+*
+* Copyright (c) 2025, nguyenvannam142@gmail.com
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*
+* 1. Redistributions of source code must retain the above copyright notice, this
+*    list of conditions and the following disclaimer.
+*
+* 2. Redistributions in binary form must reproduce the above copyright notice,
+*    this list of conditions and the following disclaimer in the documentation
+*    and/or other materials provided with the distribution.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+/**
+ * @addtogroup dmosal
+ * @{
+ * @file osal_mempool.h
+ * @brief OS Abstraction Layer Memory Pool Definitions
+ * @copyright Copyright (c) 2025, nguyenvannam142@gmail.com
+ * @author Nam Nguyen Van(nguyenvannam142@gmail.com)
+ */
+#ifndef OSAL_MEMPOOL_H
+#define OSAL_MEMPOOL_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include "osal_error.h"
+#include "osal_config.h"
+#include "osal_mutex.h"
+
+/**
+ * @brief Number of the memory pool classes.
+ *
+ * The block size and the number of blocks of each class are given by
+ * OSAL_MEMPOOL_SIZE_x and OSAL_MEMPOOL_NUM_x. The blocks are taken from the
+ * OSAL memory region at init, see osal_mem_alloc().
+ */
+#define OSAL_MEMPOOL_CLASS_NUM 4
+
+/**
+ * @brief Alignment of the memory pool blocks.
+ */
+#define OSAL_MEMPOOL_ALIGN 16
+
+/**
+ * @brief Initializes the OS abstraction layer memory pool subsystem.
+ *
+ * @param mutex Mutex to protect the internal resource.
+ * @return An error code indicating the status of the initialization.
+ */
+osal_error_t osal_mempool_init(osal_mutex_t *mutex);
+
+/**
+ * @brief Deinitializes the OS abstraction layer memory pool subsystem.
+ */
+void osal_mempool_deinit(void);
+
+/**
+ * @brief Allocates a block from the memory pool.
+ *
+ * The block is taken from the smallest class fitting the size, or from a
+ * larger class when that one is exhausted.
+ *
+ * @param size Size in bytes of the block.
+ * @return Pointer to the block, or NULL if no class can provide it.
+ */
+void *osal_mempool_alloc(uint32_t size);
+
+/**
+ * @brief Returns a block to the memory pool.
+ *
+ * @param ptr Pointer to the block returned by osal_mempool_alloc().
+ */
+void osal_mempool_free(void *ptr);
+
+/**
+ * @brief Retrieves the block size of a memory pool class.
+ *
+ * @param class_idx Index of the class, lower than OSAL_MEMPOOL_CLASS_NUM.
+ * @return The block size in bytes, or 0 for an invalid class.
+ */
+uint32_t osal_mempool_class_size(uint32_t class_idx);
+
+/**
+ * @brief Retrieves the count of used blocks of a memory pool class.
+ *
+ * @param class_idx Index of the class, lower than OSAL_MEMPOOL_CLASS_NUM.
+ * @return The count of currently used blocks.
+ */
+uint32_t osal_mempool_use(uint32_t class_idx);
+
+/**
+ * @brief Retrieves the count of available blocks of a memory pool class.
+ *
+ * @param class_idx Index of the class, lower than OSAL_MEMPOOL_CLASS_NUM.
+ * @return The count of currently available (unused) blocks.
+ */
+uint32_t osal_mempool_avail(uint32_t class_idx);
+
+#ifdef __cplusplus	/* extern "C" */
+}
+#endif
+
+#endif //OSAL_MEMPOOL_H
+
+/** @}*/
@@ -0,0 +1,197 @@
+/* BSD 2-Clause License
+*
+* Copyright (c) 2025, nguyenvannam142@gmail.com
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*
+* 1. Redistributions of source code must retain the above copyright notice, this
+*    list of conditions and the following disclaimer.
+*
+* 2. Redistributions in binary form must reproduce the above copyright notice,
+*    this list of conditions and the following disclaimer in the documentation
+*    and/or other materials provided with the distribution.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+/**
+ * @addtogroup dmosal
+ * @{
+ * @file osal_msgbuf.h
+ * @brief OS Abstraction Layer Message Buffer Definitions
+ * @copyright Copyright (c) 2025, nguyenvannam142@gmail.com
+ * @author Nam Nguyen Van(nguyenvannam142@gmail.com)
+ */
+#ifndef OSAL_MSGBUF_H
+#define OSAL_MSGBUF_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include "osal_error.h"
+#include "osal_config.h"
+#include "osal_mutex.h"
+
+/**
+ * @brief Forward declaration of the OS abstraction layer message buffer structure.
+ */
+typedef struct osal_msgbuf osal_msgbuf_t;
+
+/**
+ * @brief Structure defining the configuration of a message buffer.
+ */
+typedef struct {
+	uint32_t size; /**< bytes of the ring, rounded up to a power of two */
+	uint32_t msglen; /**< max len of a message, its record fits in half the ring */
+} osal_msgbuf_cfg_t;
+
+/**
+ * @brief Initializes the OS abstraction layer message buffer subsystem.
+ *
+ * @param mutex Mutex to protect the internal resource.
+ * @return An error code indicating the status of the initialization.
+ */
+osal_error_t osal_msgbuf_init(osal_mutex_t *mutex);
+
+/**
+ * @brief Deinitializes the OS abstraction layer message buffer subsystem.
+ */
+void osal_msgbuf_deinit(void);
+
+/**
+ * @brief Creates a message buffer.
+ *
+ * A message buffer is a byte ring of variable length messages between one
+ * sending and one receiving thread. Each message takes its length rounded
+ * up to 8 bytes plus an 8 byte header, instead of a whole slot of the
+ * longest message as in a queue.
+ *
+ * @param cfg Pointer to the message buffer configuration.
+ * @return Pointer to the created message buffer, NULL on error.
+ */
+osal_msgbuf_t *osal_msgbuf_create(osal_msgbuf_cfg_t *cfg);
+
+/**
+ * @brief Deletes a message buffer.
+ *
+ * The buffer comes from osal_mem_alloc() and goes back to the memory
+ * region for the next message buffer of the same size.
+ *
+ * @param msgbuf Pointer to the message buffer.
+ */
+void osal_msgbuf_delete(osal_msgbuf_t *msgbuf);
+
+/**
+ * @brief Sends a message into the message buffer.
+ *
+ * @param msgbuf Pointer to the message buffer.
+ * @param msg Pointer to the message data.
+ * @param msglen Length of the message.
+ * @param timeout_usec Timeout to wait for room, 0 to fail at once.
+ * @return An error code indicating the status of the send,
+ *         OSAL_E_QFULL or OSAL_E_TIMEOUT when there is no room.
+ */
+osal_error_t osal_msgbuf_send(osal_msgbuf_t *msgbuf, uint8_t *msg, uint32_t msglen,
+							  uint32_t timeout_usec);
+
+/**
+ * @brief Reserves room for a message to be written in place.
+ *
+ * The message is visible to the receiver after osal_msgbuf_commit().
+ *
+ * @param msgbuf Pointer to the message buffer.
+ * @param msglen Maximum length of the message to write.
+ * @param ptr Pointer to the reserved room.
+ * @return An error code indicating the status of the operation,
+ *         OSAL_E_QFULL when there is no room.
+ */
+osal_error_t osal_msgbuf_reserve(osal_msgbuf_t *msgbuf, uint32_t msglen, uint8_t **ptr);
+
+/**
+ * @brief Commits a message written in place.
+ *
+ * @param msgbuf Pointer to the message buffer.
+ * @param ptr Pointer given by osal_msgbuf_reserve().
+ * @param msglen Length of the message, up to the reserved length.
+ * @return An error code indicating the status of the operation.
+ */
+osal_error_t osal_msgbuf_commit(osal_msgbuf_t *msgbuf, uint8_t *ptr, uint32_t msglen);
+
+/**
+ * @brief Receives the oldest message of the message buffer.
+ *
+ * @param msgbuf Pointer to the message buffer.
+ * @param buf Pointer to the received buffer.
+ * @param bufsize Size of the buffer.
+ * @param msglen Pointer to the length of the received message.
+ * @param timeout_usec Timeout to wait when having no message.
+ * @return An error code indicating the status of the receive,
+ *         OSAL_E_PARAM if the message is longer than the buffer.
+ */
+osal_error_t osal_msgbuf_recv(osal_msgbuf_t *msgbuf, uint8_t *buf, uint32_t bufsize,
+							  uint32_t *msglen, uint32_t timeout_usec);
+
+/**
+ * @brief Reads the oldest message of the message buffer in place.
+ *
+ * The message is contiguous and stays in place until osal_msgbuf_release().
+ *
+ * @param msgbuf Pointer to the message buffer.
+ * @param ptr Pointer to the message.
+ * @param msglen Pointer to the length of the message.
+ * @param timeout_usec Timeout to wait when having no message.
+ * @return An error code indicating the status of the operation.
+ */
+osal_error_t osal_msgbuf_peek(osal_msgbuf_t *msgbuf, uint8_t **ptr, uint32_t *msglen,
+							  uint32_t timeout_usec);
+
+/**
+ * @brief Releases a message read with osal_msgbuf_peek().
+ *
+ * @param msgbuf Pointer to the message buffer.
+ * @param ptr Pointer given by osal_msgbuf_peek().
+ * @return An error code indicating the status of the operation.
+ */
+osal_error_t osal_msgbuf_release(osal_msgbuf_t *msgbuf, uint8_t *ptr);
+
+/**
+ * @brief Retrieves the number of bytes taken by the messages in the buffer.
+ *
+ * @param msgbuf Pointer to the message buffer.
+ * @return The number of bytes in use, headers and padding included.
+ */
+uint32_t osal_msgbuf_used(osal_msgbuf_t *msgbuf);
+
+/**
+ * @brief Retrieves the count of used message buffers.
+ *
+ * @return The count of currently used message buffers.
+ */
+uint32_t osal_msgbuf_use(void);
+
+/**
+ * @brief Retrieves the count of available message buffers.
+ *
+ * @return The count of currently available (unused) message buffers.
+ */
+uint32_t osal_msgbuf_avail(void);
+
+#ifdef __cplusplus	/* extern "C" */
+}
+#endif
+
+#endif //OSAL_MSGBUF_H
+
+/** @}*/
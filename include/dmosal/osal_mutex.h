@@ -42,6 +42,7 @@ extern "C" {
 #include <stdint.h>
 #include "osal_error.h"
 #include "osal_config.h"
+#include "osal_handle.h"
 
 /**
  * @brief Forward declaration of the OS abstraction layer mutex structure.
@@ -104,6 +105,22 @@ osal_error_t osal_mutex_lock(osal_mutex_t *mutex);
  */
 osal_error_t osal_mutex_unlock(osal_mutex_t *mutex);
 
+/**
+ * @brief Gets the handle of a mutex.
+ *
+ * @param mutex Pointer to the mutex.
+ * @return The handle of the mutex, or OSAL_HANDLE_INVALID.
+ */
+osal_handle_t osal_mutex_handle(osal_mutex_t *mutex);
+
+/**
+ * @brief Resolves a mutex handle.
+ *
+ * @param handle Handle of the mutex.
+ * @return Pointer to the mutex, or NULL if the mutex has been deleted since.
+ */
+osal_mutex_t *osal_mutex_resolve(osal_handle_t handle);
+
 /**
  * @brief Retrieves the count of used mutexes.
  *
@@ -40,8 +40,10 @@ extern "C" {
 #endif
 
 #include <stdint.h>
+#include <stdbool.h>
 #include "osal_error.h"
 #include "osal_config.h"
+#include "osal_handle.h"
 #include "osal_mutex.h"
 
 /**
@@ -49,13 +51,91 @@ extern "C" {
  */
 typedef struct osal_queue osal_queue_t;
 
+/**
+ * @brief Forward declaration of the OS abstraction layer queue wait set structure.
+ */
+typedef struct osal_queue_set osal_queue_set_t;
+
+/**
+ * @brief Callback of the queue watermarks.
+ *
+ * @param queue Pointer to the queue.
+ * @param high true when the high watermark is reached, false when the queue
+ *             drained down to the low watermark afterwards.
+ * @param arg Argument given with the callback.
+ */
+typedef void (*osal_queue_watermark_cb_t)(osal_queue_t *queue, bool high, void *arg);
+
+/**
+ * @brief Types of queue.
+ */
+typedef enum {
+	OSAL_QUEUE_TYPE_POSIX = 0, /**< POSIX message queue, found by its name. */
+	OSAL_QUEUE_TYPE_SPSC, /**< In-process ring for a single sender and a single receiver. */
+	OSAL_QUEUE_TYPE_MPMC, /**< In-process ring for any number of senders and receivers. */
+	OSAL_QUEUE_TYPE_SHM, /**< Ring in a shared memory object found by its name, for any number of processes. */
+	OSAL_QUEUE_TYPE_MAX, /**< Number of queue types. */
+} osal_queue_type_t;
+
+/**
+ * @brief What a send does on a full queue.
+ */
+typedef enum {
+	OSAL_QUEUE_OVERFLOW_REJECT = 0, /**< Fail with OSAL_E_QFULL, or wait with osal_queue_send_timed. */
+	OSAL_QUEUE_OVERFLOW_OVERWRITE, /**< Drop the message a receiver would get next, the oldest of its priority, ring types only. */
+	OSAL_QUEUE_OVERFLOW_CONFLATE, /**< Overwrite, and osal_queue_send_keyed replaces the pending message of its key. In-process types only. */
+	OSAL_QUEUE_OVERFLOW_MAX, /**< Number of overflow policies. */
+} osal_queue_overflow_t;
+
+/**
+ * @brief How a receive waits on an empty queue.
+ */
+typedef enum {
+	OSAL_QUEUE_RECV_BLOCK = 0, /**< Sleep until a message comes or the timeout. */
+	OSAL_QUEUE_RECV_SPIN, /**< Poll for the spin window, then sleep for the rest of the timeout. */
+	OSAL_QUEUE_RECV_POLL, /**< Poll until the timeout and never sleep, for isolated cores. */
+	OSAL_QUEUE_RECV_MAX, /**< Number of receive modes. */
+} osal_queue_recv_mode_t;
+
+/**
+ * @brief Counters of the receives that found the queue empty.
+ */
+typedef struct {
+	uint64_t spun; /**< receives served while polling */
+	uint64_t blocked; /**< receives that slept after the spin window */
+} osal_queue_recv_stats_t;
+
+/**
+ * @brief Number of buckets of the queue dwell-time histogram.
+ */
+#define OSAL_QUEUE_LATENCY_BUCKETS 32
+
+/**
+ * @brief Snapshot of the traffic counters of a queue.
+ *
+ * Bucket i of the latency histogram counts the messages that stayed in the
+ * queue from 2^i to 2^(i+1) nanoseconds, the last bucket everything longer.
+ */
+typedef struct {
+	uint64_t sent; /**< messages sent */
+	uint64_t recvd; /**< messages received or released */
+	uint64_t qfull; /**< sends rejected on a full queue */
+	uint64_t dropped; /**< messages dropped by the overflow mode */
+	uint32_t depth; /**< messages in the queue */
+	uint32_t depth_max; /**< highest number of messages seen after a send */
+	uint64_t latency[OSAL_QUEUE_LATENCY_BUCKETS]; /**< dwell-time histogram */
+} osal_queue_stats_t;
+
 /**
  * @brief Structure defining the configuration for an OS abstraction layer queue.
  */
 typedef struct {
 	uint8_t name[OSAL_QUEUE_NAME_SIZE]; /**< name of the queue. */
 	uint32_t msglen; /**< len of the message */
-	uint32_t qsize /**< size of the queue */;
+	uint32_t qsize /**< size of the queue, at least 2 for the MPMC and SHM types and an overwriting SPSC one */;
+	osal_queue_type_t type; /**< type of the queue, the name is optional for an in-process one */
+	bool prio; /**< ring types: one lane per priority, a POSIX queue always has priorities */
+	osal_queue_overflow_t overflow; /**< policy of a send on a full queue */
 } osal_queue_cfg_t;
 
 /**
@@ -74,6 +154,9 @@ void osal_queue_deinit(void);
 /**
  * @brief Creates a queue in the OS abstraction layer.
  *
+ * The ring of an in-process queue comes from osal_mem_alloc(), out of the
+ * memory region when there is one.
+ *
  * @param cfg Pointer to the queue configuration.
  * @return Pointer to the created queue.
  */
@@ -82,10 +165,38 @@ osal_queue_t *osal_queue_create(osal_queue_cfg_t *cfg);
 /**
  * @brief Deletes a queue from the OS abstraction layer.
  *
+ * The ring goes back to the memory region, for the next queue of the same
+ * size.
+ *
  * @param queue Pointer to the queue to be deleted.
  */
 void osal_queue_delete(osal_queue_t *queue);
 
+/**
+ * @brief Sets how the receives of the queue wait on an empty queue.
+ *
+ * The polling receives, peeks and batch receives save the wake up latency
+ * of a sleep at the cost of a busy core. A receive without timeout never
+ * polls. A poll of a POSIX queue is an mq_getattr() syscall, the polling
+ * modes pay off with the ring types.
+ *
+ * @param queue Pointer to the queue.
+ * @param mode Receive mode, OSAL_QUEUE_RECV_BLOCK by default.
+ * @param spin_usec Spin window of OSAL_QUEUE_RECV_SPIN, 0 for OSAL_QUEUE_SPIN_USEC.
+ * @return An error code indicating the status of the operation.
+ */
+osal_error_t osal_queue_recv_mode(osal_queue_t *queue, osal_queue_recv_mode_t mode,
+								  uint32_t spin_usec);
+
+/**
+ * @brief Reads the counters of the receive mode of the queue.
+ *
+ * @param queue Pointer to the queue.
+ * @param stats Pointer to the counters to fill.
+ * @return An error code indicating the status of the operation.
+ */
+osal_error_t osal_queue_recv_stats(osal_queue_t *queue, osal_queue_recv_stats_t *stats);
+
 /**
  * @brief Sends a message into the queue.
  *
@@ -96,6 +207,88 @@ void osal_queue_delete(osal_queue_t *queue);
  */
 osal_error_t osal_queue_send(osal_queue_t *queue, uint8_t *msg, uint32_t msglen);
 
+/**
+ * @brief Sends a message into the queue with a priority.
+ *
+ * A receiver gets the messages of the highest priority first, in the order
+ * they were sent within a priority. The zero-copy and batch sends use the
+ * lowest priority.
+ *
+ * @param queue Pointer to the queue.
+ * @param msg Pointer to the message data.
+ * @param msglen Length of the message.
+ * @param prio Priority of the message, below OSAL_QUEUE_PRIO_NUM.
+ * @return An error code indicating the status of the send,
+ *         OSAL_E_NOSUPPORT for a ring created without priorities.
+ */
+osal_error_t osal_queue_send_prio(osal_queue_t *queue, uint8_t *msg,
+								  uint32_t msglen, uint32_t prio);
+
+/**
+ * @brief Sends a message into the queue, waiting for a free slot.
+ *
+ * @param queue Pointer to the queue.
+ * @param msg Pointer to the message data.
+ * @param msglen Length of the message.
+ * @param timeout_usec Timeout to wait on queue when full, 0 fails at once
+ *                     with OSAL_E_QFULL as osal_queue_send.
+ * @return An error code indicating the status of the send,
+ *         OSAL_E_TIMEOUT if the queue stayed full.
+ */
+osal_error_t osal_queue_send_timed(osal_queue_t *queue, uint8_t *msg,
+								   uint32_t msglen, uint32_t timeout_usec);
+
+/**
+ * @brief Sends a message replacing the pending message with the same key.
+ *
+ * The new message takes the place of the replaced one in the queue, so a
+ * receiver only gets the latest value of each key. The queue has to be
+ * created with OSAL_QUEUE_OVERFLOW_CONFLATE, a full queue then drops its
+ * oldest message.
+ *
+ * @param queue Pointer to the queue.
+ * @param msg Pointer to the message data.
+ * @param msglen Length of the message.
+ * @param key Key of the message.
+ * @return An error code indicating the status of the send,
+ *         OSAL_E_NOSUPPORT for a queue that does not conflate.
+ */
+osal_error_t osal_queue_send_keyed(osal_queue_t *queue, uint8_t *msg,
+								   uint32_t msglen, uint32_t key);
+
+/**
+ * @brief Sets the watermarks of the queue.
+ *
+ * The callback is called with high set once the number of messages reaches
+ * high after a send, then with high cleared once it drops to low after a
+ * receive, from the thread of the send or receive. It lets the upstream
+ * stages throttle before the queue is full. Set it before the queue is
+ * shared between threads.
+ *
+ * @param queue Pointer to the queue.
+ * @param high Number of messages calling back with high set, up to the queue size.
+ * @param low Number of messages calling back with high cleared, below high.
+ * @param cb Callback, NULL to remove the watermarks.
+ * @param arg Argument given to the callback.
+ * @return An error code indicating the status of the operation.
+ */
+osal_error_t osal_queue_watermark(osal_queue_t *queue, uint32_t high, uint32_t low,
+								  osal_queue_watermark_cb_t cb, void *arg);
+
+/**
+ * @brief Reads the traffic counters of the queue.
+ *
+ * Only available when built with OSAL_CONFIG_QUEUE_STATS. The counters are
+ * read one by one while the queue runs, and the POSIX backend records no
+ * dwell times since its messages carry no timestamp.
+ *
+ * @param queue Pointer to the queue.
+ * @param stats Pointer to the snapshot to fill.
+ * @return OSAL_E_NOSUPPORT when built without the instrumentation, or an
+ *         error code indicating the status of the operation.
+ */
+osal_error_t osal_queue_stats(osal_queue_t *queue, osal_queue_stats_t *stats);
+
 /**
  * @brief Receives a message from the queue.
  *
@@ -104,9 +297,122 @@ osal_error_t osal_queue_send(osal_queue_t *queue, uint8_t *msg, uint32_t msglen)
  * @param bufsize Size of the buffer.
  * @param timeout_usec Timeout to wait on queue when having no message
  * @return An error code indicating the status of the receive.
+ *
+ * An in-process queue only enters the kernel to sleep when it is empty.
  */
 osal_error_t osal_queue_recv(osal_queue_t *queue, uint8_t *buf,
 							 uint32_t bufsize, uint32_t timeout_usec);
+
+/**
+ * @brief Receives a message from the queue along with its length.
+ *
+ * @param queue Pointer to the queue.
+ * @param buf Pointer to the received buffer.
+ * @param bufsize Size of the buffer.
+ * @param msglen Returns the length of the received message.
+ * @param timeout_usec Timeout to wait on queue when having no message
+ * @return An error code indicating the status of the receive.
+ */
+osal_error_t osal_queue_recv_len(osal_queue_t *queue, uint8_t *buf, uint32_t bufsize,
+								 uint32_t *msglen, uint32_t timeout_usec);
+
+/**
+ * @brief Sends a batch of messages into the queue.
+ *
+ * @param queue Pointer to the queue.
+ * @param msgs Array of n pointers to the message data.
+ * @param lens Array of n message lengths.
+ * @param n Number of messages.
+ * @param sent Returns the number of messages sent, the first ones of msgs.
+ * @return OSAL_E_OK if all were sent, OSAL_E_QFULL if the queue filled up first.
+ *
+ * An in-process queue publishes the batch with a single wake up.
+ */
+osal_error_t osal_queue_send_batch(osal_queue_t *queue, uint8_t *msgs[],
+								   uint32_t lens[], uint32_t n, uint32_t *sent);
+
+/**
+ * @brief Receives a batch of messages from the queue.
+ *
+ * @param queue Pointer to the queue.
+ * @param bufs Array of n pointers to the received buffers.
+ * @param lens Returns the length of each received message.
+ * @param bufsize Size of each buffer.
+ * @param n Number of buffers.
+ * @param got Returns the number of messages received.
+ * @param timeout_usec Timeout to wait on queue when having no message
+ * @return An error code indicating the status of the receive.
+ *
+ * Only the first message is waited for, the call then takes at most n
+ * messages among those already in the queue.
+ */
+osal_error_t osal_queue_recv_batch(osal_queue_t *queue, uint8_t *bufs[],
+								   uint32_t lens[], uint32_t bufsize, uint32_t n,
+								   uint32_t *got, uint32_t timeout_usec);
+
+/**
+ * @brief Reserves the next free slot of the queue to build a message in place.
+ *
+ * @param queue Pointer to the queue.
+ * @param ptr Returns the slot storage, valid for msglen bytes of the queue.
+ * @return OSAL_E_QFULL if the queue is full, OSAL_E_NOSUPPORT for a POSIX queue.
+ *
+ * Every reserved slot must be handed over with osal_queue_commit(), a
+ * single-producer queue allows only one reservation at a time.
+ */
+osal_error_t osal_queue_reserve(osal_queue_t *queue, uint8_t **ptr);
+
+/**
+ * @brief Commits a reserved slot, making the message visible to the receivers.
+ *
+ * @param queue Pointer to the queue.
+ * @param ptr Slot storage returned by osal_queue_reserve().
+ * @param msglen Length of the message built in the slot.
+ * @return An error code indicating the status of the commit.
+ */
+osal_error_t osal_queue_commit(osal_queue_t *queue, uint8_t *ptr, uint32_t msglen);
+
+/**
+ * @brief Takes the oldest message of the queue without copying it out.
+ *
+ * @param queue Pointer to the queue.
+ * @param ptr Returns the slot storage holding the message.
+ * @param msglen Returns the length of the message.
+ * @param timeout_usec Timeout to wait on queue when having no message
+ * @return An error code indicating the status of the peek.
+ *
+ * The slot stays owned by the caller until osal_queue_release(), the
+ * senders cannot reuse it in the meantime.
+ */
+osal_error_t osal_queue_peek(osal_queue_t *queue, uint8_t **ptr,
+							 uint32_t *msglen, uint32_t timeout_usec);
+
+/**
+ * @brief Releases a slot taken by osal_queue_peek() back to the senders.
+ *
+ * @param queue Pointer to the queue.
+ * @param ptr Slot storage returned by osal_queue_peek().
+ * @return An error code indicating the status of the release, OSAL_E_PARAM
+ * for a pointer that is not the slot of a peeked message.
+ */
+osal_error_t osal_queue_release(osal_queue_t *queue, uint8_t *ptr);
+
+/**
+ * @brief Gets the handle of a queue.
+ *
+ * @param queue Pointer to the queue.
+ * @return The handle of the queue, or OSAL_HANDLE_INVALID.
+ */
+osal_handle_t osal_queue_handle(osal_queue_t *queue);
+
+/**
+ * @brief Resolves a queue handle.
+ *
+ * @param handle Handle of the queue.
+ * @return Pointer to the queue, or NULL if the queue has been deleted since.
+ */
+osal_queue_t *osal_queue_resolve(osal_handle_t handle);
+
 /**
  * @brief Retrieves the count of used queues.
  *
@@ -121,6 +427,87 @@ uint32_t osal_queue_use(void);
  */
 uint32_t osal_queue_avail(void);
 
+/**
+ * @brief Initializes the queue wait set subsystem.
+ *
+ * @param mutex Mutex to protect the internal resource.
+ * @return An error code indicating the status of the initialization.
+ */
+osal_error_t osal_queue_set_init(osal_mutex_t *mutex);
+
+/**
+ * @brief Deinitializes the queue wait set subsystem.
+ */
+void osal_queue_set_deinit(void);
+
+/**
+ * @brief Creates a wait set blocking on several queues at once.
+ *
+ * @return Pointer to the created set, or NULL.
+ *
+ * A set is meant to be used by a single receiving task, the queues are
+ * added, removed and waited for from that task.
+ */
+osal_queue_set_t *osal_queue_set_create(void);
+
+/**
+ * @brief Deletes a wait set, the queues in it are left untouched.
+ *
+ * @param set Pointer to the set.
+ */
+void osal_queue_set_delete(osal_queue_set_t *set);
+
+/**
+ * @brief Adds a queue to a wait set.
+ *
+ * @param set Pointer to the set.
+ * @param queue Pointer to the queue.
+ * @return OSAL_E_INUSE if the queue is already in a set, OSAL_E_RESRC if the
+ * set is full, OSAL_E_NOSUPPORT for a shared memory queue.
+ */
+osal_error_t osal_queue_set_add(osal_queue_set_t *set, osal_queue_t *queue);
+
+/**
+ * @brief Removes a queue from a wait set.
+ *
+ * @param set Pointer to the set.
+ * @param queue Pointer to the queue.
+ * @return An error code indicating the status of the removal.
+ *
+ * A queue deleted while in a set is removed from it.
+ */
+osal_error_t osal_queue_set_remove(osal_queue_set_t *set, osal_queue_t *queue);
+
+/**
+ * @brief Waits until at least one queue of the set has a message.
+ *
+ * @param set Pointer to the set.
+ * @param ready Returns the readable queues, in the order they were added.
+ * @param n Size of the ready array.
+ * @param n_ready Returns the number of readable queues.
+ * @param timeout_usec Timeout to wait when no queue has a message
+ * @return OSAL_E_OK, or OSAL_E_TIMEOUT if no queue got a message in time.
+ *
+ * A queue reported ready may have been emptied by another receiver since,
+ * its receive should then use a zero timeout.
+ */
+osal_error_t osal_queue_set_wait(osal_queue_set_t *set, osal_queue_t *ready[],
+								 uint32_t n, uint32_t *n_ready, uint32_t timeout_usec);
+
+/**
+ * @brief Retrieves the count of used queue wait sets.
+ *
+ * @return The count of currently used sets.
+ */
+uint32_t osal_queue_set_use(void);
+
+/**
+ * @brief Retrieves the count of available queue wait sets.
+ *
+ * @return The count of currently available (unused) sets.
+ */
+uint32_t osal_queue_set_avail(void);
+
 #ifdef __cplusplus	/* extern "C" */
 }
 #endif
@@ -41,8 +41,12 @@ extern "C" {
 
 #include <stdbool.h>
 #include <stdint.h>
+#include <string.h>
+#include "osal_config.h"
 #include "osal_mutex.h"
 #include "osal_lifo.h"
+#include "osal_handle.h"
+#include "osal_spinlock.h"
 
 /**
  * @brief Structure defining a resource managed by the resource manager.
@@ -50,16 +54,59 @@ extern "C" {
 typedef struct {
 	osal_lifo_node_t node; /**< Node for managing resources in a LIFO manner. */
 	bool used; /**< Flag indicating if the resource is currently in use. */
+	osal_handle_t handle; /**< Current handle of the resource. */
 	void *data; /**< Pointer to user-assigned data for the resource. */
 } osal_resrc_t;
 
+/**
+ * @brief Protections of the pool of free resources.
+ *
+ * The values are also the ones of OSAL_RM_LOCK.
+ */
+typedef enum {
+	OSAL_RM_LOCK_MUTEX = 0, /**< The osal_rm_cfg_t mutex, no protection if it is NULL. */
+	OSAL_RM_LOCK_NONE, /**< No protection, the pool is used by a single thread. */
+	OSAL_RM_LOCK_SPIN, /**< An internal spinlock with a pause backoff. */
+	OSAL_RM_LOCK_LOCKFREE, /**< No lock, a lock-free LIFO. */
+} osal_rm_lock_t;
+
+/**
+ * @brief Policies of the pool of free resources.
+ *
+ * The bitmap policy keeps the used resources dense at the start of the array
+ * and bounds the allocation by a scan of OSAL_RM_BITMAP_WORDS(n) words. It
+ * takes and returns the resources with atomic bit operations, a bitmap pool
+ * is always OSAL_RM_LOCK_LOCKFREE and does not use the magazines.
+ */
+typedef enum {
+	OSAL_RM_POLICY_LIFO = 0, /**< The last freed resource is allocated first. */
+	OSAL_RM_POLICY_BITMAP, /**< The free resource of the lowest index is allocated first. */
+} osal_rm_policy_t;
+
+/**
+ * @brief Number of the bitmap words needed by a bitmap pool of n resources.
+ */
+#define OSAL_RM_BITMAP_WORDS(n) (((n) + 63) / 64)
+
 /**
  * @brief Structure defining the resource manager.
  */
 typedef struct {
 	osal_mutex_t *mutex; /**< The mutex used for resource manager synchronization. */
 	osal_lifo_t resrc_pool; /**< Resource pool for managing resources. */
+	osal_lifo_atomic_t resrc_alifo; /**< Resource pool used in the lock-free mode. */
+	osal_resrc_t *resrces; /**< Pointer to the first resource. */
+	uint32_t resrc_stride; /**< Distance in bytes between two resources. */
+	osal_rm_lock_t lock; /**< Protection of the pool. */
+	osal_spinlock_t spinlock; /**< Lock of the pool with OSAL_RM_LOCK_SPIN. */
+	osal_rm_policy_t policy; /**< Policy of the pool of free resources. */
+	uint64_t *bitmap; /**< Free resources of the bitmap policy, a set bit per free resource. */
+	uint32_t n_free; /**< Number of the set bits in the bitmap. */
 	uint32_t n_resrces; /**< Number of resources in the pool. */
+	bool magazine; /**< Free resources are cached per thread. */
+	uint32_t mag_idx; /**< Index of the per-thread magazine of this pool. */
+	uint32_t mag_gen; /**< Generation invalidating the magazines of a previous init. */
+	uint32_t n_cached; /**< Number of free resources held in the magazines. */
 } osal_rm_t;
 
 /**
@@ -67,8 +114,13 @@ typedef struct {
  */
 typedef struct {
 	osal_mutex_t *mutex; /**< The mutex to protect the rm, set to NULL if protect is not required */
-	uint32_t n_resrces; /**< Number of resources in the resource manager. */
+	uint32_t n_resrces; /**< Number of resources, only the first OSAL_HANDLE_INDEX_MAX+1 ones have a handle. */
 	osal_resrc_t *resrces; /**< Pointer to the array of the global resources */
+	uint32_t resrc_stride; /**< Distance in bytes between two resources, 0 for an array of osal_resrc_t */
+	osal_rm_lock_t lock; /**< Protection of the pool, the mutex is only used with OSAL_RM_LOCK_MUTEX */
+	bool magazine; /**< Cache free resources per thread, see OSAL_RM_MAGAZINE_SIZE */
+	osal_rm_policy_t policy; /**< Policy of the pool, OSAL_RM_POLICY_LIFO by default */
+	uint64_t *bitmap; /**< OSAL_RM_BITMAP_WORDS(n_resrces) words for OSAL_RM_POLICY_BITMAP */
 } osal_rm_cfg_t;
 
 /**
@@ -103,9 +155,59 @@ osal_resrc_t *osal_rm_alloc(osal_rm_t *rm);
  */
 void osal_rm_free(osal_rm_t *rm, osal_resrc_t *resrc);
 
+/**
+ * @brief Allocates several resources from the resource manager at once.
+ *
+ * The pool is locked once for all the resources. The per-thread magazines
+ * are not used by the bulk calls.
+ *
+ * @param rm Pointer to the resource manager.
+ * @param out Array to store the pointers to the allocated resources.
+ * @param n Number of resources to allocate.
+ * @return The number of allocated resources, less than n if the pool runs out.
+ */
+uint32_t osal_rm_alloc_bulk(osal_rm_t *rm, osal_resrc_t *out[], uint32_t n);
+
+/**
+ * @brief Frees several resources in the resource manager at once.
+ *
+ * The pool is locked once for all the resources.
+ *
+ * @param rm Pointer to the resource manager.
+ * @param in Array of the resources to be freed.
+ * @param n Number of resources in the array.
+ */
+void osal_rm_free_bulk(osal_rm_t *rm, osal_resrc_t *in[], uint32_t n);
+
+/**
+ * @brief Gets the handle of an allocated resource.
+ *
+ * @param rm Pointer to the resource manager.
+ * @param resrc Pointer to the allocated resource.
+ * @return The handle of the resource, or OSAL_HANDLE_INVALID, also for a
+ * resource of an index above OSAL_HANDLE_INDEX_MAX.
+ */
+osal_handle_t osal_rm_handle(osal_rm_t *rm, osal_resrc_t *resrc);
+
+/**
+ * @brief Resolves a handle to its resource.
+ *
+ * The handle is resolved in constant time. A handle of a resource that has
+ * been freed since does not resolve. The caller still has to make sure the
+ * resource is not freed while it is being used.
+ *
+ * @param rm Pointer to the resource manager.
+ * @param handle Handle to be resolved.
+ * @return Pointer to the resource, or NULL if the handle is stale or invalid.
+ */
+osal_resrc_t *osal_rm_resolve(osal_rm_t *rm, osal_handle_t handle);
+
 /**
  * @brief Retrieves the count of available resources in the resource manager.
  *
+ * The free resources cached in the per-thread magazines are counted as
+ * available, but only the thread holding them can allocate them.
+ *
  * @param rm Pointer to the resource manager.
  * @return The count of available resources.
  */
@@ -120,38 +222,116 @@ uint32_t osal_rm_avail(osal_rm_t *rm);
 uint32_t osal_rm_use(osal_rm_t *rm);
 
 /**
- * @brief Macro for declaring a user-managed object array with the resource manager.
+ * @brief Size of a CPU cache line, the alignment of the cache-line layout.
+ */
+#define OSAL_CACHELINE_SIZE 64
+
+/**
+ * @brief Macro for declaring a user-managed object array with the packed layout.
+ *
+ * The objects and the resources are kept in two separate arrays.
  *
  * @param userobj_type Type of user-managed object.
  * @param userobj_num Number of user-managed objects.
  */
-#define OSAL_RM_USEROBJMAN_DECLARE(userobj_type, userobj_num) \
+#define OSAL_RM_USEROBJMAN_DECLARE_PACKED(userobj_type, userobj_num) \
 	userobj_type userobj[userobj_num]; \
 	osal_resrc_t resrces[userobj_num]; \
 	osal_rm_t rm;
 
 /**
- * @brief Macro for initializing a user-managed object array with the resource manager.
+ * @brief Macro for declaring a user-managed object array with the cache-line layout.
+ *
+ * Each resource is kept together with its object in an entry aligned and
+ * padded to OSAL_CACHELINE_SIZE, so two objects never share a cache line.
+ *
+ * @param userobj_type Type of user-managed object.
+ * @param userobj_num Number of user-managed objects.
+ */
+#define OSAL_RM_USEROBJMAN_DECLARE_CACHELINE(userobj_type, userobj_num) \
+	struct { \
+		osal_resrc_t resrc; \
+		userobj_type userobj; \
+	} __attribute__((aligned(OSAL_CACHELINE_SIZE))) entries[userobj_num]; \
+	osal_rm_t rm;
+
+/**
+ * @brief Accessors of the resource, the object and the entry size of each layout.
+ */
+#define OSAL_RM_PACKED_RESRC(userobjman_ptr, i) (&(userobjman_ptr)->resrces[i])
+#define OSAL_RM_PACKED_USEROBJ(userobjman_ptr, i) (&(userobjman_ptr)->userobj[i])
+#define OSAL_RM_PACKED_STRIDE(userobjman_ptr) sizeof(osal_resrc_t)
+#define OSAL_RM_PACKED_OBJS(userobjman_ptr) ((userobjman_ptr)->userobj)
+#define OSAL_RM_CACHELINE_RESRC(userobjman_ptr, i) (&(userobjman_ptr)->entries[i].resrc)
+#define OSAL_RM_CACHELINE_USEROBJ(userobjman_ptr, i) (&(userobjman_ptr)->entries[i].userobj)
+#define OSAL_RM_CACHELINE_STRIDE(userobjman_ptr) sizeof((userobjman_ptr)->entries[0])
+#define OSAL_RM_CACHELINE_OBJS(userobjman_ptr) ((userobjman_ptr)->entries)
+
+/**
+ * @brief Macro for initializing a user-managed object array of a given layout.
+ *
+ * The objects are cleared first, which faults in the pages of the array at
+ * init rather than at the first use of an object.
  *
  * @param userobjman_ptr Pointer to the user-managed object array.
  * @param userobj_num Number of user-managed objects.
  * @param mutex_ptr External mutex if the resource manager should be thread-safe.
+ * It is only used when the OSAL is built with OSAL_RM_LOCK set to OSAL_RM_LOCK_MUTEX.
+ * @param layout PACKED or CACHELINE, as the array was declared.
  */
-#define OSAL_RM_USEROBJMAN_INIT(userobjman_ptr, userobj_num, mutex_ptr)	\
+#define OSAL_RM_USEROBJMAN_INIT_LAYOUT(userobjman_ptr, userobj_num, mutex_ptr, layout) \
 	{ \
-		osal_rm_cfg_t rmcfg; \
+		osal_rm_cfg_t rmcfg = {0}; \
 		int i; \
 		int res; \
+		memset(OSAL_RM_##layout##_OBJS(userobjman_ptr), 0, \
+			   sizeof(OSAL_RM_##layout##_OBJS(userobjman_ptr))); \
 		for (i = 0; i < userobj_num; i++) { \
-			(userobjman_ptr)->resrces[i].data = &(userobjman_ptr)->userobj[i]; \
+			OSAL_RM_##layout##_RESRC(userobjman_ptr, i)->data = \
+				OSAL_RM_##layout##_USEROBJ(userobjman_ptr, i); \
 		} \
 		rmcfg.mutex = mutex_ptr; \
 		rmcfg.n_resrces = userobj_num; \
-		rmcfg.resrces = (userobjman_ptr)->resrces; \
+		rmcfg.resrces = OSAL_RM_##layout##_RESRC(userobjman_ptr, 0); \
+		rmcfg.resrc_stride = OSAL_RM_##layout##_STRIDE(userobjman_ptr); \
+		rmcfg.lock = OSAL_RM_LOCK; \
+		rmcfg.magazine = (OSAL_RM_MAGAZINE_SIZE > 0); \
 		res = osal_rm_init(&(userobjman_ptr)->rm, &rmcfg); \
 		OSAL_RUNTIME_ASSERT(res == OSAL_E_OK); \
 	}
 
+/**
+ * @def OSAL_RM_USEROBJMAN_DECLARE(userobj_type, userobj_num)
+ * @brief Macro for declaring a user-managed object array with the resource manager.
+ *
+ * The layout is the cache-line one when the OSAL is built with
+ * OSAL_RM_CACHELINE_LAYOUT, the packed one otherwise.
+ *
+ * @param userobj_type Type of user-managed object.
+ * @param userobj_num Number of user-managed objects.
+ */
+
+/**
+ * @def OSAL_RM_USEROBJMAN_INIT(userobjman_ptr, userobj_num, mutex_ptr)
+ * @brief Macro for initializing a user-managed object array with the resource manager.
+ *
+ * @param userobjman_ptr Pointer to the user-managed object array.
+ * @param userobj_num Number of user-managed objects.
+ * @param mutex_ptr External mutex if the resource manager should be thread-safe.
+ * It is only used when the OSAL is built with OSAL_RM_LOCK set to OSAL_RM_LOCK_MUTEX.
+ */
+#if OSAL_RM_CACHELINE_LAYOUT
+#define OSAL_RM_USEROBJMAN_DECLARE(userobj_type, userobj_num) \
+	OSAL_RM_USEROBJMAN_DECLARE_CACHELINE(userobj_type, userobj_num)
+#define OSAL_RM_USEROBJMAN_INIT(userobjman_ptr, userobj_num, mutex_ptr) \
+	OSAL_RM_USEROBJMAN_INIT_LAYOUT(userobjman_ptr, userobj_num, mutex_ptr, CACHELINE)
+#else
+#define OSAL_RM_USEROBJMAN_DECLARE(userobj_type, userobj_num) \
+	OSAL_RM_USEROBJMAN_DECLARE_PACKED(userobj_type, userobj_num)
+#define OSAL_RM_USEROBJMAN_INIT(userobjman_ptr, userobj_num, mutex_ptr) \
+	OSAL_RM_USEROBJMAN_INIT_LAYOUT(userobjman_ptr, userobj_num, mutex_ptr, PACKED)
+#endif
+
 #ifdef __cplusplus	/* extern "C" */
 }
 #endif
@@ -42,6 +42,7 @@ extern "C" {
 #include <stdint.h>
 #include "osal_error.h"
 #include "osal_config.h"
+#include "osal_handle.h"
 #include "osal_mutex.h"
 
 /**
@@ -101,6 +102,22 @@ osal_error_t osal_sem_wait(osal_sem_t *sem);
  */
 osal_error_t osal_sem_waittime(osal_sem_t *sem, uint32_t usec);
 
+/**
+ * @brief Gets the handle of a semaphore.
+ *
+ * @param sem Pointer to the semaphore.
+ * @return The handle of the semaphore, or OSAL_HANDLE_INVALID.
+ */
+osal_handle_t osal_sem_handle(osal_sem_t *sem);
+
+/**
+ * @brief Resolves a semaphore handle.
+ *
+ * @param handle Handle of the semaphore.
+ * @return Pointer to the semaphore, or NULL if the semaphore has been deleted since.
+ */
+osal_sem_t *osal_sem_resolve(osal_handle_t handle);
+
 /**
  * @brief Retrieves the count of used semaphores.
  *
@@ -0,0 +1,137 @@
+/* BSD 2-Clause License
+*
+* Copyright (c) 2025, nguyenvannam142@gmail.com
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*
+* 1. Redistributions of source code must retain the above copyright notice, this
+*    list of conditions and the following disclaimer.
+*
+* 2. Redistributions in binary form must reproduce the above copyright notice,
+*    this list of conditions and the following disclaimer in the documentation
+*    and/or other materials provided with the distribution.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+/**
+ * @addtogroup dmosal
+ * @{
+ * @file osal_spinlock.h
+ * @brief OS Abstraction Layer Spinlock Definitions
+ * @copyright Copyright (c) 2025, nguyenvannam142@gmail.com
+ * @author Nam Nguyen Van(nguyenvannam142@gmail.com)
+ */
+#ifndef OSAL_SPINLOCK_H
+#define OSAL_SPINLOCK_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * @brief Upper bound of the number of pauses between two attempts.
+ */
+#define OSAL_SPINLOCK_BACKOFF_MAX 64
+
+/**
+ * @brief Test-and-test-and-set spinlock.
+ *
+ * It is meant for critical sections of a few instructions, a holder being
+ * preempted makes the waiters spin until it runs again.
+ */
+typedef struct {
+	uint32_t locked; /**< 1 while the lock is held. */
+} osal_spinlock_t;
+
+/**
+ * @brief Tells the CPU that the caller is spinning.
+ */
+static inline void osal_cpu_relax(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+	__builtin_ia32_pause();
+#elif defined(__aarch64__)
+	__asm__ __volatile__("yield" ::: "memory");
+#else
+	__asm__ __volatile__("" ::: "memory");
+#endif
+}
+
+/**
+ * @brief Initializes a spinlock in the unlocked state.
+ *
+ * @param lock Pointer to the spinlock.
+ */
+static inline void osal_spinlock_init(osal_spinlock_t *lock)
+{
+	__atomic_store_n(&lock->locked, 0, __ATOMIC_RELAXED);
+}
+
+/**
+ * @brief Tries to take a spinlock without waiting.
+ *
+ * @param lock Pointer to the spinlock.
+ * @return true if the lock has been taken.
+ */
+static inline bool osal_spinlock_trylock(osal_spinlock_t *lock)
+{
+	return __atomic_exchange_n(&lock->locked, 1, __ATOMIC_ACQUIRE) == 0;
+}
+
+/**
+ * @brief Takes a spinlock.
+ *
+ * The waiters only read the lock word until it is released, and pause for
+ * an exponentially growing time between two reads.
+ *
+ * @param lock Pointer to the spinlock.
+ */
+static inline void osal_spinlock_lock(osal_spinlock_t *lock)
+{
+	uint32_t backoff;
+	uint32_t i;
+
+	while (osal_spinlock_trylock(lock) == false) {
+		backoff = 1;
+		while (__atomic_load_n(&lock->locked, __ATOMIC_RELAXED) != 0) {
+			for (i = 0; i < backoff; i++) {
+				osal_cpu_relax();
+			}
+			if (backoff < OSAL_SPINLOCK_BACKOFF_MAX) {
+				backoff <<= 1;
+			}
+		}
+	}
+}
+
+/**
+ * @brief Releases a spinlock.
+ *
+ * @param lock Pointer to the spinlock.
+ */
+static inline void osal_spinlock_unlock(osal_spinlock_t *lock)
+{
+	__atomic_store_n(&lock->locked, 0, __ATOMIC_RELEASE);
+}
+
+#ifdef __cplusplus	/* extern "C" */
+}
+#endif
+
+#endif //OSAL_SPINLOCK_H
+
+/** @}*/
@@ -42,6 +42,7 @@ extern "C" {
 #include <stdint.h>
 #include "osal_error.h"
 #include "osal_config.h"
+#include "osal_handle.h"
 #include "osal_mutex.h"
 
 /**
@@ -89,6 +90,22 @@ osal_task_t *osal_task_create(osal_task_cfg_t *cfg);
  */
 void osal_task_delete(osal_task_t *task);
 
+/**
+ * @brief Gets the handle of a task.
+ *
+ * @param task Pointer to the task.
+ * @return The handle of the task, or OSAL_HANDLE_INVALID.
+ */
+osal_handle_t osal_task_handle(osal_task_t *task);
+
+/**
+ * @brief Resolves a task handle.
+ *
+ * @param handle Handle of the task.
+ * @return Pointer to the task, or NULL if the task has been deleted since.
+ */
+osal_task_t *osal_task_resolve(osal_handle_t handle);
+
 /**
  * @brief Retrieves the count of used tasks.
  *
@@ -43,6 +43,7 @@ extern "C" {
 #include <stdbool.h>
 #include "osal_error.h"
 #include "osal_config.h"
+#include "osal_handle.h"
 #include "osal_mutex.h"
 
 /**
@@ -96,6 +97,22 @@ void osal_timer_stop(osal_timer_t *timer);
  */
 void osal_timer_delete(osal_timer_t *timer);
 
+/**
+ * @brief Gets the handle of a timer.
+ *
+ * @param timer Pointer to the timer.
+ * @return The handle of the timer, or OSAL_HANDLE_INVALID.
+ */
+osal_handle_t osal_timer_handle(osal_timer_t *timer);
+
+/**
+ * @brief Resolves a timer handle.
+ *
+ * @param handle Handle of the timer.
+ * @return Pointer to the timer, or NULL if the timer has been deleted since.
+ */
+osal_timer_t *osal_timer_resolve(osal_handle_t handle);
+
 /**
  * @brief Retrieves the count of used timers.
  *
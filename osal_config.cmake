@@ -13,6 +13,14 @@ set(OSAL_CONFIG_MUTEX_NUM_MAX 64
     CACHE STRING "Maximum number of mutexes to support"
 )
 
+set(OSAL_CONFIG_MUTEX_FUTEX 0
+    CACHE STRING "Set to 1 to build the mutexes on a futex instead of a pthread mutex"
+)
+
+set(OSAL_CONFIG_MUTEX_SPIN_MAX 100
+    CACHE STRING "Upper bound of the adaptive spin of a futex mutex before it sleeps"
+)
+
 set(OSAL_CONFIG_SEM_NUM_MAX 64
     CACHE STRING "Maximum number of semaphores to support"
 )
@@ -29,6 +37,38 @@ set(OSAL_CONFIG_QUEUE_NUM_MAX 64
     CACHE STRING "Maximum number of queues to support"
 )
 
+set(OSAL_CONFIG_QUEUE_PRIO_NUM 4
+    CACHE STRING "Number of message priorities of a queue"
+)
+
+set(OSAL_CONFIG_QUEUE_SPIN_USEC 50
+    CACHE STRING "Default time a spinning queue receive polls before sleeping"
+)
+
+set(OSAL_CONFIG_QUEUE_STATS 0
+    CACHE STRING "Set to 1 to count queue traffic and record message dwell times"
+)
+
+set(OSAL_CONFIG_QUEUE_SET_NUM_MAX 16
+    CACHE STRING "Maximum number of queue wait sets to support"
+)
+
+set(OSAL_CONFIG_QUEUE_SET_SIZE 64
+    CACHE STRING "Maximum number of queues in a wait set"
+)
+
+set(OSAL_CONFIG_CHANNEL_NUM_MAX 16
+    CACHE STRING "Maximum number of broadcast channels to support"
+)
+
+set(OSAL_CONFIG_CHANNEL_SUB_MAX 16
+    CACHE STRING "Maximum number of subscribers of a channel"
+)
+
+set(OSAL_CONFIG_MSGBUF_NUM_MAX 16
+    CACHE STRING "Maximum number of message buffers to support"
+)
+
 set(OSAL_CONFIG_LOG_MODULE_NUM_MAX 32
     CACHE STRING "Maximum number of log module to support"
 )
@@ -44,3 +84,51 @@ set(OSAL_CONFIG_LOG_STRING_SIZE 256
 set(OSAL_CONFIG_TMCHECK_NUM_MAX 64
     CACHE STRING "Maximum number of the time check point to support"
 )
+
+set(OSAL_CONFIG_RM_LOCK 0
+    CACHE STRING "Protection of the resource pools in the OSAL submodules: 0 mutex, 2 spinlock, 3 lock-free"
+)
+# the submodule pools are shared between threads, 1 (no protection) is not an option
+if(NOT OSAL_CONFIG_RM_LOCK MATCHES "^[023]$")
+    message(FATAL_ERROR "OSAL_CONFIG_RM_LOCK must be 0, 2 or 3, not ${OSAL_CONFIG_RM_LOCK}")
+endif()
+
+set(OSAL_CONFIG_RM_MAGAZINE_SIZE 0
+    CACHE STRING "Depth of the per-thread resource caches, 0 to disable them"
+)
+
+set(OSAL_CONFIG_RM_MAGAZINE_NUM_MAX 16
+    CACHE STRING "Maximum number of pools using the per-thread resource caches (up to 64)"
+)
+
+set(OSAL_CONFIG_RM_CACHELINE_LAYOUT 0
+    CACHE STRING "Set to 1 to align each pooled object with its resource to a cache line"
+)
+
+set(OSAL_CONFIG_MEMPOOL_SIZE_0 64
+    CACHE STRING "Block size of the memory pool class 0"
+)
+set(OSAL_CONFIG_MEMPOOL_NUM_0 64
+    CACHE STRING "Number of blocks of the memory pool class 0"
+)
+
+set(OSAL_CONFIG_MEMPOOL_SIZE_1 256
+    CACHE STRING "Block size of the memory pool class 1"
+)
+set(OSAL_CONFIG_MEMPOOL_NUM_1 32
+    CACHE STRING "Number of blocks of the memory pool class 1"
+)
+
+set(OSAL_CONFIG_MEMPOOL_SIZE_2 1024
+    CACHE STRING "Block size of the memory pool class 2"
+)
+set(OSAL_CONFIG_MEMPOOL_NUM_2 16
+    CACHE STRING "Number of blocks of the memory pool class 2"
+)
+
+set(OSAL_CONFIG_MEMPOOL_SIZE_3 4096
+    CACHE STRING "Block size of the memory pool class 3"
+)
+set(OSAL_CONFIG_MEMPOOL_NUM_3 8
+    CACHE STRING "Number of blocks of the memory pool class 3"
+)
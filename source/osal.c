@@ -41,6 +41,7 @@ osal_error_t osal_init(osal_config_t *config)
 	osal_error_t res;
 	osal_log_output_t log_output = log_output_default;
 	osal_log_level_t log_level = OSALOG_LEVEL_INFO;
+	osal_mem_cfg_t *mem_cfg = NULL;
 
 	if (s_initialized) {
 		return OSAL_E_OK;
@@ -51,6 +52,13 @@ osal_error_t osal_init(osal_config_t *config)
 			log_output = config->log_output;
 		}
 		log_level = config->osal_level;
+		mem_cfg = &config->mem;
+	}
+
+	/* the memory region is mapped and faulted in before any allocation */
+	res = osal_mem_init(mem_cfg);
+	if (res != OSAL_E_OK) {
+		return res;
 	}
 
 	/* mutex must be init first since it is used in other osal modules */
@@ -86,6 +94,19 @@ osal_error_t osal_init(osal_config_t *config)
 	res = osal_queue_init(s_shared_mutex);
 	OSAL_RUNTIME_ASSERT(res == OSAL_E_OK);
 
+	res = osal_queue_set_init(s_shared_mutex);
+	OSAL_RUNTIME_ASSERT(res == OSAL_E_OK);
+
+	res = osal_channel_init(s_shared_mutex);
+	OSAL_RUNTIME_ASSERT(res == OSAL_E_OK);
+
+	res = osal_msgbuf_init(s_shared_mutex);
+	OSAL_RUNTIME_ASSERT(res == OSAL_E_OK);
+
+	/* memory pool initialization */
+	res = osal_mempool_init(s_shared_mutex);
+	OSAL_RUNTIME_ASSERT(res == OSAL_E_OK);
+
 	res = osal_tmcheck_init(s_shared_mutex);
 	OSAL_RUNTIME_ASSERT(res == OSAL_E_OK);
 
@@ -102,8 +123,10 @@ char *osal_version(void)
 
 void osal_print_resource(void)
 {
+	osal_mem_info_t mem_info;
 	uint32_t use;
 	uint32_t avail;
+	uint32_t i;
 
 	use = osal_mutex_use();
 	avail = osal_mutex_avail();
@@ -126,10 +149,35 @@ void osal_print_resource(void)
 	avail = osal_queue_avail();
 	OSALOG_INFO("osal: queue=%u/%u\n", use, use+avail);
 
+	use = osal_queue_set_use();
+	avail = osal_queue_set_avail();
+	OSALOG_INFO("osal: queue_set=%u/%u\n", use, use+avail);
+
+	use = osal_channel_use();
+	avail = osal_channel_avail();
+	OSALOG_INFO("osal: channel=%u/%u\n", use, use+avail);
+
+	use = osal_msgbuf_use();
+	avail = osal_msgbuf_avail();
+	OSALOG_INFO("osal: msgbuf=%u/%u\n", use, use+avail);
+
+	for (i = 0; i < OSAL_MEMPOOL_CLASS_NUM; i++) {
+		use = osal_mempool_use(i);
+		avail = osal_mempool_avail(i);
+		OSALOG_INFO("osal: mempool[%u]=%u/%u\n",
+					osal_mempool_class_size(i), use, use+avail);
+	}
+
 	use = osal_tmcheck_use();
 	avail = osal_tmcheck_avail();
 	OSALOG_INFO("osal: tmcheck=%u/%u\n", use, use+avail);
 
+	osal_mem_info(&mem_info);
+	OSALOG_INFO("osal: mem=%zu/%zu free=%zu heap=%zu%s%s\n", mem_info.used,
+				mem_info.size, mem_info.free, mem_info.heap_allocs,
+				mem_info.hugepage ? " hugepage" : "",
+				mem_info.locked ? " locked" : "");
+
 	OSALOG_INFO("osal: ---------------\n");
 }
 
@@ -138,17 +186,22 @@ void osal_deinit(void)
 	if (s_initialized == false) {
 		return;
 	}
-	OSAL_RUNTIME_ASSERT(s_shared_mutex != NULL);
-	osal_mutex_delete(s_shared_mutex);
-	s_shared_mutex = NULL;
-
 	osal_sem_deinit();
 	osal_task_deinit();
 	osal_timer_deinit();
+	osal_msgbuf_deinit();
+	osal_channel_deinit();
+	osal_queue_set_deinit();
 	osal_queue_deinit();
+	osal_mempool_deinit();
 	osal_log_deinit();
 	osal_tmcheck_deinit();
+	/* the pools above lock the shared mutex until their deinit */
+	OSAL_RUNTIME_ASSERT(s_shared_mutex != NULL);
+	osal_mutex_delete(s_shared_mutex);
+	s_shared_mutex = NULL;
 	osal_mutex_deinit();
+	osal_mem_deinit();
 
 	s_initialized = false;
 }
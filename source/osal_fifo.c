@@ -0,0 +1,107 @@
+/* BSD 2-Clause License
+*
+* Copyright (c) 2025, nguyenvannam142@gmail.com
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*
+* 1. Redistributions of source code must retain the above copyright notice, this
+*    list of conditions and the following disclaimer.
+*
+* 2. Redistributions in binary form must reproduce the above copyright notice,
+*    this list of conditions and the following disclaimer in the documentation
+*    and/or other materials provided with the distribution.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <stddef.h>
+#include "osal_fifo.h"
+
+static void fifo_link(osal_fifo_t *fifo, osal_fifo_node_t *node)
+{
+	osal_fifo_node_t *prev;
+
+	__atomic_store_n(&node->next, NULL, __ATOMIC_RELAXED);
+	prev = __atomic_exchange_n(&fifo->head, node, __ATOMIC_ACQ_REL);
+	/* the node is reachable by the consumer from here */
+	__atomic_store_n(&prev->next, node, __ATOMIC_RELEASE);
+}
+
+void osal_fifo_init(osal_fifo_t *fifo)
+{
+	fifo->stub.next = NULL;
+	fifo->head = &fifo->stub;
+	fifo->tail = &fifo->stub;
+	fifo->size = 0;
+}
+
+void osal_fifo_push(osal_fifo_t *fifo, osal_fifo_node_t *node)
+{
+	__atomic_fetch_add(&fifo->size, 1, __ATOMIC_RELAXED);
+	fifo_link(fifo, node);
+}
+
+osal_fifo_node_t *osal_fifo_pop(osal_fifo_t *fifo)
+{
+	osal_fifo_node_t *tail = fifo->tail;
+	osal_fifo_node_t *next = __atomic_load_n(&tail->next, __ATOMIC_ACQUIRE);
+
+	if (tail == &fifo->stub) {
+		if (next == NULL) {
+			return NULL;
+		}
+		fifo->tail = next;
+		tail = next;
+		next = __atomic_load_n(&tail->next, __ATOMIC_ACQUIRE);
+	}
+	if (next == NULL) {
+		if (tail != __atomic_load_n(&fifo->head, __ATOMIC_ACQUIRE)) {
+			/* a producer has swapped the head but not linked its node yet */
+			return NULL;
+		}
+		/* the tail is the last node, the stub takes its place */
+		fifo_link(fifo, &fifo->stub);
+		next = __atomic_load_n(&tail->next, __ATOMIC_ACQUIRE);
+		if (next == NULL) {
+			return NULL;
+		}
+	}
+	fifo->tail = next;
+	__atomic_fetch_sub(&fifo->size, 1, __ATOMIC_RELAXED);
+	return tail;
+}
+
+uint32_t osal_fifo_drain(osal_fifo_t *fifo, osal_fifo_node_t *nodes[], uint32_t n)
+{
+	osal_fifo_node_t *node;
+	uint32_t count;
+
+	for (count = 0; count < n; count++) {
+		node = osal_fifo_pop(fifo);
+		if (node == NULL) {
+			break;
+		}
+		nodes[count] = node;
+	}
+	return count;
+}
+
+uint32_t osal_fifo_size(osal_fifo_t *fifo)
+{
+	return __atomic_load_n(&fifo->size, __ATOMIC_RELAXED);
+}
+
+bool osal_fifo_is_empty(osal_fifo_t *fifo)
+{
+	return osal_fifo_size(fifo) == 0;
+}
@@ -58,6 +58,35 @@ osal_lifo_node_t *osal_lifo_pop(osal_lifo_t *lifo)
 	return node;
 }
 
+void osal_lifo_push_chain(osal_lifo_t *lifo, osal_lifo_node_t *first,
+						  osal_lifo_node_t *last, uint32_t n)
+{
+	last->next = lifo->head;
+	lifo->head = first;
+	lifo->size += n;
+}
+
+osal_lifo_node_t *osal_lifo_pop_n(osal_lifo_t *lifo, uint32_t n, uint32_t *popped)
+{
+	osal_lifo_node_t *first;
+	osal_lifo_node_t *last = NULL;
+	osal_lifo_node_t *node;
+	uint32_t count = 0;
+
+	first = lifo->head;
+	for (node = first; (node != NULL) && (count < n); node = node->next) {
+		last = node;
+		count++;
+	}
+	if (last != NULL) {
+		lifo->head = last->next;
+		last->next = NULL;
+		lifo->size -= count;
+	}
+	*popped = count;
+	return (count > 0) ? first : NULL;
+}
+
 uint32_t osal_lifo_size(osal_lifo_t *lifo)
 {
 	return lifo->size;
@@ -67,3 +96,136 @@ bool osal_lifo_is_empty(osal_lifo_t *lifo)
 {
 	return lifo->size == 0;
 }
+
+#define LIFO_TAG_SHIFT 32
+#define LIFO_INDEX_MASK 0xffffffffULL
+
+static uint32_t lifo_atomic_index(osal_lifo_atomic_t *lifo, osal_lifo_node_t *node)
+{
+	if (node == NULL) {
+		return 0;
+	}
+	return (uint32_t)(((uint8_t *)node - lifo->base) / lifo->stride) + 1;
+}
+
+static osal_lifo_node_t *lifo_atomic_node(osal_lifo_atomic_t *lifo, uint64_t head)
+{
+	uint32_t index = head & LIFO_INDEX_MASK;
+
+	if (index == 0) {
+		return NULL;
+	}
+	return (osal_lifo_node_t *)(lifo->base + (uint64_t)(index - 1) * lifo->stride);
+}
+
+static uint64_t lifo_atomic_head(uint64_t old, uint32_t index)
+{
+	/* every update bumps the tag so a recycled top node never matches */
+	return (((old >> LIFO_TAG_SHIFT) + 1) << LIFO_TAG_SHIFT) | index;
+}
+
+void osal_lifo_atomic_init(osal_lifo_atomic_t *lifo, osal_lifo_node_t *base,
+						   uint32_t stride)
+{
+	lifo->head = 0;
+	lifo->size = 0;
+	lifo->base = (uint8_t *)base;
+	lifo->stride = stride;
+}
+
+void osal_lifo_atomic_push(osal_lifo_atomic_t *lifo, osal_lifo_node_t *node)
+{
+	uint64_t old;
+	uint64_t new;
+	uint32_t index = lifo_atomic_index(lifo, node);
+
+	/* count first, so the size never drops below the number of nodes */
+	__atomic_fetch_add(&lifo->size, 1, __ATOMIC_RELAXED);
+	old = __atomic_load_n(&lifo->head, __ATOMIC_RELAXED);
+	do {
+		__atomic_store_n(&node->next, lifo_atomic_node(lifo, old),
+						 __ATOMIC_RELAXED);
+		new = lifo_atomic_head(old, index);
+	} while (!__atomic_compare_exchange_n(&lifo->head, &old, new, true,
+										  __ATOMIC_RELEASE, __ATOMIC_RELAXED));
+}
+
+osal_lifo_node_t *osal_lifo_atomic_pop(osal_lifo_atomic_t *lifo)
+{
+	uint64_t old;
+	uint64_t new;
+	osal_lifo_node_t *node;
+	osal_lifo_node_t *next;
+
+	old = __atomic_load_n(&lifo->head, __ATOMIC_ACQUIRE);
+	do {
+		node = lifo_atomic_node(lifo, old);
+		if (node == NULL) {
+			return NULL;
+		}
+		/* the node may be taken by another thread meanwhile, the tag in
+		 * the head makes the exchange fail in that case */
+		next = __atomic_load_n(&node->next, __ATOMIC_RELAXED);
+		new = lifo_atomic_head(old, lifo_atomic_index(lifo, next));
+	} while (!__atomic_compare_exchange_n(&lifo->head, &old, new, true,
+										  __ATOMIC_ACQUIRE, __ATOMIC_ACQUIRE));
+	__atomic_fetch_sub(&lifo->size, 1, __ATOMIC_RELAXED);
+	return node;
+}
+
+void osal_lifo_atomic_push_chain(osal_lifo_atomic_t *lifo, osal_lifo_node_t *first,
+								 osal_lifo_node_t *last, uint32_t n)
+{
+	uint64_t old;
+	uint64_t new;
+	uint32_t index = lifo_atomic_index(lifo, first);
+
+	__atomic_fetch_add(&lifo->size, n, __ATOMIC_RELAXED);
+	old = __atomic_load_n(&lifo->head, __ATOMIC_RELAXED);
+	do {
+		__atomic_store_n(&last->next, lifo_atomic_node(lifo, old),
+						 __ATOMIC_RELAXED);
+		new = lifo_atomic_head(old, index);
+	} while (!__atomic_compare_exchange_n(&lifo->head, &old, new, true,
+										  __ATOMIC_RELEASE, __ATOMIC_RELAXED));
+}
+
+osal_lifo_node_t *osal_lifo_atomic_pop_n(osal_lifo_atomic_t *lifo, uint32_t n,
+										 uint32_t *popped)
+{
+	uint64_t old;
+	uint64_t new;
+	osal_lifo_node_t *first;
+	osal_lifo_node_t *last;
+	osal_lifo_node_t *next;
+	uint32_t count;
+
+	old = __atomic_load_n(&lifo->head, __ATOMIC_ACQUIRE);
+	do {
+		first = lifo_atomic_node(lifo, old);
+		if ((first == NULL) || (n == 0)) {
+			*popped = 0;
+			return NULL;
+		}
+		/* an unchanged tag guarantees the walked chain is unchanged too */
+		last = first;
+		count = 1;
+		next = __atomic_load_n(&last->next, __ATOMIC_RELAXED);
+		while ((next != NULL) && (count < n)) {
+			last = next;
+			count++;
+			next = __atomic_load_n(&last->next, __ATOMIC_RELAXED);
+		}
+		new = lifo_atomic_head(old, lifo_atomic_index(lifo, next));
+	} while (!__atomic_compare_exchange_n(&lifo->head, &old, new, true,
+										  __ATOMIC_ACQUIRE, __ATOMIC_ACQUIRE));
+	__atomic_fetch_sub(&lifo->size, count, __ATOMIC_RELAXED);
+	__atomic_store_n(&last->next, NULL, __ATOMIC_RELAXED);
+	*popped = count;
+	return first;
+}
+
+uint32_t osal_lifo_atomic_size(osal_lifo_atomic_t *lifo)
+{
+	return __atomic_load_n(&lifo->size, __ATOMIC_RELAXED);
+}
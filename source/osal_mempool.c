@@ -0,0 +1,208 @@
+/* BSD 2-Clause License
+*
+* Copyright (c) 2025, nguyenvannam142@gmail.com
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*
+* 1. Redistributions of source code must retain the above copyright notice, this
+*    list of conditions and the following disclaimer.
+*
+* 2. Redistributions in binary form must reproduce the above copyright notice,
+*    this list of conditions and the following disclaimer in the documentation
+*    and/or other materials provided with the distribution.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <string.h>
+#include "osal.h"
+#define OSALOG_MODULE OSAL_LOG_MODULE_INDEX
+
+OSAL_STATIC_ASSERT((OSAL_MEMPOOL_SIZE_0 < OSAL_MEMPOOL_SIZE_1) &&
+				   (OSAL_MEMPOOL_SIZE_1 < OSAL_MEMPOOL_SIZE_2) &&
+				   (OSAL_MEMPOOL_SIZE_2 < OSAL_MEMPOOL_SIZE_3));
+
+typedef struct {
+	osal_rm_t rm;
+	osal_resrc_t *resrces;
+	uint8_t *base;
+	uint8_t *end;
+	uint32_t block_size;
+} mempool_class_t;
+
+typedef struct {
+	osal_resrc_t resrces0[OSAL_MEMPOOL_NUM_0];
+	osal_resrc_t resrces1[OSAL_MEMPOOL_NUM_1];
+	osal_resrc_t resrces2[OSAL_MEMPOOL_NUM_2];
+	osal_resrc_t resrces3[OSAL_MEMPOOL_NUM_3];
+	mempool_class_t classes[OSAL_MEMPOOL_CLASS_NUM];
+	bool init;
+} mempool_man_t;
+
+static mempool_man_t s_mempool_man;
+
+static const uint32_t s_mempool_sizes[OSAL_MEMPOOL_CLASS_NUM] = {
+	OSAL_MEMPOOL_SIZE_0,
+	OSAL_MEMPOOL_SIZE_1,
+	OSAL_MEMPOOL_SIZE_2,
+	OSAL_MEMPOOL_SIZE_3,
+};
+
+static const uint32_t s_mempool_nums[OSAL_MEMPOOL_CLASS_NUM] = {
+	OSAL_MEMPOOL_NUM_0,
+	OSAL_MEMPOOL_NUM_1,
+	OSAL_MEMPOOL_NUM_2,
+	OSAL_MEMPOOL_NUM_3,
+};
+
+/* the blocks live in the OSAL memory region, the resources in the BSS */
+static osal_error_t mempool_class_init(uint32_t idx, osal_resrc_t *resrces,
+									   osal_mutex_t *mutex)
+{
+	mempool_class_t *cls = &s_mempool_man.classes[idx];
+	uint32_t num = s_mempool_nums[idx];
+	osal_rm_cfg_t rmcfg = {0};
+	uint32_t i;
+
+	cls->block_size = (s_mempool_sizes[idx] + OSAL_MEMPOOL_ALIGN - 1) &
+		~(OSAL_MEMPOOL_ALIGN - 1);
+	cls->base = osal_mem_alloc((size_t)cls->block_size * num);
+	if (cls->base == NULL) {
+		return OSAL_E_RESRC;
+	}
+	cls->end = cls->base + (size_t)cls->block_size * num;
+	cls->resrces = resrces;
+	for (i = 0; i < num; i++) {
+		resrces[i].data = cls->base + (size_t)cls->block_size * i;
+	}
+	rmcfg.mutex = mutex;
+	rmcfg.n_resrces = num;
+	rmcfg.resrces = resrces;
+	rmcfg.lock = OSAL_RM_LOCK;
+	rmcfg.magazine = (OSAL_RM_MAGAZINE_SIZE > 0);
+	return osal_rm_init(&cls->rm, &rmcfg);
+}
+
+osal_error_t osal_mempool_init(osal_mutex_t *mutex)
+{
+	osal_resrc_t *resrces[OSAL_MEMPOOL_CLASS_NUM] = {
+		s_mempool_man.resrces0,
+		s_mempool_man.resrces1,
+		s_mempool_man.resrces2,
+		s_mempool_man.resrces3,
+	};
+	osal_error_t res;
+	uint32_t i;
+
+	if (s_mempool_man.init == true) {
+		return OSAL_E_OK;
+	}
+	for (i = 0; i < OSAL_MEMPOOL_CLASS_NUM; i++) {
+		res = mempool_class_init(i, resrces[i], mutex);
+		if (res != OSAL_E_OK) {
+			while (i-- > 0) {
+				osal_rm_deinit(&s_mempool_man.classes[i].rm);
+				osal_mem_free(s_mempool_man.classes[i].base);
+			}
+			return res;
+		}
+	}
+	s_mempool_man.init = true;
+
+	return OSAL_E_OK;
+}
+
+void osal_mempool_deinit(void)
+{
+	int i;
+
+	if (s_mempool_man.init == false) {
+		return;
+	}
+	for (i = 0; i < OSAL_MEMPOOL_CLASS_NUM; i++) {
+		osal_rm_deinit(&s_mempool_man.classes[i].rm);
+		osal_mem_free(s_mempool_man.classes[i].base);
+	}
+	s_mempool_man.init = false;
+}
+
+void *osal_mempool_alloc(uint32_t size)
+{
+	mempool_class_t *cls;
+	osal_resrc_t *resrc;
+	int i;
+
+	if ((s_mempool_man.init == false) || (size == 0)) {
+		return NULL;
+	}
+	for (i = 0; i < OSAL_MEMPOOL_CLASS_NUM; i++) {
+		cls = &s_mempool_man.classes[i];
+		if (size > s_mempool_sizes[i]) {
+			continue;
+		}
+		resrc = osal_rm_alloc(&cls->rm);
+		if (resrc != NULL) {
+			return resrc->data;
+		}
+	}
+	return NULL;
+}
+
+void osal_mempool_free(void *ptr)
+{
+	mempool_class_t *cls;
+	uint8_t *block = ptr;
+	uint32_t offset;
+	int i;
+
+	if ((s_mempool_man.init == false) || (ptr == NULL)) {
+		return;
+	}
+	/* the class is found from the address range of its blocks */
+	for (i = 0; i < OSAL_MEMPOOL_CLASS_NUM; i++) {
+		cls = &s_mempool_man.classes[i];
+		if ((block >= cls->base) && (block < cls->end)) {
+			offset = block - cls->base;
+			if ((offset % cls->block_size) != 0) {
+				break;
+			}
+			osal_rm_free(&cls->rm, &cls->resrces[offset / cls->block_size]);
+			return;
+		}
+	}
+	OSALOG_ERROR("Invalid mempool block %p\n", ptr);
+}
+
+uint32_t osal_mempool_class_size(uint32_t class_idx)
+{
+	if (class_idx >= OSAL_MEMPOOL_CLASS_NUM) {
+		return 0;
+	}
+	return s_mempool_sizes[class_idx];
+}
+
+uint32_t osal_mempool_use(uint32_t class_idx)
+{
+	if ((s_mempool_man.init == false) || (class_idx >= OSAL_MEMPOOL_CLASS_NUM)) {
+		return 0;
+	}
+	return osal_rm_use(&s_mempool_man.classes[class_idx].rm);
+}
+
+uint32_t osal_mempool_avail(uint32_t class_idx)
+{
+	if ((s_mempool_man.init == false) || (class_idx >= OSAL_MEMPOOL_CLASS_NUM)) {
+		return 0;
+	}
+	return osal_rm_avail(&s_mempool_man.classes[class_idx].rm);
+}
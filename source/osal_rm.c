@@ -25,122 +25,565 @@
 */
 
 #include <string.h>
+#include <pthread.h>
 #include "osal_assert.h"
 #include "osal_rm.h"
 
+#if OSAL_RM_MAGAZINE_SIZE > 0
+OSAL_STATIC_ASSERT(OSAL_RM_MAGAZINE_NUM_MAX <= 64);
+
+/* number of resources moved between a magazine and the pool at once */
+#define RM_MAGAZINE_BATCH ((OSAL_RM_MAGAZINE_SIZE + 1) / 2)
+
+typedef struct {
+	osal_rm_t *rm;
+	uint32_t gen;
+	uint32_t count;
+	osal_resrc_t *resrces[OSAL_RM_MAGAZINE_SIZE];
+} rm_magazine_t;
+
+static __thread rm_magazine_t s_magazines[OSAL_RM_MAGAZINE_NUM_MAX];
+static __thread bool s_magazine_registered;
+static pthread_once_t s_magazine_once = PTHREAD_ONCE_INIT;
+static pthread_key_t s_magazine_key;
+static uint64_t s_magazine_slots;
+static uint32_t s_magazine_gen;
+/* generation of the pool owning each magazine slot, 0 when free, so that an
+ * exiting thread checks its magazines without reaching a dead pool */
+static uint32_t s_magazine_gens[OSAL_RM_MAGAZINE_NUM_MAX];
+#endif
+
+static void rm_lock(osal_rm_t *rm)
+{
+	osal_error_t err;
+
+	if (rm->lock == OSAL_RM_LOCK_SPIN) {
+		osal_spinlock_lock(&rm->spinlock);
+	} else if (rm->mutex != NULL) {
+		err = osal_mutex_lock(rm->mutex);
+		OSAL_RUNTIME_ASSERT(err == OSAL_E_OK);
+	}
+}
+
+static void rm_unlock(osal_rm_t *rm)
+{
+	osal_error_t err;
+
+	if (rm->lock == OSAL_RM_LOCK_SPIN) {
+		osal_spinlock_unlock(&rm->spinlock);
+	} else if (rm->mutex != NULL) {
+		err = osal_mutex_unlock(rm->mutex);
+		OSAL_RUNTIME_ASSERT(err == OSAL_E_OK);
+	}
+}
+
+#define RM_HANDLE_GEN_SHIFT OSAL_HANDLE_INDEX_BITS
+#define RM_HANDLE_INDEX_MASK OSAL_HANDLE_INDEX_MAX
+
+static osal_resrc_t *rm_resrc(osal_rm_t *rm, uint32_t index)
+{
+	return (osal_resrc_t *)((uint8_t *)rm->resrces + index * rm->resrc_stride);
+}
+
+static uint32_t rm_index(osal_rm_t *rm, osal_resrc_t *resrc)
+{
+	return (uint32_t)(((uint8_t *)resrc - (uint8_t *)rm->resrces) / rm->resrc_stride);
+}
+
+/* a set bit of the bitmap is a free resource, the lowest one is taken first */
+static osal_resrc_t *rm_bitmap_pop(osal_rm_t *rm)
+{
+	uint32_t n_words = OSAL_RM_BITMAP_WORDS(rm->n_resrces);
+	uint64_t word;
+	uint32_t bit;
+	uint32_t i;
+
+	for (i = 0; i < n_words; i++) {
+		word = __atomic_load_n(&rm->bitmap[i], __ATOMIC_RELAXED);
+		while (word != 0) {
+			bit = __builtin_ctzll(word);
+			if (__atomic_compare_exchange_n(&rm->bitmap[i], &word,
+											word & ~(1ULL << bit), true,
+											__ATOMIC_ACQUIRE, __ATOMIC_RELAXED)) {
+				__atomic_fetch_sub(&rm->n_free, 1, __ATOMIC_RELAXED);
+				return rm_resrc(rm, i * 64 + bit);
+			}
+		}
+	}
+	return NULL;
+}
+
+static void rm_bitmap_push(osal_rm_t *rm, osal_resrc_t *resrc)
+{
+	uint32_t index = rm_index(rm, resrc);
+
+	__atomic_fetch_add(&rm->n_free, 1, __ATOMIC_RELAXED);
+	__atomic_fetch_or(&rm->bitmap[index / 64], 1ULL << (index % 64),
+					  __ATOMIC_RELEASE);
+}
+
+/* the pool helpers must be called with the rm lock held */
+static osal_resrc_t *rm_pool_pop(osal_rm_t *rm)
+{
+	if (rm->policy == OSAL_RM_POLICY_BITMAP) {
+		return rm_bitmap_pop(rm);
+	}
+	if (rm->lock == OSAL_RM_LOCK_LOCKFREE) {
+		return (osal_resrc_t *)osal_lifo_atomic_pop(&rm->resrc_alifo);
+	}
+	return (osal_resrc_t *)osal_lifo_pop(&rm->resrc_pool);
+}
+
+static void rm_pool_push(osal_rm_t *rm, osal_resrc_t *resrc)
+{
+	if (rm->policy == OSAL_RM_POLICY_BITMAP) {
+		rm_bitmap_push(rm, resrc);
+	} else if (rm->lock == OSAL_RM_LOCK_LOCKFREE) {
+		osal_lifo_atomic_push(&rm->resrc_alifo, &resrc->node);
+	} else {
+		osal_lifo_push(&rm->resrc_pool, &resrc->node);
+	}
+}
+
+static uint32_t rm_pool_size(osal_rm_t *rm)
+{
+	if (rm->policy == OSAL_RM_POLICY_BITMAP) {
+		return __atomic_load_n(&rm->n_free, __ATOMIC_RELAXED);
+	}
+	if (rm->lock == OSAL_RM_LOCK_LOCKFREE) {
+		return osal_lifo_atomic_size(&rm->resrc_alifo);
+	}
+	return osal_lifo_size(&rm->resrc_pool);
+}
+
+static osal_resrc_t *rm_pool_pop_n(osal_rm_t *rm, uint32_t n, uint32_t *popped)
+{
+	osal_resrc_t *first = NULL;
+	osal_resrc_t *last = NULL;
+	osal_resrc_t *resrc;
+
+	if (rm->policy == OSAL_RM_POLICY_BITMAP) {
+		/* chained in the index order */
+		for (*popped = 0; *popped < n; (*popped)++) {
+			resrc = rm_bitmap_pop(rm);
+			if (resrc == NULL) {
+				break;
+			}
+			resrc->node.next = NULL;
+			if (last == NULL) {
+				first = resrc;
+			} else {
+				last->node.next = &resrc->node;
+			}
+			last = resrc;
+		}
+		return first;
+	}
+	if (rm->lock == OSAL_RM_LOCK_LOCKFREE) {
+		return (osal_resrc_t *)osal_lifo_atomic_pop_n(&rm->resrc_alifo, n, popped);
+	}
+	return (osal_resrc_t *)osal_lifo_pop_n(&rm->resrc_pool, n, popped);
+}
+
+static void rm_pool_push_chain(osal_rm_t *rm, osal_resrc_t *first,
+							   osal_resrc_t *last, uint32_t n)
+{
+	osal_resrc_t *next;
+	uint32_t i;
+
+	if (rm->policy == OSAL_RM_POLICY_BITMAP) {
+		for (i = 0; i < n; i++) {
+			/* the resource may be taken again as soon as it is pushed */
+			next = (osal_resrc_t *)first->node.next;
+			rm_bitmap_push(rm, first);
+			first = next;
+		}
+	} else if (rm->lock == OSAL_RM_LOCK_LOCKFREE) {
+		osal_lifo_atomic_push_chain(&rm->resrc_alifo, &first->node,
+									&last->node, n);
+	} else {
+		osal_lifo_push_chain(&rm->resrc_pool, &first->node, &last->node, n);
+	}
+}
+
+/* link the resources of an array into a chain for rm_pool_push_chain() */
+static void rm_link(osal_resrc_t *resrces[], uint32_t n)
+{
+	uint32_t i;
+
+	for (i = 0; i + 1 < n; i++) {
+		resrces[i]->node.next = &resrces[i+1]->node;
+	}
+}
+
+static void rm_acquire(osal_resrc_t *resrc)
+{
+	OSAL_RUNTIME_ASSERT(resrc->used == false);
+	resrc->used = true;
+}
+
+static void rm_release(osal_resrc_t *resrc)
+{
+	osal_handle_t handle = resrc->handle;
+
+	OSAL_RUNTIME_ASSERT(resrc->used == true);
+	resrc->used = false;
+	/* a new generation invalidates the handles given out so far */
+	handle += 1U << RM_HANDLE_GEN_SHIFT;
+	if ((handle >> RM_HANDLE_GEN_SHIFT) == 0) {
+		handle += 1U << RM_HANDLE_GEN_SHIFT;
+	}
+	__atomic_store_n(&resrc->handle, handle, __ATOMIC_RELAXED);
+}
+
+#if OSAL_RM_MAGAZINE_SIZE > 0
+static void rm_magazine_drain(osal_rm_t *rm, rm_magazine_t *mag, uint32_t n)
+{
+	osal_resrc_t **resrces;
+
+	mag->count -= n;
+	resrces = &mag->resrces[mag->count];
+	rm_link(resrces, n);
+
+	rm_lock(rm);
+	rm_pool_push_chain(rm, resrces[0], resrces[n-1], n);
+	__atomic_fetch_sub(&rm->n_cached, n, __ATOMIC_RELAXED);
+	rm_unlock(rm);
+}
+
+static void rm_magazine_refill(osal_rm_t *rm, rm_magazine_t *mag)
+{
+	osal_resrc_t *resrc;
+	uint32_t popped;
+
+	rm_lock(rm);
+	resrc = rm_pool_pop_n(rm, RM_MAGAZINE_BATCH, &popped);
+	__atomic_fetch_add(&rm->n_cached, popped, __ATOMIC_RELAXED);
+	rm_unlock(rm);
+
+	for (; resrc != NULL; resrc = (osal_resrc_t *)resrc->node.next) {
+		mag->resrces[mag->count++] = resrc;
+	}
+}
+
+/* give the cached resources back when a thread exits */
+static void rm_magazine_exit(void *arg)
+{
+	rm_magazine_t *mag;
+	uint32_t i;
+
+	(void)arg;
+	for (i = 0; i < OSAL_RM_MAGAZINE_NUM_MAX; i++) {
+		mag = &s_magazines[i];
+		if ((mag->rm != NULL) && (mag->count > 0) &&
+			(mag->gen == __atomic_load_n(&s_magazine_gens[i], __ATOMIC_ACQUIRE))) {
+			rm_magazine_drain(mag->rm, mag, mag->count);
+		}
+		mag->rm = NULL;
+	}
+}
+
+static void rm_magazine_key_create(void)
+{
+	int res;
+
+	res = pthread_key_create(&s_magazine_key, rm_magazine_exit);
+	OSAL_RUNTIME_ASSERT(res == 0);
+}
+
+static rm_magazine_t *rm_magazine(osal_rm_t *rm)
+{
+	rm_magazine_t *mag;
+
+	if (rm->magazine == false) {
+		return NULL;
+	}
+	mag = &s_magazines[rm->mag_idx];
+	if ((mag->rm != rm) || (mag->gen != rm->mag_gen)) {
+		/* the content belongs to a deinitialized pool, the init of a pool
+		 * takes all of its resources back */
+		mag->rm = rm;
+		mag->gen = rm->mag_gen;
+		mag->count = 0;
+		if (s_magazine_registered == false) {
+			pthread_setspecific(s_magazine_key, s_magazines);
+			s_magazine_registered = true;
+		}
+	}
+	return mag;
+}
+
+static void rm_magazine_init(osal_rm_t *rm)
+{
+	uint64_t slots;
+	uint32_t i;
+
+	pthread_once(&s_magazine_once, rm_magazine_key_create);
+
+	slots = __atomic_load_n(&s_magazine_slots, __ATOMIC_RELAXED);
+	do {
+		for (i = 0; i < OSAL_RM_MAGAZINE_NUM_MAX; i++) {
+			if ((slots & (1ULL << i)) == 0) {
+				break;
+			}
+		}
+		if (i == OSAL_RM_MAGAZINE_NUM_MAX) {
+			/* no magazine left, the pool works without */
+			return;
+		}
+	} while (!__atomic_compare_exchange_n(&s_magazine_slots, &slots,
+										  slots | (1ULL << i), true,
+										  __ATOMIC_RELAXED, __ATOMIC_RELAXED));
+	rm->mag_idx = i;
+	do {
+		rm->mag_gen = __atomic_add_fetch(&s_magazine_gen, 1, __ATOMIC_RELAXED);
+	} while (rm->mag_gen == 0);
+	__atomic_store_n(&s_magazine_gens[i], rm->mag_gen, __ATOMIC_RELEASE);
+	rm->magazine = true;
+}
+
+static void rm_magazine_deinit(osal_rm_t *rm)
+{
+	if (rm->magazine == false) {
+		return;
+	}
+	rm->magazine = false;
+	rm->mag_gen = 0;
+	__atomic_store_n(&s_magazine_gens[rm->mag_idx], 0, __ATOMIC_RELEASE);
+	__atomic_fetch_and(&s_magazine_slots, ~(1ULL << rm->mag_idx),
+					   __ATOMIC_RELAXED);
+}
+#endif
+
 osal_error_t osal_rm_init(osal_rm_t *rm, osal_rm_cfg_t *cfg)
 {
+	osal_resrc_t *resrc;
 	uint32_t i;
 
-	if ((rm == NULL) || (cfg == NULL)) {
+	if ((rm == NULL) || (cfg == NULL) ||
+		((cfg->policy == OSAL_RM_POLICY_BITMAP) && (cfg->bitmap == NULL))) {
 		return OSAL_E_PARAM;
 	}
 	memset(rm, 0, sizeof(osal_rm_t));
 	rm->n_resrces = cfg->n_resrces;
+	rm->resrces = cfg->resrces;
+	rm->resrc_stride = cfg->resrc_stride;
+	if (rm->resrc_stride == 0) {
+		rm->resrc_stride = sizeof(osal_resrc_t);
+	}
+	rm->lock = cfg->lock;
+	rm->policy = cfg->policy;
+	if (rm->policy == OSAL_RM_POLICY_BITMAP) {
+		rm->lock = OSAL_RM_LOCK_LOCKFREE;
+		rm->bitmap = cfg->bitmap;
+		memset(rm->bitmap, 0,
+			   OSAL_RM_BITMAP_WORDS(rm->n_resrces) * sizeof(uint64_t));
+	}
 
 	osal_lifo_init(&rm->resrc_pool);
+	osal_lifo_atomic_init(&rm->resrc_alifo, &cfg->resrces->node,
+						  rm->resrc_stride);
 	for (i = 0; i < cfg->n_resrces; i++) {
-		cfg->resrces[i].used = false;
-		osal_lifo_push(&rm->resrc_pool, &cfg->resrces[i].node);
+		resrc = rm_resrc(rm, i);
+		resrc->used = false;
+		/* past OSAL_HANDLE_INDEX_MAX the handle only carries the generation */
+		resrc->handle = (1U << RM_HANDLE_GEN_SHIFT) | (i & RM_HANDLE_INDEX_MASK);
+		rm_pool_push(rm, resrc);
+	}
+	osal_spinlock_init(&rm->spinlock);
+	if (rm->lock == OSAL_RM_LOCK_MUTEX) {
+		rm->mutex = cfg->mutex;
 	}
-	rm->mutex = cfg->mutex;
+#if OSAL_RM_MAGAZINE_SIZE > 0
+	if (cfg->magazine && (rm->policy == OSAL_RM_POLICY_LIFO)) {
+		rm_magazine_init(rm);
+	}
+#endif
 
 	return OSAL_E_OK;
 }
 
 void osal_rm_deinit(osal_rm_t *rm)
 {
-	osal_error_t err;
-
 	if (rm == NULL) {
 		return;
 	}
-	if (rm->mutex != NULL) {
-		err = osal_mutex_lock(rm->mutex);
-		OSAL_RUNTIME_ASSERT(err == OSAL_E_OK);
-	}
+	rm_lock(rm);
 
+#if OSAL_RM_MAGAZINE_SIZE > 0
+	rm_magazine_deinit(rm);
+#endif
 	osal_lifo_init(&rm->resrc_pool);
-
-	if (rm->mutex != NULL) {
-		err = osal_mutex_unlock(rm->mutex);
-		OSAL_RUNTIME_ASSERT(err == OSAL_E_OK);
+	osal_lifo_atomic_init(&rm->resrc_alifo,
+						  (osal_lifo_node_t *)rm->resrc_alifo.base,
+						  rm->resrc_alifo.stride);
+	if (rm->bitmap != NULL) {
+		memset(rm->bitmap, 0,
+			   OSAL_RM_BITMAP_WORDS(rm->n_resrces) * sizeof(uint64_t));
+		rm->n_free = 0;
 	}
+	rm->n_cached = 0;
+
+	rm_unlock(rm);
 	rm->mutex = NULL;
 }
 
 osal_resrc_t *osal_rm_alloc(osal_rm_t *rm)
 {
 	osal_resrc_t *resrc = NULL;
-	osal_error_t err;
+#if OSAL_RM_MAGAZINE_SIZE > 0
+	rm_magazine_t *mag;
+#endif
 
 	if (rm == NULL) {
 		return NULL;
 	}
 
-	if (rm->mutex != NULL) {
-		err = osal_mutex_lock(rm->mutex);
-		OSAL_RUNTIME_ASSERT(err == OSAL_E_OK);
+#if OSAL_RM_MAGAZINE_SIZE > 0
+	mag = rm_magazine(rm);
+	if (mag != NULL) {
+		if (mag->count == 0) {
+			rm_magazine_refill(rm, mag);
+			if (mag->count == 0) {
+				return NULL;
+			}
+		}
+		resrc = mag->resrces[--mag->count];
+		__atomic_fetch_sub(&rm->n_cached, 1, __ATOMIC_RELAXED);
+		rm_acquire(resrc);
+		return resrc;
 	}
+#endif
+
+	rm_lock(rm);
 
-	resrc = (osal_resrc_t *)osal_lifo_pop(&rm->resrc_pool);
+	resrc = rm_pool_pop(rm);
 	if (resrc != NULL) {
-		OSAL_RUNTIME_ASSERT(resrc->used == false);
-		resrc->used = true;
+		rm_acquire(resrc);
 	}
 
-	if (rm->mutex != NULL) {
-		err = osal_mutex_unlock(rm->mutex);
-		OSAL_RUNTIME_ASSERT(err == OSAL_E_OK);
-	}
+	rm_unlock(rm);
 
 	return resrc;
 }
 
 void osal_rm_free(osal_rm_t *rm, osal_resrc_t *resrc)
 {
-	osal_error_t err;
+#if OSAL_RM_MAGAZINE_SIZE > 0
+	rm_magazine_t *mag;
+#endif
 
 	if ((rm == NULL) || (resrc == NULL)) {
 		return;
 	}
 
-	if (rm->mutex != NULL) {
-		err = osal_mutex_lock(rm->mutex);
-		OSAL_RUNTIME_ASSERT(err == OSAL_E_OK);
+#if OSAL_RM_MAGAZINE_SIZE > 0
+	mag = rm_magazine(rm);
+	if (mag != NULL) {
+		rm_release(resrc);
+		if (mag->count == OSAL_RM_MAGAZINE_SIZE) {
+			rm_magazine_drain(rm, mag, RM_MAGAZINE_BATCH);
+		}
+		mag->resrces[mag->count++] = resrc;
+		__atomic_fetch_add(&rm->n_cached, 1, __ATOMIC_RELAXED);
+		return;
 	}
+#endif
 
-	OSAL_RUNTIME_ASSERT(resrc->used == true);
-	resrc->used = false;
-	osal_lifo_push(&rm->resrc_pool, &resrc->node);
+	rm_release(resrc);
 
-	if (rm->mutex != NULL) {
-		err = osal_mutex_unlock(rm->mutex);
-		OSAL_RUNTIME_ASSERT(err == OSAL_E_OK);
+	rm_lock(rm);
+	rm_pool_push(rm, resrc);
+
+	rm_unlock(rm);
+}
+
+uint32_t osal_rm_alloc_bulk(osal_rm_t *rm, osal_resrc_t *out[], uint32_t n)
+{
+	osal_resrc_t *resrc;
+	uint32_t popped;
+	uint32_t i;
+
+	if ((rm == NULL) || (out == NULL)) {
+		return 0;
+	}
+
+	rm_lock(rm);
+	resrc = rm_pool_pop_n(rm, n, &popped);
+	rm_unlock(rm);
+
+	for (i = 0; i < popped; i++) {
+		rm_acquire(resrc);
+		out[i] = resrc;
+		resrc = (osal_resrc_t *)resrc->node.next;
+	}
+	return popped;
+}
+
+void osal_rm_free_bulk(osal_rm_t *rm, osal_resrc_t *in[], uint32_t n)
+{
+	uint32_t i;
+
+	if ((rm == NULL) || (in == NULL) || (n == 0)) {
+		return;
+	}
+
+	for (i = 0; i < n; i++) {
+		rm_release(in[i]);
+	}
+	rm_link(in, n);
+
+	rm_lock(rm);
+	rm_pool_push_chain(rm, in[0], in[n-1], n);
+	rm_unlock(rm);
+}
+
+osal_handle_t osal_rm_handle(osal_rm_t *rm, osal_resrc_t *resrc)
+{
+	if ((rm == NULL) || (resrc == NULL) || (resrc->used == false) ||
+		(rm_index(rm, resrc) > OSAL_HANDLE_INDEX_MAX)) {
+		return OSAL_HANDLE_INVALID;
 	}
+	return resrc->handle;
+}
+
+osal_resrc_t *osal_rm_resolve(osal_rm_t *rm, osal_handle_t handle)
+{
+	osal_resrc_t *resrc;
+	uint32_t index = handle & RM_HANDLE_INDEX_MASK;
+
+	if ((rm == NULL) || (index >= rm->n_resrces)) {
+		return NULL;
+	}
+	resrc = rm_resrc(rm, index);
+	/* a resource not allocated since the init still has its first handle */
+	if ((__atomic_load_n(&resrc->handle, __ATOMIC_RELAXED) != handle) ||
+		(__atomic_load_n(&resrc->used, __ATOMIC_RELAXED) == false)) {
+		return NULL;
+	}
+	return resrc;
 }
 
 uint32_t osal_rm_avail(osal_rm_t *rm)
 {
 	uint32_t avail;
-	osal_error_t err;
 
 	if (rm == NULL) {
 		return 0;
 	}
 
-	if (rm->mutex != NULL) {
-		err = osal_mutex_lock(rm->mutex);
-		OSAL_RUNTIME_ASSERT(err == OSAL_E_OK);
-	}
+	rm_lock(rm);
 
-	avail = osal_lifo_size(&rm->resrc_pool);
+	avail = rm_pool_size(rm) + __atomic_load_n(&rm->n_cached, __ATOMIC_RELAXED);
+	/* without a lock (lock-free, or no lock or mutex given) the counters
+	 * may be read while resources move between the pool and a magazine */
+	if ((rm->lock != OSAL_RM_LOCK_SPIN) && (rm->mutex == NULL) &&
+		(avail > rm->n_resrces)) {
+		avail = rm->n_resrces;
+	}
 	OSAL_RUNTIME_ASSERT(avail <= rm->n_resrces);
 
-	if (rm->mutex != NULL) {
-		err = osal_mutex_unlock(rm->mutex);
-		OSAL_RUNTIME_ASSERT(err == OSAL_E_OK);
-	}
+	rm_unlock(rm);
 
 	return avail;
 }
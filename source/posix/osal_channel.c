@@ -0,0 +1,403 @@
+/* BSD 2-Clause License
+*
+* Copyright (c) 2025, nguyenvannam142@gmail.com
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*
+* 1. Redistributions of source code must retain the above copyright notice, this
+*    list of conditions and the following disclaimer.
+*
+* 2. Redistributions in binary form must reproduce the above copyright notice,
+*    this list of conditions and the following disclaimer in the documentation
+*    and/or other materials provided with the distribution.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <string.h>
+#include "osal_channel.h"
+#include "osal_assert.h"
+#include "osal_rm.h"
+#include "osal_mem.h"
+#include "osal_futex.h"
+
+/*
+ * Broadcast ring.
+ *
+ * The publisher owns head, the number of messages published, and each
+ * subscriber owns its cursor, the next message it reads. Message n goes to
+ * slot n % qsize, whose sequence is 2n+1 while it is written and 2n+2 once
+ * written: a subscriber copies the message out and checks that the sequence
+ * did not move meanwhile, as with a seqlock. A sequence beyond the cursor
+ * means the publisher went a whole ring ahead, the subscriber then skips to
+ * the oldest message still there.
+ *
+ * With OSAL_CHANNEL_BLOCK the publisher does not go a ring ahead of the
+ * slowest cursor. The subscribers sleep on signal and the publisher on
+ * space_signal, each side only makes the wake up call when the other one
+ * announced itself in its waiters counter.
+ */
+typedef struct {
+	uint64_t seq;
+	uint32_t len;
+	uint8_t data[];
+} channel_slot_t;
+
+typedef enum {
+	CHANNEL_SUB_FREE = 0,
+	CHANNEL_SUB_INIT,
+	CHANNEL_SUB_USED,
+} channel_sub_state_t;
+
+struct osal_channel_sub {
+	uint64_t cursor __attribute__((aligned(OSAL_CACHELINE_SIZE)));
+	uint64_t dropped;
+	uint32_t state;
+	osal_channel_t *channel;
+};
+
+struct osal_channel {
+	osal_resrc_t *resrc;
+	/* read-only after create */
+	uint32_t msglen;
+	uint32_t qsize;
+	uint32_t slot_size;
+	osal_channel_policy_t policy;
+	uint8_t *slots;
+	/* publisher cache line */
+	uint64_t head __attribute__((aligned(OSAL_CACHELINE_SIZE)));
+	uint64_t min_cursor; /* slowest cursor when last read */
+	uint32_t signal __attribute__((aligned(OSAL_CACHELINE_SIZE)));
+	uint32_t waiters;
+	uint32_t space_signal;
+	uint32_t space_waiters;
+	osal_channel_sub_t subs[OSAL_CHANNEL_SUB_MAX];
+};
+
+typedef struct {
+	OSAL_RM_USEROBJMAN_DECLARE(
+		struct osal_channel,
+		OSAL_CHANNEL_NUM_MAX);
+	bool init;
+} channel_man_t;
+
+static channel_man_t s_channel_man;
+
+static channel_slot_t *channel_slot(osal_channel_t *channel, uint64_t n)
+{
+	return (channel_slot_t *)&channel->slots[(size_t)(n % channel->qsize) *
+											 channel->slot_size];
+}
+
+osal_error_t osal_channel_init(osal_mutex_t *mutex)
+{
+	if (s_channel_man.init == true) {
+		return OSAL_E_OK;
+	}
+	OSAL_RM_USEROBJMAN_INIT(&s_channel_man, OSAL_CHANNEL_NUM_MAX, mutex);
+	s_channel_man.init = true;
+
+	return OSAL_E_OK;
+}
+
+void osal_channel_deinit(void)
+{
+	if (s_channel_man.init == false) {
+		return;
+	}
+	osal_rm_deinit(&s_channel_man.rm);
+	s_channel_man.init = false;
+}
+
+osal_channel_t *osal_channel_create(osal_channel_cfg_t *cfg)
+{
+	osal_channel_t *channel;
+	osal_resrc_t *resrc;
+	uint32_t i;
+
+	if ((cfg == NULL) || (cfg->msglen == 0) || (cfg->qsize == 0) ||
+		(cfg->policy >= OSAL_CHANNEL_POLICY_MAX)) {
+		return NULL;
+	}
+	resrc = osal_rm_alloc(&s_channel_man.rm);
+	if (resrc == NULL) {
+		return NULL;
+	}
+	channel = resrc->data;
+	OSAL_RUNTIME_ASSERT(channel != NULL);
+	memset(channel, 0, sizeof(osal_channel_t));
+	channel->resrc = resrc;
+	channel->msglen = cfg->msglen;
+	channel->qsize = cfg->qsize;
+	channel->slot_size = (sizeof(channel_slot_t) + cfg->msglen + 7) & ~7U;
+	channel->policy = cfg->policy;
+	channel->slots = osal_mem_alloc((size_t)cfg->qsize * channel->slot_size);
+	if (channel->slots == NULL) {
+		osal_rm_free(&s_channel_man.rm, resrc);
+		return NULL;
+	}
+	memset(channel->slots, 0, (size_t)cfg->qsize * channel->slot_size);
+	for (i = 0; i < OSAL_CHANNEL_SUB_MAX; i++) {
+		channel->subs[i].channel = channel;
+	}
+	return channel;
+}
+
+void osal_channel_delete(osal_channel_t *channel)
+{
+	osal_resrc_t *resrc;
+
+	if ((channel == NULL) || (channel->slots == NULL)) {
+		return;
+	}
+	osal_mem_free(channel->slots);
+	resrc = channel->resrc;
+	memset(channel, 0, sizeof(osal_channel_t));
+	osal_rm_free(&s_channel_man.rm, resrc);
+}
+
+/* the cursor of the slowest subscriber, head if there is none */
+static uint64_t channel_min_cursor(osal_channel_t *channel)
+{
+	uint64_t min = channel->head;
+	uint64_t cursor;
+	uint32_t i;
+
+	for (i = 0; i < OSAL_CHANNEL_SUB_MAX; i++) {
+		if (__atomic_load_n(&channel->subs[i].state, __ATOMIC_ACQUIRE) == CHANNEL_SUB_USED) {
+			cursor = __atomic_load_n(&channel->subs[i].cursor, __ATOMIC_SEQ_CST);
+			if (cursor < min) {
+				min = cursor;
+			}
+		}
+	}
+	channel->min_cursor = min;
+	return min;
+}
+
+/* wait until every subscriber read message head - qsize */
+static osal_error_t channel_space(osal_channel_t *channel, uint32_t timeout_usec)
+{
+	uint64_t head = channel->head;
+	osal_error_t res = OSAL_E_OK;
+	uint64_t deadline;
+	uint32_t signal;
+
+	if ((head - channel->min_cursor < channel->qsize) ||
+		(head - channel_min_cursor(channel) < channel->qsize)) {
+		return OSAL_E_OK;
+	}
+	if (timeout_usec == 0) {
+		return OSAL_E_QFULL;
+	}
+	deadline = futex_deadline(timeout_usec);
+	while (res == OSAL_E_OK) {
+		__atomic_fetch_add(&channel->space_waiters, 1, __ATOMIC_SEQ_CST);
+		signal = __atomic_load_n(&channel->space_signal, __ATOMIC_SEQ_CST);
+		__atomic_thread_fence(__ATOMIC_SEQ_CST);
+		if (head - channel_min_cursor(channel) >= channel->qsize) {
+			res = futex_wait(&channel->space_signal, signal, deadline, false);
+		}
+		__atomic_fetch_sub(&channel->space_waiters, 1, __ATOMIC_RELAXED);
+		if (head - channel_min_cursor(channel) < channel->qsize) {
+			return OSAL_E_OK;
+		}
+	}
+	return res;
+}
+
+osal_error_t osal_channel_publish(osal_channel_t *channel, uint8_t *msg,
+								  uint32_t msglen, uint32_t timeout_usec)
+{
+	channel_slot_t *slot;
+	osal_error_t res;
+	uint64_t head;
+
+	if ((channel == NULL) || (channel->slots == NULL) || (msg == NULL) ||
+		(msglen == 0) || (msglen > channel->msglen)) {
+		return OSAL_E_PARAM;
+	}
+	if (channel->policy == OSAL_CHANNEL_BLOCK) {
+		res = channel_space(channel, timeout_usec);
+		if (res != OSAL_E_OK) {
+			return res;
+		}
+	}
+	head = channel->head;
+	slot = channel_slot(channel, head);
+	__atomic_store_n(&slot->seq, 2*head + 1, __ATOMIC_RELAXED);
+	/* a reader seeing any byte of the new message sees the odd sequence */
+	__atomic_thread_fence(__ATOMIC_RELEASE);
+	slot->len = msglen;
+	memcpy(slot->data, msg, msglen);
+	__atomic_store_n(&slot->seq, 2*head + 2, __ATOMIC_RELEASE);
+	__atomic_store_n(&channel->head, head + 1, __ATOMIC_RELEASE);
+
+	/* pairs with the waiters increment of the subscribers */
+	__atomic_thread_fence(__ATOMIC_SEQ_CST);
+	if (__atomic_load_n(&channel->waiters, __ATOMIC_RELAXED) != 0) {
+		__atomic_fetch_add(&channel->signal, 1, __ATOMIC_RELEASE);
+		futex_wake(&channel->signal, INT32_MAX, false);
+	}
+	return OSAL_E_OK;
+}
+
+/* move the cursor, waking up a publisher waiting for this subscriber */
+static void channel_consume(osal_channel_sub_t *sub, uint64_t cursor)
+{
+	osal_channel_t *channel = sub->channel;
+
+	__atomic_store_n(&sub->cursor, cursor, __ATOMIC_SEQ_CST);
+	if (channel->policy != OSAL_CHANNEL_BLOCK) {
+		return;
+	}
+	/* pairs with the space_waiters increment of the publisher */
+	__atomic_thread_fence(__ATOMIC_SEQ_CST);
+	if (__atomic_load_n(&channel->space_waiters, __ATOMIC_RELAXED) != 0) {
+		__atomic_fetch_add(&channel->space_signal, 1, __ATOMIC_RELEASE);
+		futex_wake(&channel->space_signal, 1, false);
+	}
+}
+
+osal_channel_sub_t *osal_channel_subscribe(osal_channel_t *channel)
+{
+	osal_channel_sub_t *sub;
+	uint32_t state;
+	uint32_t i;
+
+	if ((channel == NULL) || (channel->slots == NULL)) {
+		return NULL;
+	}
+	for (i = 0; i < OSAL_CHANNEL_SUB_MAX; i++) {
+		sub = &channel->subs[i];
+		state = CHANNEL_SUB_FREE;
+		if (__atomic_compare_exchange_n(&sub->state, &state, CHANNEL_SUB_INIT, false,
+										__ATOMIC_ACQUIRE, __ATOMIC_RELAXED)) {
+			/* a message published meanwhile is skipped as a dropped one */
+			sub->cursor = __atomic_load_n(&channel->head, __ATOMIC_ACQUIRE);
+			sub->dropped = 0;
+			__atomic_store_n(&sub->state, CHANNEL_SUB_USED, __ATOMIC_RELEASE);
+			return sub;
+		}
+	}
+	return NULL;
+}
+
+void osal_channel_unsubscribe(osal_channel_sub_t *sub)
+{
+	if ((sub == NULL) || (sub->state != CHANNEL_SUB_USED)) {
+		return;
+	}
+	__atomic_store_n(&sub->state, CHANNEL_SUB_FREE, __ATOMIC_RELEASE);
+	/* the publisher may be waiting for this cursor */
+	channel_consume(sub, sub->cursor);
+}
+
+static osal_error_t channel_wait(osal_channel_t *channel, uint64_t cursor,
+								 uint64_t deadline)
+{
+	osal_error_t res = OSAL_E_OK;
+	uint32_t signal;
+
+	__atomic_fetch_add(&channel->waiters, 1, __ATOMIC_SEQ_CST);
+	signal = __atomic_load_n(&channel->signal, __ATOMIC_SEQ_CST);
+	if (__atomic_load_n(&channel->head, __ATOMIC_SEQ_CST) <= cursor) {
+		res = futex_wait(&channel->signal, signal, deadline, false);
+	}
+	__atomic_fetch_sub(&channel->waiters, 1, __ATOMIC_RELAXED);
+	return res;
+}
+
+osal_error_t osal_channel_recv(osal_channel_sub_t *sub, uint8_t *buf, uint32_t bufsize,
+							   uint32_t *msglen, uint32_t timeout_usec)
+{
+	osal_channel_t *channel;
+	channel_slot_t *slot;
+	uint64_t deadline = 0;
+	uint64_t cursor;
+	uint64_t oldest;
+	uint64_t seq;
+	uint32_t len;
+
+	if ((sub == NULL) || (sub->state != CHANNEL_SUB_USED) ||
+		(buf == NULL) || (bufsize == 0) || (msglen == NULL)) {
+		return OSAL_E_PARAM;
+	}
+	channel = sub->channel;
+	for (;;) {
+		cursor = sub->cursor;
+		slot = channel_slot(channel, cursor);
+		seq = __atomic_load_n(&slot->seq, __ATOMIC_ACQUIRE);
+		if (seq == 2*cursor + 2) {
+			len = slot->len;
+			if (len <= bufsize) {
+				memcpy(buf, slot->data, len);
+			}
+			__atomic_thread_fence(__ATOMIC_ACQUIRE);
+			if (__atomic_load_n(&slot->seq, __ATOMIC_RELAXED) != seq) {
+				/* overwritten while copied */
+				continue;
+			}
+			if (len > bufsize) {
+				return OSAL_E_PARAM;
+			}
+			*msglen = len;
+			channel_consume(sub, cursor + 1);
+			return OSAL_E_OK;
+		}
+		if (seq > 2*cursor + 2) {
+			/* the publisher is a ring ahead, skip to the oldest message left,
+			 * or past the one being overwritten */
+			oldest = __atomic_load_n(&channel->head, __ATOMIC_ACQUIRE) - channel->qsize;
+			if (oldest <= cursor) {
+				oldest = cursor + 1;
+			}
+			sub->dropped += oldest - cursor;
+			channel_consume(sub, oldest);
+			continue;
+		}
+		if (timeout_usec == 0) {
+			return OSAL_E_TIMEOUT;
+		}
+		if (deadline == 0) {
+			deadline = futex_deadline(timeout_usec);
+		}
+		if (channel_wait(channel, cursor, deadline) == OSAL_E_TIMEOUT) {
+			return OSAL_E_TIMEOUT;
+		}
+	}
+}
+
+uint64_t osal_channel_dropped(osal_channel_sub_t *sub)
+{
+	if (sub == NULL) {
+		return 0;
+	}
+	return sub->dropped;
+}
+
+uint32_t osal_channel_use(void)
+{
+	if (s_channel_man.init == false) {
+		return 0;
+	}
+	return osal_rm_use(&s_channel_man.rm);
+}
+
+uint32_t osal_channel_avail(void)
+{
+	if (s_channel_man.init == false) {
+		return 0;
+	}
+	return osal_rm_avail(&s_channel_man.rm);
+}
@@ -0,0 +1,80 @@
+/* BSD 2-Clause License
+*
+* Copyright (c) 2025, nguyenvannam142@gmail.com
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*
+* 1. Redistributions of source code must retain the above copyright notice, this
+*    list of conditions and the following disclaimer.
+*
+* 2. Redistributions in binary form must reproduce the above copyright notice,
+*    this list of conditions and the following disclaimer in the documentation
+*    and/or other materials provided with the distribution.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+/*
+ * Futex helpers shared by the POSIX backends, not part of the public API.
+ */
+#ifndef OSAL_FUTEX_H
+#define OSAL_FUTEX_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <errno.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+#include "osal_error.h"
+#include "osal_time.h"
+
+/* the monotonic time in ns after timeout_usec */
+static inline uint64_t futex_deadline(uint32_t timeout_usec)
+{
+	uint64_t now = 0;
+
+	osal_clock_time(&now);
+	return now + (uint64_t)timeout_usec * OSAL_USEC_NSEC;
+}
+
+/* sleep while *addr is val, until the monotonic deadline in ns (0 for ever),
+ * a shared futex can be woken up from another process */
+static inline osal_error_t futex_wait(uint32_t *addr, uint32_t val,
+									  uint64_t deadline, bool shared)
+{
+	struct timespec ts;
+	int op = FUTEX_WAIT_BITSET | (shared ? 0 : FUTEX_PRIVATE_FLAG);
+	long res;
+
+	ts.tv_sec = deadline / OSAL_SEC_NSEC;
+	ts.tv_nsec = deadline % OSAL_SEC_NSEC;
+	res = syscall(SYS_futex, addr, op, val, (deadline != 0) ? &ts : NULL,
+				  NULL, FUTEX_BITSET_MATCH_ANY);
+	if ((res < 0) && (errno == ETIMEDOUT)) {
+		return OSAL_E_TIMEOUT;
+	}
+	/* woken up, interrupted or *addr was not val anymore */
+	return OSAL_E_OK;
+}
+
+/* wake up to n waiters of addr */
+static inline void futex_wake(uint32_t *addr, uint32_t n, bool shared)
+{
+	int op = FUTEX_WAKE | (shared ? 0 : FUTEX_PRIVATE_FLAG);
+
+	syscall(SYS_futex, addr, op, n, NULL, NULL, 0);
+}
+
+#endif //OSAL_FUTEX_H
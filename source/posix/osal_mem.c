@@ -0,0 +1,252 @@
+/* BSD 2-Clause License
+*
+* Copyright (c) 2025, nguyenvannam142@gmail.com
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*
+* 1. Redistributions of source code must retain the above copyright notice, this
+*    list of conditions and the following disclaimer.
+*
+* 2. Redistributions in binary form must reproduce the above copyright notice,
+*    this list of conditions and the following disclaimer in the documentation
+*    and/or other materials provided with the distribution.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include "osal_assert.h"
+#include "osal_spinlock.h"
+#include "osal_mem.h"
+
+#define MEM_HUGEPAGE_SIZE (2 * 1024 * 1024)
+
+/*
+ * The region is carved from its start, each block behind a header of
+ * OSAL_MEM_ALIGN bytes holding its size. A freed block goes to a free
+ * list and is handed out again to an allocation it fits with at most a
+ * quarter to spare, or to any allocation it fits once the region is
+ * exhausted. Blocks are neither split nor merged: the region serves
+ * objects created and deleted with the same few sizes, such as the rings
+ * of the queues, not a general purpose heap.
+ */
+typedef struct mem_block {
+	size_t size; /* bytes after the header */
+	struct mem_block *next; /* next free block */
+} mem_block_t;
+
+OSAL_STATIC_ASSERT(sizeof(mem_block_t) <= OSAL_MEM_ALIGN);
+
+typedef struct {
+	uint8_t *base;
+	size_t size;
+	size_t used;
+	size_t free;
+	size_t heap_allocs;
+	mem_block_t *free_list;
+	osal_spinlock_t lock;
+	bool hugepage;
+	bool locked;
+} mem_region_t;
+
+static mem_region_t s_mem_region;
+
+static size_t mem_round_up(size_t size, size_t align)
+{
+	return (size + align - 1) & ~(align - 1);
+}
+
+static void *mem_map(size_t size, bool hugepage, size_t *mapped)
+{
+	void *addr;
+
+#ifdef MAP_HUGETLB
+	if (hugepage) {
+		*mapped = mem_round_up(size, MEM_HUGEPAGE_SIZE);
+		addr = mmap(NULL, *mapped, PROT_READ | PROT_WRITE,
+					MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB | MAP_POPULATE,
+					-1, 0);
+		if (addr != MAP_FAILED) {
+			s_mem_region.hugepage = true;
+			return addr;
+		}
+	}
+#endif
+	/* no huge page reserved, fall back to the normal pages */
+	*mapped = mem_round_up(size, sysconf(_SC_PAGESIZE));
+	addr = mmap(NULL, *mapped, PROT_READ | PROT_WRITE,
+				MAP_PRIVATE | MAP_ANONYMOUS | MAP_POPULATE, -1, 0);
+	if (addr == MAP_FAILED) {
+		return NULL;
+	}
+#ifdef MADV_HUGEPAGE
+	if (hugepage) {
+		madvise(addr, *mapped, MADV_HUGEPAGE);
+	}
+#endif
+	return addr;
+}
+
+osal_error_t osal_mem_init(osal_mem_cfg_t *cfg)
+{
+	size_t pagesize;
+	size_t off;
+
+	if (s_mem_region.base != NULL) {
+		return OSAL_E_OK;
+	}
+	if (cfg == NULL) {
+		return OSAL_E_OK;
+	}
+	if (cfg->lock_all) {
+		if (mlockall(MCL_CURRENT | MCL_FUTURE) != 0) {
+			perror("mlockall");
+		}
+	}
+	if (cfg->size == 0) {
+		return OSAL_E_OK;
+	}
+
+	memset(&s_mem_region, 0, sizeof(s_mem_region));
+	osal_spinlock_init(&s_mem_region.lock);
+	s_mem_region.base = mem_map(cfg->size, cfg->hugepage, &s_mem_region.size);
+	if (s_mem_region.base == NULL) {
+		perror("mmap");
+		return OSAL_E_OSCALL;
+	}
+
+	/* write every page so that no fault is left for the first use */
+	pagesize = sysconf(_SC_PAGESIZE);
+	for (off = 0; off < s_mem_region.size; off += pagesize) {
+		s_mem_region.base[off] = 0;
+	}
+	if (cfg->lock || cfg->lock_all) {
+		if (mlock(s_mem_region.base, s_mem_region.size) == 0) {
+			s_mem_region.locked = true;
+		} else {
+			perror("mlock");
+		}
+	}
+	return OSAL_E_OK;
+}
+
+void osal_mem_deinit(void)
+{
+	if (s_mem_region.base != NULL) {
+		munmap(s_mem_region.base, s_mem_region.size);
+	}
+	memset(&s_mem_region, 0, sizeof(s_mem_region));
+}
+
+/* unlink the smallest free block of at least size bytes, and at most
+ * max bytes, NULL if there is none */
+static mem_block_t *mem_reuse(size_t size, size_t max)
+{
+	mem_block_t **best = NULL;
+	mem_block_t **link;
+	mem_block_t *block;
+
+	for (link = &s_mem_region.free_list; *link != NULL; link = &(*link)->next) {
+		if (((*link)->size >= size) && ((*link)->size <= max) &&
+			((best == NULL) || ((*link)->size < (*best)->size))) {
+			best = link;
+		}
+	}
+	if (best == NULL) {
+		return NULL;
+	}
+	block = *best;
+	*best = block->next;
+	s_mem_region.free -= OSAL_MEM_ALIGN + block->size;
+	return block;
+}
+
+static void *mem_region_alloc(size_t size)
+{
+	mem_block_t *block;
+
+	osal_spinlock_lock(&s_mem_region.lock);
+	block = mem_reuse(size, size + size / 4);
+	if ((block == NULL) &&
+		(s_mem_region.size - s_mem_region.used >= OSAL_MEM_ALIGN + size)) {
+		block = (mem_block_t *)(s_mem_region.base + s_mem_region.used);
+		block->size = size;
+		s_mem_region.used += OSAL_MEM_ALIGN + size;
+	}
+	if (block == NULL) {
+		/* exhausted, a bigger free block is still better than the heap */
+		block = mem_reuse(size, SIZE_MAX);
+	}
+	if (block == NULL) {
+		s_mem_region.heap_allocs++;
+	}
+	osal_spinlock_unlock(&s_mem_region.lock);
+
+	return (block != NULL) ? (uint8_t *)block + OSAL_MEM_ALIGN : NULL;
+}
+
+void *osal_mem_alloc(size_t size)
+{
+	void *ptr;
+
+	if (size == 0) {
+		return NULL;
+	}
+	size = mem_round_up(size, OSAL_MEM_ALIGN);
+	if (s_mem_region.base != NULL) {
+		ptr = mem_region_alloc(size);
+		if (ptr != NULL) {
+			return ptr;
+		}
+	}
+	if (posix_memalign(&ptr, OSAL_MEM_ALIGN, size) != 0) {
+		return NULL;
+	}
+	return ptr;
+}
+
+void osal_mem_free(void *ptr)
+{
+	uint8_t *addr = ptr;
+	mem_block_t *block;
+
+	if ((s_mem_region.base != NULL) && (addr >= s_mem_region.base) &&
+		(addr < s_mem_region.base + s_mem_region.size)) {
+		block = (mem_block_t *)(addr - OSAL_MEM_ALIGN);
+		osal_spinlock_lock(&s_mem_region.lock);
+		block->next = s_mem_region.free_list;
+		s_mem_region.free_list = block;
+		s_mem_region.free += OSAL_MEM_ALIGN + block->size;
+		osal_spinlock_unlock(&s_mem_region.lock);
+		return;
+	}
+	free(ptr);
+}
+
+void osal_mem_info(osal_mem_info_t *info)
+{
+	OSAL_RUNTIME_ASSERT(info != NULL);
+	osal_spinlock_lock(&s_mem_region.lock);
+	info->size = s_mem_region.size;
+	info->used = s_mem_region.used;
+	info->free = s_mem_region.free;
+	info->heap_allocs = s_mem_region.heap_allocs;
+	osal_spinlock_unlock(&s_mem_region.lock);
+	info->hugepage = s_mem_region.hugepage;
+	info->locked = s_mem_region.locked;
+}
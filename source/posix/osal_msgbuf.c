@@ -0,0 +1,431 @@
+/* BSD 2-Clause License
+*
+* Copyright (c) 2025, nguyenvannam142@gmail.com
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*
+* 1. Redistributions of source code must retain the above copyright notice, this
+*    list of conditions and the following disclaimer.
+*
+* 2. Redistributions in binary form must reproduce the above copyright notice,
+*    this list of conditions and the following disclaimer in the documentation
+*    and/or other materials provided with the distribution.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <string.h>
+#include "osal_msgbuf.h"
+#include "osal_assert.h"
+#include "osal_rm.h"
+#include "osal_mem.h"
+#include "osal_futex.h"
+
+/*
+ * Byte ring of length-prefixed records.
+ *
+ * The producer owns head and the consumer owns tail, both are byte offsets
+ * running freely and masked into a power of two ring, with a cached copy
+ * of the other index as in the SPSC queue. A record is an 8 byte header
+ * holding the message length, then the message padded to 8 bytes, and is
+ * always contiguous: when it does not fit before the end of the ring, the
+ * producer writes a wrap marker there and the record goes to the start,
+ * both published by the same head store. A record takes at most half the
+ * ring, so the skipped tail never keeps it from fitting in an empty ring.
+ *
+ * The consumer sleeps on signal when the ring is empty and the producer on
+ * space_signal when it is full, each side only makes the wake up call when
+ * the other one announced itself in its waiters counter.
+ */
+#define MSGBUF_WRAP UINT32_MAX
+
+typedef struct {
+	uint32_t len; /* MSGBUF_WRAP for the wrap marker */
+	uint32_t reserved;
+	uint8_t data[];
+} msgbuf_hdr_t;
+
+struct osal_msgbuf {
+	osal_resrc_t *resrc;
+	/* read-only after create */
+	uint32_t size;
+	uint32_t mask;
+	uint32_t msglen;
+	uint8_t *ring;
+	/* producer cache line */
+	uint32_t head __attribute__((aligned(OSAL_CACHELINE_SIZE)));
+	uint32_t tail_cache;
+	uint32_t wpos; /* position of the reserved record */
+	uint32_t wlen; /* reserved length, 0 if none */
+	/* consumer cache line */
+	uint32_t tail __attribute__((aligned(OSAL_CACHELINE_SIZE)));
+	uint32_t head_cache;
+	uint32_t signal __attribute__((aligned(OSAL_CACHELINE_SIZE)));
+	uint32_t waiters;
+	uint32_t space_signal;
+	uint32_t space_waiters;
+};
+
+typedef struct {
+	OSAL_RM_USEROBJMAN_DECLARE(
+		struct osal_msgbuf,
+		OSAL_MSGBUF_NUM_MAX);
+	bool init;
+} msgbuf_man_t;
+
+static msgbuf_man_t s_msgbuf_man;
+
+static uint32_t msgbuf_record(uint32_t msglen)
+{
+	return (sizeof(msgbuf_hdr_t) + msglen + 7) & ~7U;
+}
+
+static msgbuf_hdr_t *msgbuf_hdr(osal_msgbuf_t *msgbuf, uint32_t pos)
+{
+	return (msgbuf_hdr_t *)&msgbuf->ring[pos & msgbuf->mask];
+}
+
+osal_error_t osal_msgbuf_init(osal_mutex_t *mutex)
+{
+	if (s_msgbuf_man.init == true) {
+		return OSAL_E_OK;
+	}
+	OSAL_RM_USEROBJMAN_INIT(&s_msgbuf_man, OSAL_MSGBUF_NUM_MAX, mutex);
+	s_msgbuf_man.init = true;
+
+	return OSAL_E_OK;
+}
+
+void osal_msgbuf_deinit(void)
+{
+	if (s_msgbuf_man.init == false) {
+		return;
+	}
+	osal_rm_deinit(&s_msgbuf_man.rm);
+	s_msgbuf_man.init = false;
+}
+
+osal_msgbuf_t *osal_msgbuf_create(osal_msgbuf_cfg_t *cfg)
+{
+	osal_msgbuf_t *msgbuf;
+	osal_resrc_t *resrc;
+	uint32_t size = 1;
+
+	if ((cfg == NULL) || (cfg->msglen == 0) || (cfg->size == 0) ||
+		(cfg->size > (1U << 31))) {
+		return NULL;
+	}
+	while (size < cfg->size) {
+		size <<= 1;
+	}
+	if ((cfg->msglen > size / 2) || (msgbuf_record(cfg->msglen) > size / 2)) {
+		return NULL;
+	}
+	resrc = osal_rm_alloc(&s_msgbuf_man.rm);
+	if (resrc == NULL) {
+		return NULL;
+	}
+	msgbuf = resrc->data;
+	OSAL_RUNTIME_ASSERT(msgbuf != NULL);
+	memset(msgbuf, 0, sizeof(osal_msgbuf_t));
+	msgbuf->resrc = resrc;
+	msgbuf->size = size;
+	msgbuf->mask = size - 1;
+	msgbuf->msglen = cfg->msglen;
+	msgbuf->ring = osal_mem_alloc(size);
+	if (msgbuf->ring == NULL) {
+		osal_rm_free(&s_msgbuf_man.rm, resrc);
+		return NULL;
+	}
+	return msgbuf;
+}
+
+void osal_msgbuf_delete(osal_msgbuf_t *msgbuf)
+{
+	osal_resrc_t *resrc;
+
+	if ((msgbuf == NULL) || (msgbuf->ring == NULL)) {
+		return;
+	}
+	osal_mem_free(msgbuf->ring);
+	resrc = msgbuf->resrc;
+	memset(msgbuf, 0, sizeof(osal_msgbuf_t));
+	osal_rm_free(&s_msgbuf_man.rm, resrc);
+}
+
+/* find room for a record at head, or at the start of the ring when it
+ * does not fit before the end; tail_cache is up to date when there is none */
+static bool msgbuf_room(osal_msgbuf_t *msgbuf, uint32_t record, uint32_t *pos)
+{
+	uint32_t head = msgbuf->head;
+	uint32_t to_end = msgbuf->size - (head & msgbuf->mask);
+	uint32_t need = (record > to_end) ? to_end + record : record;
+
+	if (msgbuf->size - (head - msgbuf->tail_cache) < need) {
+		msgbuf->tail_cache = __atomic_load_n(&msgbuf->tail, __ATOMIC_ACQUIRE);
+		if (msgbuf->size - (head - msgbuf->tail_cache) < need) {
+			return false;
+		}
+	}
+	*pos = (record > to_end) ? head + to_end : head;
+	return true;
+}
+
+static osal_error_t msgbuf_space_wait(osal_msgbuf_t *msgbuf, uint32_t record,
+									  uint32_t timeout_usec, uint32_t *pos)
+{
+	osal_error_t res = OSAL_E_OK;
+	uint64_t deadline;
+	uint32_t signal;
+
+	if (msgbuf_room(msgbuf, record, pos)) {
+		return OSAL_E_OK;
+	}
+	if (timeout_usec == 0) {
+		return OSAL_E_QFULL;
+	}
+	deadline = futex_deadline(timeout_usec);
+	while (res == OSAL_E_OK) {
+		__atomic_fetch_add(&msgbuf->space_waiters, 1, __ATOMIC_SEQ_CST);
+		signal = __atomic_load_n(&msgbuf->space_signal, __ATOMIC_SEQ_CST);
+		__atomic_thread_fence(__ATOMIC_SEQ_CST);
+		if (!msgbuf_room(msgbuf, record, pos)) {
+			res = futex_wait(&msgbuf->space_signal, signal, deadline, false);
+		}
+		__atomic_fetch_sub(&msgbuf->space_waiters, 1, __ATOMIC_RELAXED);
+		if (msgbuf_room(msgbuf, record, pos)) {
+			return OSAL_E_OK;
+		}
+	}
+	return res;
+}
+
+/* write the header of the record at pos and hand it over to the consumer */
+static void msgbuf_publish(osal_msgbuf_t *msgbuf, uint32_t pos, uint32_t msglen)
+{
+	if (pos != msgbuf->head) {
+		msgbuf_hdr(msgbuf, msgbuf->head)->len = MSGBUF_WRAP;
+	}
+	msgbuf_hdr(msgbuf, pos)->len = msglen;
+	msgbuf->wlen = 0;
+	__atomic_store_n(&msgbuf->head, pos + msgbuf_record(msglen), __ATOMIC_RELEASE);
+
+	/* pairs with the waiters increment of the consumer */
+	__atomic_thread_fence(__ATOMIC_SEQ_CST);
+	if (__atomic_load_n(&msgbuf->waiters, __ATOMIC_RELAXED) != 0) {
+		__atomic_fetch_add(&msgbuf->signal, 1, __ATOMIC_RELEASE);
+		futex_wake(&msgbuf->signal, 1, false);
+	}
+}
+
+osal_error_t osal_msgbuf_send(osal_msgbuf_t *msgbuf, uint8_t *msg, uint32_t msglen,
+							  uint32_t timeout_usec)
+{
+	osal_error_t res;
+	uint32_t pos;
+
+	if ((msgbuf == NULL) || (msgbuf->ring == NULL) || (msg == NULL) ||
+		(msglen == 0) || (msglen > msgbuf->msglen)) {
+		return OSAL_E_PARAM;
+	}
+	res = msgbuf_space_wait(msgbuf, msgbuf_record(msglen), timeout_usec, &pos);
+	if (res != OSAL_E_OK) {
+		return res;
+	}
+	memcpy(msgbuf_hdr(msgbuf, pos)->data, msg, msglen);
+	msgbuf_publish(msgbuf, pos, msglen);
+	return OSAL_E_OK;
+}
+
+osal_error_t osal_msgbuf_reserve(osal_msgbuf_t *msgbuf, uint32_t msglen, uint8_t **ptr)
+{
+	uint32_t pos;
+
+	if ((msgbuf == NULL) || (msgbuf->ring == NULL) || (ptr == NULL) ||
+		(msglen == 0) || (msglen > msgbuf->msglen)) {
+		return OSAL_E_PARAM;
+	}
+	if (!msgbuf_room(msgbuf, msgbuf_record(msglen), &pos)) {
+		return OSAL_E_QFULL;
+	}
+	msgbuf->wpos = pos;
+	msgbuf->wlen = msglen;
+	*ptr = msgbuf_hdr(msgbuf, pos)->data;
+	return OSAL_E_OK;
+}
+
+osal_error_t osal_msgbuf_commit(osal_msgbuf_t *msgbuf, uint8_t *ptr, uint32_t msglen)
+{
+	if ((msgbuf == NULL) || (msgbuf->ring == NULL) || (msgbuf->wlen == 0) ||
+		(ptr != msgbuf_hdr(msgbuf, msgbuf->wpos)->data) ||
+		(msglen == 0) || (msglen > msgbuf->wlen)) {
+		return OSAL_E_PARAM;
+	}
+	msgbuf_publish(msgbuf, msgbuf->wpos, msglen);
+	return OSAL_E_OK;
+}
+
+/* the oldest record past a wrap marker, NULL if the ring is empty */
+static msgbuf_hdr_t *msgbuf_front(osal_msgbuf_t *msgbuf, uint32_t *pos)
+{
+	uint32_t tail = msgbuf->tail;
+	msgbuf_hdr_t *hdr;
+
+	if (tail == msgbuf->head_cache) {
+		msgbuf->head_cache = __atomic_load_n(&msgbuf->head, __ATOMIC_ACQUIRE);
+		if (tail == msgbuf->head_cache) {
+			return NULL;
+		}
+	}
+	hdr = msgbuf_hdr(msgbuf, tail);
+	if (hdr->len == MSGBUF_WRAP) {
+		tail += msgbuf->size - (tail & msgbuf->mask);
+		hdr = msgbuf_hdr(msgbuf, tail);
+	}
+	*pos = tail;
+	return hdr;
+}
+
+/* wait until the ring is not empty, head_cache is up to date then */
+static osal_error_t msgbuf_wait(osal_msgbuf_t *msgbuf, uint32_t timeout_usec,
+								msgbuf_hdr_t **hdr, uint32_t *pos)
+{
+	osal_error_t res = OSAL_E_OK;
+	uint64_t deadline;
+	uint32_t signal;
+
+	*hdr = msgbuf_front(msgbuf, pos);
+	if (*hdr != NULL) {
+		return OSAL_E_OK;
+	}
+	if (timeout_usec == 0) {
+		return OSAL_E_TIMEOUT;
+	}
+	deadline = futex_deadline(timeout_usec);
+	while (res == OSAL_E_OK) {
+		__atomic_fetch_add(&msgbuf->waiters, 1, __ATOMIC_SEQ_CST);
+		signal = __atomic_load_n(&msgbuf->signal, __ATOMIC_SEQ_CST);
+		__atomic_thread_fence(__ATOMIC_SEQ_CST);
+		*hdr = msgbuf_front(msgbuf, pos);
+		if (*hdr == NULL) {
+			res = futex_wait(&msgbuf->signal, signal, deadline, false);
+			*hdr = msgbuf_front(msgbuf, pos);
+		}
+		__atomic_fetch_sub(&msgbuf->waiters, 1, __ATOMIC_RELAXED);
+		if (*hdr != NULL) {
+			return OSAL_E_OK;
+		}
+	}
+	return res;
+}
+
+/* hand the record at pos back to the producer */
+static void msgbuf_consume(osal_msgbuf_t *msgbuf, uint32_t pos, uint32_t msglen)
+{
+	__atomic_store_n(&msgbuf->tail, pos + msgbuf_record(msglen), __ATOMIC_RELEASE);
+
+	/* pairs with the space_waiters increment of the producer */
+	__atomic_thread_fence(__ATOMIC_SEQ_CST);
+	if (__atomic_load_n(&msgbuf->space_waiters, __ATOMIC_RELAXED) != 0) {
+		__atomic_fetch_add(&msgbuf->space_signal, 1, __ATOMIC_RELEASE);
+		futex_wake(&msgbuf->space_signal, 1, false);
+	}
+}
+
+osal_error_t osal_msgbuf_recv(osal_msgbuf_t *msgbuf, uint8_t *buf, uint32_t bufsize,
+							  uint32_t *msglen, uint32_t timeout_usec)
+{
+	msgbuf_hdr_t *hdr;
+	osal_error_t res;
+	uint32_t pos;
+
+	if ((msgbuf == NULL) || (msgbuf->ring == NULL) || (buf == NULL) ||
+		(bufsize == 0) || (msglen == NULL)) {
+		return OSAL_E_PARAM;
+	}
+	res = msgbuf_wait(msgbuf, timeout_usec, &hdr, &pos);
+	if (res != OSAL_E_OK) {
+		return res;
+	}
+	if (hdr->len > bufsize) {
+		return OSAL_E_PARAM;
+	}
+	*msglen = hdr->len;
+	memcpy(buf, hdr->data, hdr->len);
+	msgbuf_consume(msgbuf, pos, hdr->len);
+	return OSAL_E_OK;
+}
+
+osal_error_t osal_msgbuf_peek(osal_msgbuf_t *msgbuf, uint8_t **ptr, uint32_t *msglen,
+							  uint32_t timeout_usec)
+{
+	msgbuf_hdr_t *hdr;
+	osal_error_t res;
+	uint32_t pos;
+
+	if ((msgbuf == NULL) || (msgbuf->ring == NULL) || (ptr == NULL) ||
+		(msglen == NULL)) {
+		return OSAL_E_PARAM;
+	}
+	res = msgbuf_wait(msgbuf, timeout_usec, &hdr, &pos);
+	if (res != OSAL_E_OK) {
+		return res;
+	}
+	*ptr = hdr->data;
+	*msglen = hdr->len;
+	return OSAL_E_OK;
+}
+
+osal_error_t osal_msgbuf_release(osal_msgbuf_t *msgbuf, uint8_t *ptr)
+{
+	msgbuf_hdr_t *hdr;
+	uint32_t pos;
+
+	if ((msgbuf == NULL) || (msgbuf->ring == NULL)) {
+		return OSAL_E_PARAM;
+	}
+	hdr = msgbuf_front(msgbuf, &pos);
+	if ((hdr == NULL) || (ptr != hdr->data)) {
+		return OSAL_E_PARAM;
+	}
+	msgbuf_consume(msgbuf, pos, hdr->len);
+	return OSAL_E_OK;
+}
+
+uint32_t osal_msgbuf_used(osal_msgbuf_t *msgbuf)
+{
+	uint32_t tail;
+
+	if ((msgbuf == NULL) || (msgbuf->ring == NULL)) {
+		return 0;
+	}
+	/* the tail is read first not to exceed the head */
+	tail = __atomic_load_n(&msgbuf->tail, __ATOMIC_ACQUIRE);
+	return __atomic_load_n(&msgbuf->head, __ATOMIC_ACQUIRE) - tail;
+}
+
+uint32_t osal_msgbuf_use(void)
+{
+	if (s_msgbuf_man.init == false) {
+		return 0;
+	}
+	return osal_rm_use(&s_msgbuf_man.rm);
+}
+
+uint32_t osal_msgbuf_avail(void)
+{
+	if (s_msgbuf_man.init == false) {
+		return 0;
+	}
+	return osal_rm_avail(&s_msgbuf_man.rm);
+}
@@ -24,13 +24,41 @@
 * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 */
 
+#include <stdio.h>
+#include <errno.h>
+#include <unistd.h>
 #include <pthread.h>
 #include "osal_rm.h"
 #include "osal_assert.h"
 #include "osal_mutex.h"
+#if OSAL_MUTEX_FUTEX
+#include "osal_spinlock.h"
+#include "osal_futex.h"
+#endif
+
+/*
+ * Futex mutex.
+ *
+ * The word is 0 when unlocked, 1 when locked and 2 when locked with
+ * sleepers. Taking a free mutex is a single compare-and-swap from 0 to 1,
+ * and releasing one without sleepers a single decrement, the kernel is only
+ * called when the word went through 2. A contended locker first polls the
+ * word for a while, the length of the poll follows the time the previous
+ * ones took to succeed, then swaps in 2 and sleeps until it swaps out a 0.
+ */
+enum {
+	MUTEX_UNLOCKED = 0,
+	MUTEX_LOCKED,
+	MUTEX_CONTENDED,
+};
 
 struct osal_mutex {
+#if OSAL_MUTEX_FUTEX
+	uint32_t word;
+	uint32_t spins; /* average poll length of the recent contended locks */
+#else
 	pthread_mutex_t pthmutex;
+#endif
 	osal_resrc_t *resrc;
 };
 
@@ -40,14 +68,29 @@ typedef struct {
 		OSAL_MUTEX_NUM_MAX);
 	/* specical case, we can not use the mutex from resource mananager because
 	 * it use the osal_mutex_create() function that can be used only after
-	 * osal_mutex_init().
+	 * osal_mutex_init(). It is not needed when the pool has its own lock.
 	 */
 	pthread_mutex_t resrc_mutex;
+	uint32_t spin_max; /* 0 on a single CPU, where the owner cannot run meanwhile */
 	bool init;
 } mutex_man_t;
 
 static mutex_man_t s_mutex_man;
 
+static void resrc_lock(void)
+{
+	if (OSAL_RM_LOCK == OSAL_RM_LOCK_MUTEX) {
+		pthread_mutex_lock(&s_mutex_man.resrc_mutex);
+	}
+}
+
+static void resrc_unlock(void)
+{
+	if (OSAL_RM_LOCK == OSAL_RM_LOCK_MUTEX) {
+		pthread_mutex_unlock(&s_mutex_man.resrc_mutex);
+	}
+}
+
 osal_error_t osal_mutex_init(void)
 {
 	if (s_mutex_man.init == true) {
@@ -56,6 +99,7 @@ osal_error_t osal_mutex_init(void)
 	OSAL_RM_USEROBJMAN_INIT(&s_mutex_man, OSAL_MUTEX_NUM_MAX, NULL);
 
 	pthread_mutex_init(&s_mutex_man.resrc_mutex, NULL);
+	s_mutex_man.spin_max = (sysconf(_SC_NPROCESSORS_ONLN) > 1) ? OSAL_MUTEX_SPIN_MAX : 0;
 
 	s_mutex_man.init = true;
 
@@ -67,16 +111,21 @@ osal_mutex_t *osal_mutex_create(void)
 	osal_resrc_t *resrc;
 	osal_mutex_t *mutex;
 
-	pthread_mutex_lock(&s_mutex_man.resrc_mutex);
+	resrc_lock();
 	resrc = osal_rm_alloc(&s_mutex_man.rm);
-	pthread_mutex_unlock(&s_mutex_man.resrc_mutex);
+	resrc_unlock();
 	if (resrc == NULL) {
 		return NULL;
 	}
 	mutex = resrc->data;
 	OSAL_RUNTIME_ASSERT(mutex != NULL);
 	mutex->resrc = resrc;
+#if OSAL_MUTEX_FUTEX
+	mutex->word = MUTEX_UNLOCKED;
+	mutex->spins = 0;
+#else
 	pthread_mutex_init(&mutex->pthmutex, NULL);
+#endif
 	return mutex;
 }
 
@@ -86,20 +135,89 @@ void osal_mutex_delete(osal_mutex_t *mutex)
 		return;
 	}
 	OSAL_RUNTIME_ASSERT(mutex->resrc != NULL);
+#if !OSAL_MUTEX_FUTEX
 	pthread_mutex_destroy(&mutex->pthmutex);
+#endif
 
-	pthread_mutex_lock(&s_mutex_man.resrc_mutex);
+	resrc_lock();
 	osal_rm_free(&s_mutex_man.rm, mutex->resrc);
-	pthread_mutex_unlock(&s_mutex_man.resrc_mutex);
+	resrc_unlock();
+}
+
+#if OSAL_MUTEX_FUTEX
+/* contended lock, c is the value the fast path found */
+static __attribute__((noinline)) void mutex_lock_slow(osal_mutex_t *mutex, uint32_t c)
+{
+	uint32_t spins = __atomic_load_n(&mutex->spins, __ATOMIC_RELAXED);
+	uint32_t limit = 2*spins + 10;
+	uint32_t i;
+
+	if (limit > s_mutex_man.spin_max) {
+		limit = s_mutex_man.spin_max;
+	}
+	/* poll while the owner runs, not once there are sleepers */
+	for (i = 0; (i < limit) && (c != MUTEX_CONTENDED); i++) {
+		if ((c == MUTEX_UNLOCKED) &&
+			__atomic_compare_exchange_n(&mutex->word, &c, MUTEX_LOCKED, false,
+										__ATOMIC_ACQUIRE, __ATOMIC_RELAXED)) {
+			__atomic_store_n(&mutex->spins, spins + ((int32_t)(i - spins) / 8),
+							 __ATOMIC_RELAXED);
+			return;
+		}
+		osal_cpu_relax();
+		c = __atomic_load_n(&mutex->word, __ATOMIC_RELAXED);
+	}
+	if (limit != 0) {
+		__atomic_store_n(&mutex->spins, spins + ((int32_t)(limit - spins) / 8),
+						 __ATOMIC_RELAXED);
+	}
+	/* whoever swaps out a 0 owns the mutex, and leaves 2 for the unlock
+	 * to wake up the next sleeper */
+	c = __atomic_exchange_n(&mutex->word, MUTEX_CONTENDED, __ATOMIC_ACQUIRE);
+	while (c != MUTEX_UNLOCKED) {
+		futex_wait(&mutex->word, MUTEX_CONTENDED, 0, false);
+		c = __atomic_exchange_n(&mutex->word, MUTEX_CONTENDED, __ATOMIC_ACQUIRE);
+	}
 }
 
 osal_error_t osal_mutex_lock(osal_mutex_t *mutex)
 {
+	uint32_t c = MUTEX_UNLOCKED;
+
 	if (mutex == NULL) {
 		return OSAL_E_PARAM;
 	}
-	/* if it fail, mean a fundamental issue occured, we will abort program */
-	if (pthread_mutex_lock(&mutex->pthmutex) < 0) {
+	if (!__atomic_compare_exchange_n(&mutex->word, &c, MUTEX_LOCKED, false,
+									 __ATOMIC_ACQUIRE, __ATOMIC_RELAXED)) {
+		mutex_lock_slow(mutex, c);
+	}
+	return OSAL_E_OK;
+}
+
+osal_error_t osal_mutex_unlock(osal_mutex_t *mutex)
+{
+	if (mutex == NULL) {
+		return OSAL_E_PARAM;
+	}
+	if (__atomic_fetch_sub(&mutex->word, 1, __ATOMIC_RELEASE) != MUTEX_LOCKED) {
+		__atomic_store_n(&mutex->word, MUTEX_UNLOCKED, __ATOMIC_RELEASE);
+		futex_wake(&mutex->word, 1, false);
+	}
+	return OSAL_E_OK;
+}
+#else
+osal_error_t osal_mutex_lock(osal_mutex_t *mutex)
+{
+	int res;
+
+	if (mutex == NULL) {
+		return OSAL_E_PARAM;
+	}
+	/* if it fail, mean a fundamental issue occured, we will abort program,
+	 * the error is returned and not set in errno */
+	res = pthread_mutex_lock(&mutex->pthmutex);
+	if (res != 0) {
+		errno = res;
 		perror("pthread_mutex_lock()");
 		OSAL_RUNTIME_ASSERT(0);
 		return OSAL_E_OSCALL;
@@ -109,17 +227,22 @@ osal_error_t osal_mutex_lock(osal_mutex_t *mutex)
 
 osal_error_t osal_mutex_unlock(osal_mutex_t *mutex)
 {
+	int res;
+
 	if (mutex == NULL) {
 		return OSAL_E_PARAM;
 	}
 	/* if it fail, mean a fundamental issue occured, we will abort program */
-	if (pthread_mutex_unlock(&mutex->pthmutex) < 0) {
+	res = pthread_mutex_unlock(&mutex->pthmutex);
+	if (res != 0) {
+		errno = res;
 		perror("pthread_mutex_unlock()");
 		OSAL_RUNTIME_ASSERT(0);
 		return OSAL_E_OSCALL;
 	}
 	return OSAL_E_OK;
 }
+#endif
 
 void osal_mutex_deinit(void)
 {
@@ -131,6 +254,28 @@ void osal_mutex_deinit(void)
 	s_mutex_man.init = false;
 }
 
+osal_handle_t osal_mutex_handle(osal_mutex_t *mutex)
+{
+	if (mutex == NULL) {
+		return OSAL_HANDLE_INVALID;
+	}
+	return osal_rm_handle(&s_mutex_man.rm, mutex->resrc);
+}
+
+osal_mutex_t *osal_mutex_resolve(osal_handle_t handle)
+{
+	osal_resrc_t *resrc;
+
+	if (s_mutex_man.init == false) {
+		return NULL;
+	}
+	resrc = osal_rm_resolve(&s_mutex_man.rm, handle);
+	if (resrc == NULL) {
+		return NULL;
+	}
+	return resrc->data;
+}
+
 uint32_t osal_mutex_use(void)
 {
 	if (s_mutex_man.init == false) {
@@ -25,41 +25,39 @@
 */
 
 #include <string.h>
-#include <time.h>
-#include <mqueue.h>
-#include <fcntl.h>           /* For O_* constants */
-#include <sys/stat.h>        /* For mode constants */
-#include <errno.h>
-#include "osal_time.h"
+#include <sched.h>
+#include <unistd.h>
 #include "osal_queue.h"
 #include "osal_assert.h"
 #include "osal_rm.h"
-#include "osal_log.h"
-#define OSALOG_MODULE OSAL_LOG_MODULE_INDEX
-
-struct osal_queue {
-	osal_resrc_t *resrc;
-	bool create;
-	char name[OSAL_QUEUE_NAME_SIZE+1];
-	uint32_t msglen;
-	mqd_t fd;
-};
+#include "osal_time.h"
+#include "osal_spinlock.h"
+#include "osal_queue_backend.h"
 
 typedef struct {
 	OSAL_RM_USEROBJMAN_DECLARE(
 		struct osal_queue,
 		OSAL_QUEUE_NUM_MAX);
 	bool init;
+	bool smp; /* a spinning receiver leaves other cores to the senders */
 } queue_man_t;
 
 static queue_man_t s_queue_man;
 
+static const queue_backend_t *s_queue_backends[OSAL_QUEUE_TYPE_MAX] = {
+	[OSAL_QUEUE_TYPE_POSIX] = &queue_mq_backend,
+	[OSAL_QUEUE_TYPE_SPSC] = &queue_spsc_backend,
+	[OSAL_QUEUE_TYPE_MPMC] = &queue_mpmc_backend,
+	[OSAL_QUEUE_TYPE_SHM] = &queue_shm_backend,
+};
+
 osal_error_t osal_queue_init(osal_mutex_t *mutex)
 {
 	if (s_queue_man.init == true) {
 		return OSAL_E_OK;
 	}
 	OSAL_RM_USEROBJMAN_INIT(&s_queue_man, OSAL_QUEUE_NUM_MAX, mutex);
+	s_queue_man.smp = sysconf(_SC_NPROCESSORS_ONLN) > 1;
 	s_queue_man.init = true;
 
 	return OSAL_E_OK;
@@ -74,17 +72,54 @@ void osal_queue_deinit(void)
 	s_queue_man.init = false;
 }
 
+/* the backend of a queue type with its overflow policy */
+static const queue_backend_t *queue_backend(osal_queue_cfg_t *cfg)
+{
+	switch (cfg->overflow) {
+	case OSAL_QUEUE_OVERFLOW_REJECT:
+		return s_queue_backends[cfg->type];
+	case OSAL_QUEUE_OVERFLOW_OVERWRITE:
+		/* a POSIX queue would drop its highest priority, not the oldest
+		 * message of the sent one */
+		if (cfg->type == OSAL_QUEUE_TYPE_POSIX) {
+			return NULL;
+		}
+		/* the sender drops from the ring as a second consumer */
+		if (cfg->type == OSAL_QUEUE_TYPE_SPSC) {
+			return &queue_mpmc_backend;
+		}
+		return s_queue_backends[cfg->type];
+	case OSAL_QUEUE_OVERFLOW_CONFLATE:
+		if (((cfg->type == OSAL_QUEUE_TYPE_SPSC) || (cfg->type == OSAL_QUEUE_TYPE_MPMC)) &&
+			(cfg->prio == false)) {
+			return &queue_conflate_backend;
+		}
+		return NULL;
+	default:
+		return NULL;
+	}
+}
+
 osal_queue_t *osal_queue_create(osal_queue_cfg_t *cfg)
 {
+	const queue_backend_t *backend;
 	osal_queue_t *queue;
 	osal_resrc_t *resrc;
-	int res = 0;
-	struct mq_attr attr;
 
 	if (cfg == NULL) {
 		return NULL;
 	}
-	if ((cfg->name[0] == 0) || (cfg->msglen == 0) || (cfg->qsize == 0)) {
+	if ((cfg->msglen == 0) || (cfg->qsize == 0) ||
+		(cfg->type >= OSAL_QUEUE_TYPE_MAX)) {
+		return NULL;
+	}
+	/* only the POSIX and shared memory queues are found by their name */
+	if (((cfg->type == OSAL_QUEUE_TYPE_POSIX) || (cfg->type == OSAL_QUEUE_TYPE_SHM)) &&
+		(cfg->name[0] == 0)) {
+		return NULL;
+	}
+	backend = queue_backend(cfg);
+	if (backend == NULL) {
 		return NULL;
 	}
 
@@ -96,104 +131,485 @@ osal_queue_t *osal_queue_create(osal_queue_cfg_t *cfg)
 	OSAL_RUNTIME_ASSERT(queue != NULL);
 	memset(queue, 0, sizeof(osal_queue_t));
 	queue->resrc = resrc;
-	snprintf(queue->name, OSAL_QUEUE_NAME_SIZE+1, "/%s", cfg->name);
+	queue->backend = backend;
 	queue->msglen = cfg->msglen;
-	memset(&attr, 0, sizeof(attr));
-	attr.mq_maxmsg = cfg->qsize;
-	attr.mq_msgsize = cfg->msglen;
-	/* Opening queue is very important and happen at the beginning.
-	 * If we can not open the queue, we should terminate the program */
-	res = mq_open(queue->name, O_CREAT|O_RDWR|O_EXCL|O_NONBLOCK, S_IRWXU, &attr);
-	if (res < 0) {
-		if (errno != EEXIST) {
-			OSALOG_ERROR("mq_open(%s):%s\n", queue->name, strerror(errno));
-			OSAL_RUNTIME_ASSERT(false);
+	queue->qsize = cfg->qsize;
+	queue->spin_usec = OSAL_QUEUE_SPIN_USEC;
+	queue->overflow = cfg->overflow;
+	if (queue->backend->create(queue, cfg) != OSAL_E_OK) {
+		osal_rm_free(&s_queue_man.rm, resrc);
+		return NULL;
+	}
+
+	return queue;
+}
+
+/* call back on crossing a watermark, after a successful send or receive */
+static void queue_watermark(osal_queue_t *queue)
+{
+	uint32_t count;
+
+	if (queue->wm_cb == NULL) {
+		return;
+	}
+	count = queue->backend->count(queue);
+	/* the exchange calls back once per crossing with concurrent callers */
+	if (count >= queue->wm_high) {
+		if (!__atomic_exchange_n(&queue->wm_above, true, __ATOMIC_ACQ_REL)) {
+			queue->wm_cb(queue, true, queue->wm_arg);
 		}
-		res = mq_open(queue->name, O_RDWR);
-		if (res < 0) {
-			OSALOG_ERROR("mq_open(%s):%s\n", queue->name, strerror(errno));
-			OSAL_RUNTIME_ASSERT(false);
+	} else if (count <= queue->wm_low) {
+		if (__atomic_exchange_n(&queue->wm_above, false, __ATOMIC_ACQ_REL)) {
+			queue->wm_cb(queue, false, queue->wm_arg);
 		}
-		OSALOG_INFO("Open existing queue: %s\n", queue->name);
-	} else {
-		OSALOG_INFO("Open new queue: %s qsize=%d msglen=%d\n",
-			   queue->name, cfg->qsize, cfg->msglen);
-		queue->create = true;
 	}
-	queue->fd = res;
+}
 
-	return queue;
+/* poll an empty queue as its receive mode says, the receive then waits for
+ * the returned part of the timeout */
+static uint32_t queue_spin(osal_queue_t *queue, uint32_t timeout_usec)
+{
+	uint64_t timeout = (uint64_t)timeout_usec * OSAL_USEC_NSEC;
+	uint64_t window;
+	uint64_t start = 0;
+	uint64_t now = 0;
+	uint32_t rest;
+
+	if ((queue->recv_mode == OSAL_QUEUE_RECV_BLOCK) || (timeout_usec == 0) ||
+		(queue->backend->count(queue) != 0)) {
+		return timeout_usec;
+	}
+	window = (queue->recv_mode == OSAL_QUEUE_RECV_POLL) ? timeout_usec :
+		((queue->spin_usec < timeout_usec) ? queue->spin_usec : timeout_usec);
+	window *= OSAL_USEC_NSEC;
+	osal_clock_time(&start);
+	now = start;
+	do {
+		if (s_queue_man.smp) {
+			osal_cpu_relax();
+		} else {
+			/* the sender needs the only core */
+			sched_yield();
+		}
+		if (queue->backend->count(queue) != 0) {
+			__atomic_fetch_add(&queue->recv_stats.spun, 1, __ATOMIC_RELAXED);
+			/* still wait if another receiver takes the message */
+			return (now - start < timeout) ?
+				(uint32_t)((timeout - (now - start)) / OSAL_USEC_NSEC) : 0;
+		}
+		osal_clock_time(&now);
+	} while (now - start < window);
+
+	if (queue->recv_mode == OSAL_QUEUE_RECV_POLL) {
+		return 0;
+	}
+	/* a window as long as the timeout leaves the receive nothing to sleep */
+	rest = (uint32_t)((timeout - window) / OSAL_USEC_NSEC);
+	if (rest != 0) {
+		__atomic_fetch_add(&queue->recv_stats.blocked, 1, __ATOMIC_RELAXED);
+	}
+	return rest;
+}
+
+/* make room in a full overwriting queue, false if the send has to fail */
+static bool queue_overwrite(osal_queue_t *queue, uint32_t prio)
+{
+	if ((queue->overflow == OSAL_QUEUE_OVERFLOW_REJECT) ||
+		(queue->backend->drop(queue, prio) != OSAL_E_OK)) {
+		return false;
+	}
+	__atomic_fetch_add(&queue->dropped, 1, __ATOMIC_RELAXED);
+	return true;
+}
+
+static osal_error_t queue_send_one(osal_queue_t *queue, uint8_t *msg, uint32_t msglen,
+								   uint32_t prio, uint32_t timeout_usec)
+{
+	osal_error_t res;
+
+	if (queue->overflow != OSAL_QUEUE_OVERFLOW_REJECT) {
+		timeout_usec = 0;
+	}
+	res = queue->backend->send(queue, msg, msglen, prio, timeout_usec);
+	/* another sender may take the room made */
+	while ((res == OSAL_E_QFULL) && queue_overwrite(queue, prio)) {
+		res = queue->backend->send(queue, msg, msglen, prio, 0);
+	}
+	return res;
+}
+
+/* account the messages sent, and the depth they left */
+static void queue_sent(osal_queue_t *queue, uint32_t n)
+{
+#if OSAL_QUEUE_STATS
+	uint32_t depth = queue->backend->count(queue);
+	uint32_t max = __atomic_load_n(&queue->stats.depth_max, __ATOMIC_RELAXED);
+
+	__atomic_fetch_add(&queue->stats.sent, n, __ATOMIC_RELAXED);
+	while ((depth > max) &&
+		   !__atomic_compare_exchange_n(&queue->stats.depth_max, &max, depth, true,
+										__ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+	}
+#else
+	(void)n;
+#endif
+	queue_watermark(queue);
+}
+
+static void queue_recvd(osal_queue_t *queue, uint32_t n)
+{
+#if OSAL_QUEUE_STATS
+	__atomic_fetch_add(&queue->stats.recvd, n, __ATOMIC_RELAXED);
+#else
+	(void)n;
+#endif
+	queue_watermark(queue);
+}
+
+/* account a send failing on a full queue */
+static void queue_rejected(osal_queue_t *queue, osal_error_t res)
+{
+#if OSAL_QUEUE_STATS
+	if ((res == OSAL_E_QFULL) || (res == OSAL_E_TIMEOUT)) {
+		__atomic_fetch_add(&queue->stats.qfull, 1, __ATOMIC_RELAXED);
+	}
+#else
+	(void)queue;
+	(void)res;
+#endif
+}
+
+#if OSAL_QUEUE_STATS
+void queue_stats_latency(osal_queue_t *queue, uint64_t stamp)
+{
+	uint64_t now = 0;
+	uint32_t bucket;
+
+	osal_clock_time(&now);
+	/* bucket i holds [2^i, 2^(i+1)) ns */
+	bucket = 63 - __builtin_clzll((now - stamp) | 1);
+	if (bucket >= OSAL_QUEUE_LATENCY_BUCKETS) {
+		bucket = OSAL_QUEUE_LATENCY_BUCKETS - 1;
+	}
+	__atomic_fetch_add(&queue->stats.latency[bucket], 1, __ATOMIC_RELAXED);
+}
+#endif
+
+static osal_error_t queue_send(osal_queue_t *queue, uint8_t *msg, uint32_t msglen,
+							   uint32_t prio, uint32_t timeout_usec)
+{
+	osal_error_t res;
+
+	if ((queue == NULL) || (queue->backend == NULL) || (msg == NULL) ||
+		(msglen == 0) || (msglen > queue->msglen) || (prio >= OSAL_QUEUE_PRIO_NUM)) {
+		return OSAL_E_PARAM;
+	}
+	res = queue_send_one(queue, msg, msglen, prio, timeout_usec);
+	if (res == OSAL_E_OK) {
+		queue_sent(queue, 1);
+	} else {
+		queue_rejected(queue, res);
+	}
+	return res;
 }
 
 osal_error_t osal_queue_send(osal_queue_t *queue, uint8_t *msg, uint32_t msglen)
 {
-	int res;
+	return queue_send(queue, msg, msglen, 0, 0);
+}
+
+osal_error_t osal_queue_send_prio(osal_queue_t *queue, uint8_t *msg,
+								  uint32_t msglen, uint32_t prio)
+{
+	return queue_send(queue, msg, msglen, prio, 0);
+}
 
-	if ((queue == NULL) || (queue->fd <= 0) || (msg == NULL) ||
+osal_error_t osal_queue_send_timed(osal_queue_t *queue, uint8_t *msg,
+								   uint32_t msglen, uint32_t timeout_usec)
+{
+	return queue_send(queue, msg, msglen, 0, timeout_usec);
+}
+
+osal_error_t osal_queue_send_keyed(osal_queue_t *queue, uint8_t *msg,
+								   uint32_t msglen, uint32_t key)
+{
+	osal_error_t res;
+
+	if ((queue == NULL) || (queue->backend == NULL) || (msg == NULL) ||
 		(msglen == 0) || (msglen > queue->msglen)) {
 		return OSAL_E_PARAM;
 	}
-	res = mq_send(queue->fd, (const char *)msg, msglen, 0);
-	if (res < 0) {
-		if (errno == EAGAIN) {
-			return OSAL_E_QFULL;
-		}
-		OSALOG_ERROR("mq_send: %s\n", strerror(errno));
-		return OSAL_E_OSCALL;
+	if (queue->backend->send_keyed == NULL) {
+		return OSAL_E_NOSUPPORT;
+	}
+	res = queue->backend->send_keyed(queue, msg, msglen, key);
+	if (res == OSAL_E_OK) {
+		queue_sent(queue, 1);
 	}
+	return res;
+}
+
+osal_error_t osal_queue_recv_mode(osal_queue_t *queue, osal_queue_recv_mode_t mode,
+								  uint32_t spin_usec)
+{
+	if ((queue == NULL) || (queue->backend == NULL) || (mode >= OSAL_QUEUE_RECV_MAX)) {
+		return OSAL_E_PARAM;
+	}
+	queue->recv_mode = mode;
+	queue->spin_usec = (spin_usec != 0) ? spin_usec : OSAL_QUEUE_SPIN_USEC;
+	return OSAL_E_OK;
+}
+
+osal_error_t osal_queue_recv_stats(osal_queue_t *queue, osal_queue_recv_stats_t *stats)
+{
+	if ((queue == NULL) || (queue->backend == NULL) || (stats == NULL)) {
+		return OSAL_E_PARAM;
+	}
+	stats->spun = __atomic_load_n(&queue->recv_stats.spun, __ATOMIC_RELAXED);
+	stats->blocked = __atomic_load_n(&queue->recv_stats.blocked, __ATOMIC_RELAXED);
+	return OSAL_E_OK;
+}
+
+osal_error_t osal_queue_stats(osal_queue_t *queue, osal_queue_stats_t *stats)
+{
+#if OSAL_QUEUE_STATS
+	uint32_t i;
+
+	if ((queue == NULL) || (queue->backend == NULL) || (stats == NULL)) {
+		return OSAL_E_PARAM;
+	}
+	/* each counter is read on its own, they may be a few messages apart */
+	stats->sent = __atomic_load_n(&queue->stats.sent, __ATOMIC_RELAXED);
+	stats->recvd = __atomic_load_n(&queue->stats.recvd, __ATOMIC_RELAXED);
+	stats->qfull = __atomic_load_n(&queue->stats.qfull, __ATOMIC_RELAXED);
+	stats->dropped = __atomic_load_n(&queue->dropped, __ATOMIC_RELAXED);
+	stats->depth = queue->backend->count(queue);
+	stats->depth_max = __atomic_load_n(&queue->stats.depth_max, __ATOMIC_RELAXED);
+	for (i = 0; i < OSAL_QUEUE_LATENCY_BUCKETS; i++) {
+		stats->latency[i] = __atomic_load_n(&queue->stats.latency[i], __ATOMIC_RELAXED);
+	}
+	return OSAL_E_OK;
+#else
+	(void)queue;
+	(void)stats;
+	return OSAL_E_NOSUPPORT;
+#endif
+}
+
+osal_error_t osal_queue_watermark(osal_queue_t *queue, uint32_t high, uint32_t low,
+								  osal_queue_watermark_cb_t cb, void *arg)
+{
+	if ((queue == NULL) || (queue->backend == NULL)) {
+		return OSAL_E_PARAM;
+	}
+	if ((cb != NULL) && ((high == 0) || (high > queue->qsize) || (low >= high))) {
+		return OSAL_E_PARAM;
+	}
+	queue->wm_high = high;
+	queue->wm_low = low;
+	queue->wm_arg = arg;
+	queue->wm_above = false;
+	queue->wm_cb = cb;
 	return OSAL_E_OK;
 }
 
 osal_error_t osal_queue_recv(osal_queue_t *queue, uint8_t *buf,
 							 uint32_t bufsize, uint32_t timeout_usec)
 {
-	int res;
-	struct timeval tvtout;
-	fd_set rfds;
+	uint32_t msglen;
+
+	return osal_queue_recv_len(queue, buf, bufsize, &msglen, timeout_usec);
+}
 
-	if ((queue == NULL) || (queue->fd <= 0) ||
-		(buf == NULL) || (bufsize == 0)) {
+osal_error_t osal_queue_recv_len(osal_queue_t *queue, uint8_t *buf, uint32_t bufsize,
+								 uint32_t *msglen, uint32_t timeout_usec)
+{
+	osal_error_t res;
+
+	if ((queue == NULL) || (queue->backend == NULL) ||
+		(buf == NULL) || (bufsize == 0) || (msglen == NULL)) {
 		return OSAL_E_PARAM;
 	}
+	timeout_usec = queue_spin(queue, timeout_usec);
+	res = queue->backend->recv(queue, buf, bufsize, msglen, timeout_usec);
+	if (res == OSAL_E_OK) {
+		queue_recvd(queue, 1);
+	}
+	return res;
+}
 
-	FD_ZERO(&rfds);
-	FD_SET(queue->fd, &rfds);
-	memset(&tvtout, 0, sizeof(tvtout));
-	tvtout.tv_sec = timeout_usec / OSAL_SEC_USEC;
-	tvtout.tv_usec = timeout_usec % OSAL_SEC_USEC;
+osal_error_t osal_queue_send_batch(osal_queue_t *queue, uint8_t *msgs[],
+								   uint32_t lens[], uint32_t n, uint32_t *sent)
+{
+	osal_error_t res = OSAL_E_OK;
+	uint32_t i;
 
-	res = select(queue->fd+1, &rfds, NULL, NULL, &tvtout);
-	if (res < 0) {
-		OSALOG_ERROR("select:%s\n", strerror(errno));
-		return OSAL_E_OSCALL;
-	} else if (res == 0) {
-		return OSAL_E_TIMEOUT;
+	if ((queue == NULL) || (queue->backend == NULL) || (msgs == NULL) ||
+		(lens == NULL) || (n == 0) || (sent == NULL)) {
+		return OSAL_E_PARAM;
 	}
-	if (FD_ISSET(queue->fd, &rfds) == false) {
-		return OSAL_E_QEMPTY;
+	for (i = 0; i < n; i++) {
+		if ((msgs[i] == NULL) || (lens[i] == 0) || (lens[i] > queue->msglen)) {
+			return OSAL_E_PARAM;
+		}
+	}
+	/* an overwriting queue makes room message by message */
+	if ((queue->backend->send_batch != NULL) &&
+		(queue->overflow == OSAL_QUEUE_OVERFLOW_REJECT)) {
+		res = queue->backend->send_batch(queue, msgs, lens, n, sent);
+	} else {
+		for (i = 0; i < n; i++) {
+			res = queue_send_one(queue, msgs[i], lens[i], 0, 0);
+			if (res != OSAL_E_OK) {
+				break;
+			}
+		}
+		*sent = i;
 	}
-	res = mq_receive(queue->fd, (char *)buf, bufsize, NULL);
-	if (res < 0) {
-		OSALOG_ERROR("mq_receive:%s", strerror(errno));
-		return OSAL_E_OSCALL;
+	if (*sent != 0) {
+		queue_sent(queue, *sent);
 	}
+	queue_rejected(queue, res);
+	return res;
+}
 
+osal_error_t osal_queue_recv_batch(osal_queue_t *queue, uint8_t *bufs[],
+								   uint32_t lens[], uint32_t bufsize, uint32_t n,
+								   uint32_t *got, uint32_t timeout_usec)
+{
+	osal_error_t res;
+	uint32_t i;
+
+	if ((queue == NULL) || (queue->backend == NULL) || (bufs == NULL) ||
+		(lens == NULL) || (bufsize == 0) || (n == 0) || (got == NULL)) {
+		return OSAL_E_PARAM;
+	}
+	timeout_usec = queue_spin(queue, timeout_usec);
+	if (queue->backend->recv_batch != NULL) {
+		res = queue->backend->recv_batch(queue, bufs, lens, bufsize, n, got,
+										 timeout_usec);
+		if (res == OSAL_E_OK) {
+			queue_recvd(queue, *got);
+		}
+		return res;
+	}
+	/* wait for the first message only, then take what is already there */
+	res = queue->backend->recv(queue, bufs[0], bufsize, &lens[0], timeout_usec);
+	if (res != OSAL_E_OK) {
+		*got = 0;
+		return res;
+	}
+	for (i = 1; i < n; i++) {
+		if (queue->backend->recv(queue, bufs[i], bufsize, &lens[i], 0) != OSAL_E_OK) {
+			break;
+		}
+	}
+	*got = i;
+	queue_recvd(queue, i);
 	return OSAL_E_OK;
 }
 
+osal_error_t osal_queue_reserve(osal_queue_t *queue, uint8_t **ptr)
+{
+	osal_error_t res;
+
+	if ((queue == NULL) || (queue->backend == NULL) || (ptr == NULL)) {
+		return OSAL_E_PARAM;
+	}
+	if (queue->backend->reserve == NULL) {
+		return OSAL_E_NOSUPPORT;
+	}
+	res = queue->backend->reserve(queue, ptr);
+	while ((res == OSAL_E_QFULL) && queue_overwrite(queue, 0)) {
+		res = queue->backend->reserve(queue, ptr);
+	}
+	queue_rejected(queue, res);
+	return res;
+}
+
+osal_error_t osal_queue_commit(osal_queue_t *queue, uint8_t *ptr, uint32_t msglen)
+{
+	osal_error_t res;
+
+	if ((queue == NULL) || (queue->backend == NULL) || (ptr == NULL) ||
+		(msglen == 0) || (msglen > queue->msglen)) {
+		return OSAL_E_PARAM;
+	}
+	if (queue->backend->commit == NULL) {
+		return OSAL_E_NOSUPPORT;
+	}
+	res = queue->backend->commit(queue, ptr, msglen);
+	if (res == OSAL_E_OK) {
+		queue_sent(queue, 1);
+	}
+	return res;
+}
+
+osal_error_t osal_queue_peek(osal_queue_t *queue, uint8_t **ptr,
+							 uint32_t *msglen, uint32_t timeout_usec)
+{
+	if ((queue == NULL) || (queue->backend == NULL) ||
+		(ptr == NULL) || (msglen == NULL)) {
+		return OSAL_E_PARAM;
+	}
+	if (queue->backend->peek == NULL) {
+		return OSAL_E_NOSUPPORT;
+	}
+	timeout_usec = queue_spin(queue, timeout_usec);
+	return queue->backend->peek(queue, ptr, msglen, timeout_usec);
+}
+
+osal_error_t osal_queue_release(osal_queue_t *queue, uint8_t *ptr)
+{
+	osal_error_t res;
+
+	if ((queue == NULL) || (queue->backend == NULL) || (ptr == NULL)) {
+		return OSAL_E_PARAM;
+	}
+	if (queue->backend->release == NULL) {
+		return OSAL_E_NOSUPPORT;
+	}
+	res = queue->backend->release(queue, ptr);
+	if (res == OSAL_E_OK) {
+		queue_recvd(queue, 1);
+	}
+	return res;
+}
+
 void osal_queue_delete(osal_queue_t *queue)
 {
-	if (queue == NULL) {
+	osal_resrc_t *resrc;
+
+	if ((queue == NULL) || (queue->backend == NULL)) {
 		return;
 	}
-	if (queue->fd > 0) {
-		mq_close(queue->fd);
+	queue_set_release(queue);
+	queue->backend->destroy(queue);
+	resrc = queue->resrc;
+	memset(queue, 0, sizeof(osal_queue_t));
+	osal_rm_free(&s_queue_man.rm, resrc);
+}
+
+osal_handle_t osal_queue_handle(osal_queue_t *queue)
+{
+	if (queue == NULL) {
+		return OSAL_HANDLE_INVALID;
 	}
-	if (queue->create) {
-		mq_unlink(queue->name);
+	return osal_rm_handle(&s_queue_man.rm, queue->resrc);
+}
+
+osal_queue_t *osal_queue_resolve(osal_handle_t handle)
+{
+	osal_resrc_t *resrc;
+
+	if (s_queue_man.init == false) {
+		return NULL;
 	}
-	memset(queue, 0, sizeof(osal_queue_t));
-	osal_rm_free(&s_queue_man.rm, queue->resrc);
+	resrc = osal_rm_resolve(&s_queue_man.rm, handle);
+	if (resrc == NULL) {
+		return NULL;
+	}
+	return resrc->data;
 }
 
 uint32_t osal_queue_use(void)
@@ -0,0 +1,138 @@
+/* BSD 2-Clause License
+*
+* Copyright (c) 2025, nguyenvannam142@gmail.com
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*
+* 1. Redistributions of source code must retain the above copyright notice, this
+*    list of conditions and the following disclaimer.
+*
+* 2. Redistributions in binary form must reproduce the above copyright notice,
+*    this list of conditions and the following disclaimer in the documentation
+*    and/or other materials provided with the distribution.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+/*
+ * Queue backends, not part of the public API.
+ *
+ * osal_queue.c owns the queue objects and dispatches each call to the
+ * backend selected by osal_queue_cfg_t.type.
+ */
+#ifndef OSAL_QUEUE_BACKEND_H
+#define OSAL_QUEUE_BACKEND_H
+
+#include <stdbool.h>
+#include <mqueue.h>
+#include "osal_queue.h"
+#include "osal_rm.h"
+#include "osal_time.h"
+
+typedef struct {
+	osal_error_t (*create)(osal_queue_t *queue, osal_queue_cfg_t *cfg);
+	void (*destroy)(osal_queue_t *queue);
+	/* waits up to timeout_usec for a free slot, OSAL_E_QFULL at once for 0 */
+	osal_error_t (*send)(osal_queue_t *queue, uint8_t *msg, uint32_t msglen,
+						 uint32_t prio, uint32_t timeout_usec);
+	osal_error_t (*recv)(osal_queue_t *queue, uint8_t *buf, uint32_t bufsize,
+						 uint32_t *msglen, uint32_t timeout_usec);
+	/* batches published with a single wake up, NULL to loop on send/recv */
+	osal_error_t (*send_batch)(osal_queue_t *queue, uint8_t *msgs[], uint32_t lens[],
+							   uint32_t n, uint32_t *sent);
+	osal_error_t (*recv_batch)(osal_queue_t *queue, uint8_t *bufs[], uint32_t lens[],
+							   uint32_t bufsize, uint32_t n, uint32_t *got,
+							   uint32_t timeout_usec);
+	/* zero-copy access to the slots, NULL if not supported */
+	osal_error_t (*reserve)(osal_queue_t *queue, uint8_t **ptr);
+	osal_error_t (*commit)(osal_queue_t *queue, uint8_t *ptr, uint32_t msglen);
+	osal_error_t (*peek)(osal_queue_t *queue, uint8_t **ptr, uint32_t *msglen,
+						 uint32_t timeout_usec);
+	osal_error_t (*release)(osal_queue_t *queue, uint8_t *ptr);
+	/* number of messages in the queue, for the watermarks */
+	uint32_t (*count)(osal_queue_t *queue);
+	/* drop the next message a receiver of prio would get, for the
+	 * overwriting queues */
+	osal_error_t (*drop)(osal_queue_t *queue, uint32_t prio);
+	/* send replacing the pending message of key, NULL if not supported */
+	osal_error_t (*send_keyed)(osal_queue_t *queue, uint8_t *msg, uint32_t msglen,
+							   uint32_t key);
+	/* the fd a wait set polls for the queue, NULL if it cannot be in a set */
+	int (*set_fd)(osal_queue_t *queue);
+	/* add delta set waiters and tell if a message is there, NULL when the
+	 * fd of set_fd is readable by itself */
+	bool (*set_arm)(osal_queue_t *queue, int32_t delta);
+} queue_backend_t;
+
+struct osal_queue {
+	osal_resrc_t *resrc;
+	const queue_backend_t *backend;
+	bool create;
+	char name[OSAL_QUEUE_NAME_SIZE+1];
+	uint32_t msglen;
+	uint32_t qsize;
+	mqd_t fd; /* POSIX message queue */
+	void *ring; /* ring of the in-process and shared memory backends */
+	size_t ring_size; /* size of the shared memory mapping */
+	struct osal_queue_set *set; /* wait set holding the queue */
+	int efd; /* eventfd of a ring in a wait set */
+	bool set_ready; /* readable as reported by the wait set */
+	osal_queue_watermark_cb_t wm_cb; /* watermark callback, NULL if none */
+	void *wm_arg;
+	uint32_t wm_high;
+	uint32_t wm_low;
+	bool wm_above; /* the high watermark was reached and not the low one since */
+	osal_queue_recv_mode_t recv_mode;
+	uint32_t spin_usec;
+	osal_queue_recv_stats_t recv_stats;
+	osal_queue_overflow_t overflow;
+	uint64_t dropped; /* messages overwritten or replaced */
+#if OSAL_QUEUE_STATS
+	struct {
+		uint64_t sent;
+		uint64_t recvd;
+		uint64_t qfull;
+		uint32_t depth_max;
+		uint64_t latency[OSAL_QUEUE_LATENCY_BUCKETS];
+	} stats;
+#endif
+};
+
+extern const queue_backend_t queue_mq_backend;
+extern const queue_backend_t queue_spsc_backend;
+extern const queue_backend_t queue_mpmc_backend;
+extern const queue_backend_t queue_shm_backend;
+extern const queue_backend_t queue_conflate_backend;
+
+/* eventfd of a ring in a wait set, created on the first call */
+int queue_set_eventfd(osal_queue_t *queue);
+/* wake up the wait set of a ring, called when the ring has waiters */
+void queue_set_notify(osal_queue_t *queue);
+/* remove a deleted queue from its set and close its eventfd */
+void queue_set_release(osal_queue_t *queue);
+
+#if OSAL_QUEUE_STATS
+/* send time stored in the slot header of a ring message */
+static inline uint64_t queue_stats_stamp(void)
+{
+	uint64_t now = 0;
+
+	osal_clock_time(&now);
+	return now;
+}
+
+/* record the dwell time of a message stamped at send */
+void queue_stats_latency(osal_queue_t *queue, uint64_t stamp);
+#endif
+
+#endif //OSAL_QUEUE_BACKEND_H
@@ -0,0 +1,267 @@
+/* BSD 2-Clause License
+*
+* Copyright (c) 2025, nguyenvannam142@gmail.com
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*
+* 1. Redistributions of source code must retain the above copyright notice, this
+*    list of conditions and the following disclaimer.
+*
+* 2. Redistributions in binary form must reproduce the above copyright notice,
+*    this list of conditions and the following disclaimer in the documentation
+*    and/or other materials provided with the distribution.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <stdio.h>
+#include <string.h>
+#include "osal_mem.h"
+#include "osal_spinlock.h"
+#include "osal_futex.h"
+#include "osal_queue_backend.h"
+
+/*
+ * Conflating queue.
+ *
+ * The pending messages sit in a ring in the order they were sent, each
+ * with the key it was sent with. A keyed send looks for a pending message
+ * of its key and copies the new one over it, so it keeps its place, and a
+ * send on a full ring drops the oldest message. Finding a key is a scan of
+ * the pending messages, all of it runs under a spinlock held for a copy,
+ * which suits the small state updates such a queue is meant for.
+ *
+ * The receivers sleep on the signal futex as with the other rings.
+ */
+typedef struct {
+#if OSAL_QUEUE_STATS
+	uint64_t stamp; /* send time */
+#endif
+	uint32_t keyed;
+	uint32_t key;
+	uint32_t len;
+	uint8_t data[];
+} conflate_slot_t;
+
+typedef struct {
+	osal_spinlock_t lock;
+	uint32_t head; /* oldest pending message */
+	uint32_t count;
+	uint32_t signal __attribute__((aligned(OSAL_CACHELINE_SIZE)));
+	uint32_t waiters;
+	/* read-only after create */
+	uint32_t qsize __attribute__((aligned(OSAL_CACHELINE_SIZE)));
+	uint32_t slot_size;
+	uint8_t slots[] __attribute__((aligned(OSAL_CACHELINE_SIZE)));
+} conflate_ring_t;
+
+static conflate_slot_t *conflate_slot(conflate_ring_t *ring, uint32_t n)
+{
+	return (conflate_slot_t *)&ring->slots[(size_t)((ring->head + n) % ring->qsize) *
+										   ring->slot_size];
+}
+
+static osal_error_t queue_conflate_create(osal_queue_t *queue, osal_queue_cfg_t *cfg)
+{
+	conflate_ring_t *ring;
+	uint32_t slot_size;
+
+	slot_size = (sizeof(conflate_slot_t) + cfg->msglen + 7) & ~7U;
+	ring = osal_mem_alloc(sizeof(conflate_ring_t) + (size_t)cfg->qsize * slot_size);
+	if (ring == NULL) {
+		return OSAL_E_RESRC;
+	}
+	memset(ring, 0, sizeof(conflate_ring_t));
+	osal_spinlock_init(&ring->lock);
+	ring->qsize = cfg->qsize;
+	ring->slot_size = slot_size;
+	snprintf(queue->name, OSAL_QUEUE_NAME_SIZE+1, "%s", cfg->name);
+	queue->ring = ring;
+	return OSAL_E_OK;
+}
+
+static void queue_conflate_destroy(osal_queue_t *queue)
+{
+	osal_mem_free(queue->ring);
+}
+
+static void conflate_notify(osal_queue_t *queue)
+{
+	conflate_ring_t *ring = queue->ring;
+
+	/* pairs with the waiters increment of the receivers */
+	__atomic_thread_fence(__ATOMIC_SEQ_CST);
+	if (__atomic_load_n(&ring->waiters, __ATOMIC_RELAXED) != 0) {
+		__atomic_fetch_add(&ring->signal, 1, __ATOMIC_RELEASE);
+		futex_wake(&ring->signal, 1, false);
+		queue_set_notify(queue);
+	}
+}
+
+/* the pending message of key, NULL if there is none */
+static conflate_slot_t *conflate_find(conflate_ring_t *ring, uint32_t key)
+{
+	conflate_slot_t *slot;
+	uint32_t i;
+
+	for (i = 0; i < ring->count; i++) {
+		slot = conflate_slot(ring, i);
+		if (slot->keyed && (slot->key == key)) {
+			return slot;
+		}
+	}
+	return NULL;
+}
+
+static void conflate_put(osal_queue_t *queue, uint8_t *msg, uint32_t msglen,
+						 bool keyed, uint32_t key)
+{
+	conflate_ring_t *ring = queue->ring;
+	conflate_slot_t *slot;
+#if OSAL_QUEUE_STATS
+	uint64_t stamp = queue_stats_stamp();
+#endif
+
+	osal_spinlock_lock(&ring->lock);
+	slot = keyed ? conflate_find(ring, key) : NULL;
+	if (slot == NULL) {
+		if (ring->count == ring->qsize) {
+			/* overwrite the oldest */
+			ring->head = (ring->head + 1) % ring->qsize;
+			__atomic_store_n(&ring->count, ring->count - 1, __ATOMIC_RELAXED);
+			__atomic_fetch_add(&queue->dropped, 1, __ATOMIC_RELAXED);
+		}
+		slot = conflate_slot(ring, ring->count);
+		__atomic_store_n(&ring->count, ring->count + 1, __ATOMIC_SEQ_CST);
+	} else {
+		__atomic_fetch_add(&queue->dropped, 1, __ATOMIC_RELAXED);
+	}
+	slot->keyed = keyed;
+	slot->key = key;
+	slot->len = msglen;
+#if OSAL_QUEUE_STATS
+	slot->stamp = stamp;
+#endif
+	memcpy(slot->data, msg, msglen);
+	osal_spinlock_unlock(&ring->lock);
+
+	conflate_notify(queue);
+}
+
+static osal_error_t queue_conflate_send(osal_queue_t *queue, uint8_t *msg,
+										uint32_t msglen, uint32_t prio,
+										uint32_t timeout_usec)
+{
+	(void)timeout_usec;
+
+	if (prio != 0) {
+		return OSAL_E_NOSUPPORT;
+	}
+	conflate_put(queue, msg, msglen, false, 0);
+	return OSAL_E_OK;
+}
+
+static osal_error_t queue_conflate_send_keyed(osal_queue_t *queue, uint8_t *msg,
+											  uint32_t msglen, uint32_t key)
+{
+	conflate_put(queue, msg, msglen, true, key);
+	return OSAL_E_OK;
+}
+
+/* take the oldest message, OSAL_E_QEMPTY if there is none */
+static osal_error_t conflate_take(osal_queue_t *queue, uint8_t *buf, uint32_t bufsize,
+								  uint32_t *msglen)
+{
+	conflate_ring_t *ring = queue->ring;
+	osal_error_t res = OSAL_E_QEMPTY;
+	conflate_slot_t *slot;
+
+	osal_spinlock_lock(&ring->lock);
+	if (ring->count != 0) {
+		slot = conflate_slot(ring, 0);
+		if (slot->len > bufsize) {
+			res = OSAL_E_PARAM;
+		} else {
+			*msglen = slot->len;
+			memcpy(buf, slot->data, slot->len);
+#if OSAL_QUEUE_STATS
+			queue_stats_latency(queue, slot->stamp);
+#endif
+			ring->head = (ring->head + 1) % ring->qsize;
+			__atomic_store_n(&ring->count, ring->count - 1, __ATOMIC_RELAXED);
+			res = OSAL_E_OK;
+		}
+	}
+	osal_spinlock_unlock(&ring->lock);
+	return res;
+}
+
+static osal_error_t queue_conflate_recv(osal_queue_t *queue, uint8_t *buf,
+										uint32_t bufsize, uint32_t *msglen,
+										uint32_t timeout_usec)
+{
+	conflate_ring_t *ring = queue->ring;
+	osal_error_t res;
+	uint64_t deadline = 0;
+	uint32_t signal;
+
+	for (;;) {
+		res = conflate_take(queue, buf, bufsize, msglen);
+		if (res != OSAL_E_QEMPTY) {
+			return res;
+		}
+		if (timeout_usec == 0) {
+			return OSAL_E_TIMEOUT;
+		}
+		if (deadline == 0) {
+			deadline = futex_deadline(timeout_usec);
+		}
+		__atomic_fetch_add(&ring->waiters, 1, __ATOMIC_SEQ_CST);
+		signal = __atomic_load_n(&ring->signal, __ATOMIC_SEQ_CST);
+		if (__atomic_load_n(&ring->count, __ATOMIC_SEQ_CST) == 0) {
+			res = futex_wait(&ring->signal, signal, deadline, false);
+		}
+		__atomic_fetch_sub(&ring->waiters, 1, __ATOMIC_RELAXED);
+		if (res == OSAL_E_TIMEOUT) {
+			res = conflate_take(queue, buf, bufsize, msglen);
+			return (res == OSAL_E_QEMPTY) ? OSAL_E_TIMEOUT : res;
+		}
+	}
+}
+
+static uint32_t queue_conflate_count(osal_queue_t *queue)
+{
+	conflate_ring_t *ring = queue->ring;
+
+	return __atomic_load_n(&ring->count, __ATOMIC_RELAXED);
+}
+
+static bool queue_conflate_set_arm(osal_queue_t *queue, int32_t delta)
+{
+	conflate_ring_t *ring = queue->ring;
+
+	/* pairs with the fence of conflate_notify */
+	__atomic_fetch_add(&ring->waiters, delta, __ATOMIC_SEQ_CST);
+	return __atomic_load_n(&ring->count, __ATOMIC_SEQ_CST) != 0;
+}
+
+const queue_backend_t queue_conflate_backend = {
+	.create = queue_conflate_create,
+	.destroy = queue_conflate_destroy,
+	.send = queue_conflate_send,
+	.recv = queue_conflate_recv,
+	.count = queue_conflate_count,
+	.send_keyed = queue_conflate_send_keyed,
+	.set_fd = queue_set_eventfd,
+	.set_arm = queue_conflate_set_arm,
+};
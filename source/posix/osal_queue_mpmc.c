@@ -0,0 +1,738 @@
+/* BSD 2-Clause License
+*
+* Copyright (c) 2025, nguyenvannam142@gmail.com
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*
+* 1. Redistributions of source code must retain the above copyright notice, this
+*    list of conditions and the following disclaimer.
+*
+* 2. Redistributions in binary form must reproduce the above copyright notice,
+*    this list of conditions and the following disclaimer in the documentation
+*    and/or other materials provided with the distribution.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <stdio.h>
+#include <stddef.h>
+#include <string.h>
+#include <errno.h>
+#include <sched.h>
+#include <fcntl.h>           /* For O_* constants */
+#include <sys/mman.h>
+#include <sys/stat.h>        /* For mode constants */
+#include "osal_mem.h"
+#include "osal_log.h"
+#include "osal_futex.h"
+#include "osal_queue_backend.h"
+#define OSALOG_MODULE OSAL_LOG_MODULE_INDEX
+
+/* the creator of a shared ring sets ready once the slots are initialized */
+#define MPMC_RING_READY 0x6f73616cU
+/* with a single slot, a freed slot has the sequence pos+1 of a claimed one
+ * and a stale release could not be told apart */
+#define MPMC_QSIZE_MIN 2
+/* how long an attacher waits for the creator to initialize the ring */
+#define MPMC_ATTACH_TIMEOUT_USEC OSAL_SEC_USEC
+
+/*
+ * Bounded multi-producer multi-consumer ring.
+ *
+ * Each slot carries a sequence number telling whose turn it is: a slot of
+ * position pos is free for the sender of pos when its sequence is pos, and
+ * holds the message of pos for the receiver when it is pos+1. The senders
+ * and the receivers claim a position with a compare-and-swap on their own
+ * cursor, the sequence then hands the slot over without any lock. The
+ * positions are 64-bit so that they never wrap whatever the queue size.
+ *
+ * The receivers sleep on the signal futex when the ring is empty, a sender
+ * bumps it and makes the wake up call only when a receiver is waiting.
+ *
+ * The ring holds no pointer, so the same ring is mapped from a named shared
+ * memory object for the SHM queues: the futexes are then process-shared and
+ * a message crosses processes without any syscall unless a side sleeps.
+ *
+ * A ring created with priorities has one lane of slots and cursors per
+ * priority, the receivers claim from the highest lane that is not empty.
+ */
+typedef struct {
+	uint64_t enqueue_pos __attribute__((aligned(OSAL_CACHELINE_SIZE)));
+	uint64_t dequeue_pos __attribute__((aligned(OSAL_CACHELINE_SIZE)));
+} mpmc_lane_t;
+
+typedef struct {
+	uint32_t signal __attribute__((aligned(OSAL_CACHELINE_SIZE)));
+	uint32_t waiters;
+	/* the same for the senders waiting for a free slot */
+	uint32_t space_signal;
+	uint32_t space_waiters;
+	/* read-only after create */
+	uint32_t qsize __attribute__((aligned(OSAL_CACHELINE_SIZE)));
+	uint32_t msglen;
+	uint32_t slot_size;
+	uint32_t n_lanes;
+	uint32_t shared;
+	uint32_t ready;
+	mpmc_lane_t lanes[OSAL_QUEUE_PRIO_NUM];
+	uint8_t slots[] __attribute__((aligned(OSAL_CACHELINE_SIZE)));
+} mpmc_ring_t;
+
+typedef struct {
+	uint64_t seq;
+#if OSAL_QUEUE_STATS
+	uint64_t stamp; /* send time */
+#endif
+	uint32_t len;
+	uint8_t data[];
+} mpmc_slot_t;
+
+static mpmc_slot_t *mpmc_slot(mpmc_ring_t *ring, uint32_t lane, uint64_t pos)
+{
+	size_t n = (size_t)lane * ring->qsize + (size_t)(pos % ring->qsize);
+
+	return (mpmc_slot_t *)&ring->slots[n * ring->slot_size];
+}
+
+static uint32_t mpmc_slot_size(uint32_t msglen)
+{
+	return (sizeof(mpmc_slot_t) + msglen + 7) & ~7U;
+}
+
+static uint32_t mpmc_n_lanes(osal_queue_cfg_t *cfg)
+{
+	return cfg->prio ? OSAL_QUEUE_PRIO_NUM : 1;
+}
+
+static size_t mpmc_ring_size(osal_queue_cfg_t *cfg)
+{
+	return sizeof(mpmc_ring_t) +
+		(size_t)mpmc_n_lanes(cfg) * cfg->qsize * mpmc_slot_size(cfg->msglen);
+}
+
+static void mpmc_ring_init(mpmc_ring_t *ring, osal_queue_cfg_t *cfg, bool shared)
+{
+	uint32_t lane;
+	uint32_t i;
+
+	memset(ring, 0, sizeof(mpmc_ring_t));
+	ring->qsize = cfg->qsize;
+	ring->msglen = cfg->msglen;
+	ring->slot_size = mpmc_slot_size(cfg->msglen);
+	ring->n_lanes = mpmc_n_lanes(cfg);
+	ring->shared = shared;
+	for (lane = 0; lane < ring->n_lanes; lane++) {
+		for (i = 0; i < cfg->qsize; i++) {
+			mpmc_slot(ring, lane, i)->seq = i;
+		}
+	}
+	__atomic_store_n(&ring->ready, MPMC_RING_READY, __ATOMIC_RELEASE);
+}
+
+static osal_error_t queue_mpmc_create(osal_queue_t *queue, osal_queue_cfg_t *cfg)
+{
+	mpmc_ring_t *ring;
+
+	if (cfg->qsize < MPMC_QSIZE_MIN) {
+		return OSAL_E_PARAM;
+	}
+	ring = osal_mem_alloc(mpmc_ring_size(cfg));
+	if (ring == NULL) {
+		return OSAL_E_RESRC;
+	}
+	mpmc_ring_init(ring, cfg, false);
+	snprintf(queue->name, OSAL_QUEUE_NAME_SIZE+1, "%s", cfg->name);
+	queue->ring = ring;
+	return OSAL_E_OK;
+}
+
+static void queue_mpmc_destroy(osal_queue_t *queue)
+{
+	osal_mem_free(queue->ring);
+}
+
+/* wait for the creator to size and initialize the ring of an existing object,
+ * whose geometry has to be the one of the config */
+static osal_error_t shm_attach(osal_queue_t *queue, int fd, osal_queue_cfg_t *cfg)
+{
+	size_t size = mpmc_ring_size(cfg);
+	uint64_t deadline = futex_deadline(MPMC_ATTACH_TIMEOUT_USEC);
+	uint64_t now = 0;
+	mpmc_ring_t *ring;
+	struct stat st;
+
+	for (;;) {
+		if (fstat(fd, &st) < 0) {
+			OSALOG_ERROR("fstat(%s):%s\n", queue->name, strerror(errno));
+			return OSAL_E_OSCALL;
+		}
+		if (st.st_size != 0) {
+			break;
+		}
+		osal_clock_time(&now);
+		if (now >= deadline) {
+			return OSAL_E_TIMEOUT;
+		}
+		sched_yield();
+	}
+	if ((size_t)st.st_size != size) {
+		OSALOG_ERROR("%s: size %ld does not match the config\n",
+					 queue->name, (long)st.st_size);
+		return OSAL_E_PARAM;
+	}
+	ring = mmap(NULL, size, PROT_READ|PROT_WRITE, MAP_SHARED|MAP_POPULATE, fd, 0);
+	if (ring == MAP_FAILED) {
+		OSALOG_ERROR("mmap(%s):%s\n", queue->name, strerror(errno));
+		return OSAL_E_OSCALL;
+	}
+	while (__atomic_load_n(&ring->ready, __ATOMIC_ACQUIRE) != MPMC_RING_READY) {
+		osal_clock_time(&now);
+		if (now >= deadline) {
+			munmap(ring, size);
+			return OSAL_E_TIMEOUT;
+		}
+		sched_yield();
+	}
+	/* different geometries can add up to the same size */
+	if ((ring->qsize != cfg->qsize) || (ring->msglen != cfg->msglen) ||
+		(ring->n_lanes != mpmc_n_lanes(cfg))) {
+		OSALOG_ERROR("%s: qsize=%u msglen=%u lanes=%u do not match the config\n",
+					 queue->name, ring->qsize, ring->msglen, ring->n_lanes);
+		munmap(ring, size);
+		return OSAL_E_PARAM;
+	}
+	queue->ring = ring;
+	return OSAL_E_OK;
+}
+
+static osal_error_t queue_shm_create(osal_queue_t *queue, osal_queue_cfg_t *cfg)
+{
+	size_t size = mpmc_ring_size(cfg);
+	osal_error_t res = OSAL_E_OK;
+	mpmc_ring_t *ring;
+	int fd;
+
+	if (cfg->qsize < MPMC_QSIZE_MIN) {
+		return OSAL_E_PARAM;
+	}
+	snprintf(queue->name, OSAL_QUEUE_NAME_SIZE+1, "/%s", cfg->name);
+	/* create the object or attach to it, as the POSIX queues do */
+	fd = shm_open(queue->name, O_CREAT|O_RDWR|O_EXCL, S_IRUSR|S_IWUSR);
+	if (fd < 0) {
+		if (errno != EEXIST) {
+			OSALOG_ERROR("shm_open(%s):%s\n", queue->name, strerror(errno));
+			return OSAL_E_OSCALL;
+		}
+		fd = shm_open(queue->name, O_RDWR, 0);
+		if (fd < 0) {
+			OSALOG_ERROR("shm_open(%s):%s\n", queue->name, strerror(errno));
+			return OSAL_E_OSCALL;
+		}
+		res = shm_attach(queue, fd, cfg);
+		close(fd);
+		if (res != OSAL_E_OK) {
+			return res;
+		}
+		OSALOG_INFO("Open existing queue: %s\n", queue->name);
+		queue->ring_size = size;
+		return OSAL_E_OK;
+	}
+
+	if (ftruncate(fd, size) < 0) {
+		OSALOG_ERROR("ftruncate(%s):%s\n", queue->name, strerror(errno));
+		res = OSAL_E_OSCALL;
+		goto error;
+	}
+	ring = mmap(NULL, size, PROT_READ|PROT_WRITE, MAP_SHARED|MAP_POPULATE, fd, 0);
+	if (ring == MAP_FAILED) {
+		OSALOG_ERROR("mmap(%s):%s\n", queue->name, strerror(errno));
+		res = OSAL_E_OSCALL;
+		goto error;
+	}
+	mpmc_ring_init(ring, cfg, true);
+	close(fd);
+	OSALOG_INFO("Open new queue: %s qsize=%d msglen=%d\n",
+				queue->name, cfg->qsize, cfg->msglen);
+	queue->create = true;
+	queue->ring = ring;
+	queue->ring_size = size;
+	return OSAL_E_OK;
+
+error:
+	close(fd);
+	shm_unlink(queue->name);
+	return res;
+}
+
+static void queue_shm_destroy(osal_queue_t *queue)
+{
+	munmap(queue->ring, queue->ring_size);
+	if (queue->create) {
+		shm_unlink(queue->name);
+	}
+}
+
+static mpmc_slot_t *mpmc_slot_of(uint8_t *ptr)
+{
+	return (mpmc_slot_t *)(ptr - offsetof(mpmc_slot_t, data));
+}
+
+/* claim the next free slot of a lane */
+static osal_error_t mpmc_reserve(mpmc_ring_t *ring, uint32_t lane, uint8_t **ptr)
+{
+	uint64_t *enqueue_pos = &ring->lanes[lane].enqueue_pos;
+	uint64_t pos = __atomic_load_n(enqueue_pos, __ATOMIC_RELAXED);
+	mpmc_slot_t *slot;
+	int64_t diff;
+
+	for (;;) {
+		slot = mpmc_slot(ring, lane, pos);
+		diff = (int64_t)(__atomic_load_n(&slot->seq, __ATOMIC_ACQUIRE) - pos);
+		if (diff == 0) {
+			if (__atomic_compare_exchange_n(enqueue_pos, &pos, pos + 1,
+											true, __ATOMIC_RELAXED,
+											__ATOMIC_RELAXED)) {
+				break;
+			}
+		} else if (diff < 0) {
+			/* the slot still holds the message of the previous lap */
+			return OSAL_E_QFULL;
+		} else {
+			pos = __atomic_load_n(enqueue_pos, __ATOMIC_RELAXED);
+		}
+	}
+	/* the sequence stays at pos until the commit */
+	*ptr = slot->data;
+	return OSAL_E_OK;
+}
+
+static osal_error_t queue_mpmc_reserve(osal_queue_t *queue, uint8_t **ptr)
+{
+	return mpmc_reserve(queue->ring, 0, ptr);
+}
+
+/* wake up to n receivers after publishing n messages */
+static void mpmc_notify(osal_queue_t *queue, uint32_t n)
+{
+	mpmc_ring_t *ring = queue->ring;
+
+	/* pairs with the waiters increment of the receivers */
+	__atomic_thread_fence(__ATOMIC_SEQ_CST);
+	if (__atomic_load_n(&ring->waiters, __ATOMIC_RELAXED) != 0) {
+		__atomic_fetch_add(&ring->signal, 1, __ATOMIC_RELEASE);
+		futex_wake(&ring->signal, n, ring->shared);
+		if (!ring->shared) {
+			queue_set_notify(queue);
+		}
+	}
+}
+
+static void mpmc_publish(mpmc_slot_t *slot, uint32_t msglen)
+{
+	slot->len = msglen;
+#if OSAL_QUEUE_STATS
+	slot->stamp = queue_stats_stamp();
+#endif
+	__atomic_store_n(&slot->seq, slot->seq + 1, __ATOMIC_RELEASE);
+}
+
+/* the slot whose data ptr is, NULL for a pointer out of the slots or off a
+ * slot boundary, n gets the index of the slot in the ring */
+static mpmc_slot_t *mpmc_slot_at(mpmc_ring_t *ring, uint8_t *ptr, size_t *n)
+{
+	uintptr_t off = (uintptr_t)ptr - offsetof(mpmc_slot_t, data) - (uintptr_t)ring->slots;
+
+	if (((uintptr_t)ptr < (uintptr_t)ring->slots + offsetof(mpmc_slot_t, data)) ||
+		(off % ring->slot_size != 0)) {
+		return NULL;
+	}
+	*n = off / ring->slot_size;
+	if (*n >= (size_t)ring->n_lanes * ring->qsize) {
+		return NULL;
+	}
+	return (mpmc_slot_t *)&ring->slots[off];
+}
+
+static osal_error_t queue_mpmc_commit(osal_queue_t *queue, uint8_t *ptr, uint32_t msglen)
+{
+	mpmc_ring_t *ring = queue->ring;
+	mpmc_slot_t *slot;
+	uint64_t pos;
+	size_t n;
+
+	/* a reserved slot keeps the sequence pos of a position of its own that
+	 * its lane has handed out */
+	slot = mpmc_slot_at(ring, ptr, &n);
+	if (slot == NULL) {
+		return OSAL_E_PARAM;
+	}
+	pos = __atomic_load_n(&slot->seq, __ATOMIC_ACQUIRE);
+	if ((pos % ring->qsize != n % ring->qsize) ||
+		((int64_t)(__atomic_load_n(&ring->lanes[n / ring->qsize].enqueue_pos,
+								   __ATOMIC_RELAXED) - pos) <= 0)) {
+		return OSAL_E_PARAM;
+	}
+	mpmc_publish(slot, msglen);
+	mpmc_notify(queue, 1);
+	return OSAL_E_OK;
+}
+
+static bool mpmc_is_full(mpmc_ring_t *ring, uint32_t lane)
+{
+	uint64_t pos = __atomic_load_n(&ring->lanes[lane].enqueue_pos, __ATOMIC_SEQ_CST);
+
+	/* the slot still holds the message of the previous lap, as in mpmc_reserve */
+	return (int64_t)(__atomic_load_n(&mpmc_slot(ring, lane, pos)->seq, __ATOMIC_SEQ_CST) - pos) < 0;
+}
+
+static osal_error_t mpmc_space_wait(mpmc_ring_t *ring, uint32_t lane, uint64_t deadline)
+{
+	osal_error_t res = OSAL_E_OK;
+	uint32_t signal;
+
+	__atomic_fetch_add(&ring->space_waiters, 1, __ATOMIC_SEQ_CST);
+	signal = __atomic_load_n(&ring->space_signal, __ATOMIC_SEQ_CST);
+	if (mpmc_is_full(ring, lane)) {
+		res = futex_wait(&ring->space_signal, signal, deadline, ring->shared);
+	}
+	__atomic_fetch_sub(&ring->space_waiters, 1, __ATOMIC_RELAXED);
+	return res;
+}
+
+static osal_error_t queue_mpmc_send(osal_queue_t *queue, uint8_t *msg,
+									uint32_t msglen, uint32_t prio,
+									uint32_t timeout_usec)
+{
+	mpmc_ring_t *ring = queue->ring;
+	uint64_t deadline = 0;
+	osal_error_t res;
+	uint8_t *ptr;
+
+	if (prio >= ring->n_lanes) {
+		return OSAL_E_NOSUPPORT;
+	}
+	for (;;) {
+		res = mpmc_reserve(ring, prio, &ptr);
+		if ((res != OSAL_E_QFULL) || (timeout_usec == 0)) {
+			break;
+		}
+		if (deadline == 0) {
+			deadline = futex_deadline(timeout_usec);
+		}
+		if (mpmc_space_wait(ring, prio, deadline) == OSAL_E_TIMEOUT) {
+			return OSAL_E_TIMEOUT;
+		}
+	}
+	if (res != OSAL_E_OK) {
+		return res;
+	}
+	memcpy(ptr, msg, msglen);
+	mpmc_publish(mpmc_slot_of(ptr), msglen);
+	mpmc_notify(queue, 1);
+	return OSAL_E_OK;
+}
+
+static bool mpmc_is_empty(mpmc_ring_t *ring)
+{
+	uint32_t lane;
+	uint64_t pos;
+
+	for (lane = 0; lane < ring->n_lanes; lane++) {
+		pos = __atomic_load_n(&ring->lanes[lane].dequeue_pos, __ATOMIC_SEQ_CST);
+		if (__atomic_load_n(&mpmc_slot(ring, lane, pos)->seq, __ATOMIC_SEQ_CST) == pos + 1) {
+			return false;
+		}
+	}
+	return true;
+}
+
+static osal_error_t mpmc_wait(mpmc_ring_t *ring, uint64_t deadline)
+{
+	osal_error_t res = OSAL_E_OK;
+	uint32_t signal;
+
+	__atomic_fetch_add(&ring->waiters, 1, __ATOMIC_SEQ_CST);
+	signal = __atomic_load_n(&ring->signal, __ATOMIC_SEQ_CST);
+	if (mpmc_is_empty(ring)) {
+		res = futex_wait(&ring->signal, signal, deadline, ring->shared);
+	}
+	__atomic_fetch_sub(&ring->waiters, 1, __ATOMIC_RELAXED);
+	return res;
+}
+
+/* claim the oldest message of a lane no longer than bufsize,
+ * OSAL_E_QEMPTY if the lane is empty */
+static osal_error_t mpmc_claim_lane(mpmc_ring_t *ring, uint32_t lane, uint32_t bufsize,
+									mpmc_slot_t **claimed)
+{
+	uint64_t *dequeue_pos = &ring->lanes[lane].dequeue_pos;
+	mpmc_slot_t *slot;
+	uint64_t pos;
+	int64_t diff;
+
+	pos = __atomic_load_n(dequeue_pos, __ATOMIC_RELAXED);
+	for (;;) {
+		slot = mpmc_slot(ring, lane, pos);
+		diff = (int64_t)(__atomic_load_n(&slot->seq, __ATOMIC_ACQUIRE) - (pos + 1));
+		if (diff == 0) {
+			/* the length is stable as long as the slot can be claimed */
+			if (__atomic_load_n(&slot->len, __ATOMIC_RELAXED) > bufsize) {
+				return OSAL_E_PARAM;
+			}
+			if (__atomic_compare_exchange_n(dequeue_pos, &pos, pos + 1,
+											true, __ATOMIC_RELAXED,
+											__ATOMIC_RELAXED)) {
+				break;
+			}
+		} else if (diff < 0) {
+			return OSAL_E_QEMPTY;
+		} else {
+			pos = __atomic_load_n(dequeue_pos, __ATOMIC_RELAXED);
+		}
+	}
+	/* the sequence stays at pos+1 until the release */
+	*claimed = slot;
+	return OSAL_E_OK;
+}
+
+/* claim the oldest message of the highest lane that is not empty */
+static osal_error_t mpmc_claim(mpmc_ring_t *ring, uint32_t bufsize,
+							   uint32_t timeout_usec, mpmc_slot_t **claimed)
+{
+	uint64_t deadline = 0;
+	osal_error_t res;
+	int32_t lane;
+
+	for (;;) {
+		for (lane = ring->n_lanes - 1; lane >= 0; lane--) {
+			res = mpmc_claim_lane(ring, lane, bufsize, claimed);
+			if (res != OSAL_E_QEMPTY) {
+				return res;
+			}
+		}
+		if (timeout_usec == 0) {
+			return OSAL_E_TIMEOUT;
+		}
+		if (deadline == 0) {
+			deadline = futex_deadline(timeout_usec);
+		}
+		if (mpmc_wait(ring, deadline) == OSAL_E_TIMEOUT) {
+			return OSAL_E_TIMEOUT;
+		}
+	}
+}
+
+static osal_error_t queue_mpmc_peek(osal_queue_t *queue, uint8_t **ptr,
+									uint32_t *msglen, uint32_t timeout_usec)
+{
+	mpmc_slot_t *slot;
+	osal_error_t res;
+
+	res = mpmc_claim(queue->ring, UINT32_MAX, timeout_usec, &slot);
+	if (res != OSAL_E_OK) {
+		return res;
+	}
+	*ptr = slot->data;
+	*msglen = slot->len;
+	return OSAL_E_OK;
+}
+
+/* hand a claimed slot back to the senders */
+static void mpmc_free(mpmc_ring_t *ring, mpmc_slot_t *slot)
+{
+	__atomic_store_n(&slot->seq, slot->seq - 1 + ring->qsize, __ATOMIC_RELEASE);
+
+	/* pairs with the space_waiters increment of the senders, all of them
+	 * are woken up as they may wait on different lanes */
+	__atomic_thread_fence(__ATOMIC_SEQ_CST);
+	if (__atomic_load_n(&ring->space_waiters, __ATOMIC_RELAXED) != 0) {
+		__atomic_fetch_add(&ring->space_signal, 1, __ATOMIC_RELEASE);
+		futex_wake(&ring->space_signal, INT32_MAX, ring->shared);
+	}
+}
+
+/* the slot of a message claimed by a peek, NULL for a pointer that is not
+ * the data of a slot, or whose slot is free, not yet received or already
+ * released */
+static mpmc_slot_t *mpmc_claimed_slot(mpmc_ring_t *ring, uint8_t *ptr)
+{
+	mpmc_slot_t *slot;
+	uint64_t pos;
+	size_t n;
+
+	slot = mpmc_slot_at(ring, ptr, &n);
+	if (slot == NULL) {
+		return NULL;
+	}
+	/* a claimed slot keeps the sequence pos+1 of a position of its own
+	 * that its lane has received */
+	pos = __atomic_load_n(&slot->seq, __ATOMIC_ACQUIRE) - 1;
+	if ((pos % ring->qsize != n % ring->qsize) ||
+		((int64_t)(__atomic_load_n(&ring->lanes[n / ring->qsize].dequeue_pos,
+								   __ATOMIC_RELAXED) - pos) <= 0)) {
+		return NULL;
+	}
+	return slot;
+}
+
+static osal_error_t queue_mpmc_release(osal_queue_t *queue, uint8_t *ptr)
+{
+	mpmc_slot_t *slot = mpmc_claimed_slot(queue->ring, ptr);
+
+	if (slot == NULL) {
+		return OSAL_E_PARAM;
+	}
+#if OSAL_QUEUE_STATS
+	queue_stats_latency(queue, slot->stamp);
+#endif
+	mpmc_free(queue->ring, slot);
+	return OSAL_E_OK;
+}
+
+static osal_error_t queue_mpmc_recv(osal_queue_t *queue, uint8_t *buf,
+									uint32_t bufsize, uint32_t *msglen,
+									uint32_t timeout_usec)
+{
+	mpmc_slot_t *slot;
+	osal_error_t res;
+
+	res = mpmc_claim(queue->ring, bufsize, timeout_usec, &slot);
+	if (res != OSAL_E_OK) {
+		return res;
+	}
+	*msglen = slot->len;
+	memcpy(buf, slot->data, slot->len);
+#if OSAL_QUEUE_STATS
+	queue_stats_latency(queue, slot->stamp);
+#endif
+	mpmc_free(queue->ring, slot);
+	return OSAL_E_OK;
+}
+
+static osal_error_t queue_mpmc_send_batch(osal_queue_t *queue, uint8_t *msgs[],
+										  uint32_t lens[], uint32_t n, uint32_t *sent)
+{
+	uint8_t *ptr;
+	uint32_t i;
+
+	for (i = 0; i < n; i++) {
+		if (mpmc_reserve(queue->ring, 0, &ptr) != OSAL_E_OK) {
+			break;
+		}
+		memcpy(ptr, msgs[i], lens[i]);
+		mpmc_publish(mpmc_slot_of(ptr), lens[i]);
+	}
+	*sent = i;
+	if (i == 0) {
+		return OSAL_E_QFULL;
+	}
+	mpmc_notify(queue, i);
+	return (i == n) ? OSAL_E_OK : OSAL_E_QFULL;
+}
+
+static osal_error_t queue_mpmc_recv_batch(osal_queue_t *queue, uint8_t *bufs[],
+										  uint32_t lens[], uint32_t bufsize,
+										  uint32_t n, uint32_t *got,
+										  uint32_t timeout_usec)
+{
+	osal_error_t res;
+	uint32_t i;
+
+	/* only the first message is waited for, the rest is what is there */
+	res = queue_mpmc_recv(queue, bufs[0], bufsize, &lens[0], timeout_usec);
+	if (res != OSAL_E_OK) {
+		*got = 0;
+		return res;
+	}
+	for (i = 1; i < n; i++) {
+		if (queue_mpmc_recv(queue, bufs[i], bufsize, &lens[i], 0) != OSAL_E_OK) {
+			break;
+		}
+	}
+	*got = i;
+	return OSAL_E_OK;
+}
+
+static osal_error_t queue_mpmc_drop(osal_queue_t *queue, uint32_t prio)
+{
+	mpmc_ring_t *ring = queue->ring;
+	mpmc_slot_t *slot;
+	osal_error_t res;
+
+	if (prio >= ring->n_lanes) {
+		return OSAL_E_NOSUPPORT;
+	}
+	res = mpmc_claim_lane(ring, prio, UINT32_MAX, &slot);
+	if (res != OSAL_E_OK) {
+		return res;
+	}
+	mpmc_free(ring, slot);
+	return OSAL_E_OK;
+}
+
+/* reserved slots are counted, the tail is read first not to exceed the head */
+static uint32_t queue_mpmc_count(osal_queue_t *queue)
+{
+	mpmc_ring_t *ring = queue->ring;
+	uint64_t count = 0;
+	uint64_t tail;
+	uint32_t i;
+
+	for (i = 0; i < ring->n_lanes; i++) {
+		tail = __atomic_load_n(&ring->lanes[i].dequeue_pos, __ATOMIC_ACQUIRE);
+		count += __atomic_load_n(&ring->lanes[i].enqueue_pos, __ATOMIC_ACQUIRE) - tail;
+	}
+	return (uint32_t)count;
+}
+
+static bool queue_mpmc_set_arm(osal_queue_t *queue, int32_t delta)
+{
+	mpmc_ring_t *ring = queue->ring;
+
+	/* pairs with the fence of mpmc_notify, as in mpmc_wait */
+	__atomic_fetch_add(&ring->waiters, delta, __ATOMIC_SEQ_CST);
+	return !mpmc_is_empty(ring);
+}
+
+const queue_backend_t queue_mpmc_backend = {
+	.create = queue_mpmc_create,
+	.destroy = queue_mpmc_destroy,
+	.send = queue_mpmc_send,
+	.recv = queue_mpmc_recv,
+	.reserve = queue_mpmc_reserve,
+	.commit = queue_mpmc_commit,
+	.peek = queue_mpmc_peek,
+	.release = queue_mpmc_release,
+	.count = queue_mpmc_count,
+	.drop = queue_mpmc_drop,
+	.send_batch = queue_mpmc_send_batch,
+	.recv_batch = queue_mpmc_recv_batch,
+	.set_fd = queue_set_eventfd,
+	.set_arm = queue_mpmc_set_arm,
+};
+
+/* an eventfd cannot be signalled from another process, no wait set */
+const queue_backend_t queue_shm_backend = {
+	.create = queue_shm_create,
+	.destroy = queue_shm_destroy,
+	.send = queue_mpmc_send,
+	.recv = queue_mpmc_recv,
+	.reserve = queue_mpmc_reserve,
+	.commit = queue_mpmc_commit,
+	.peek = queue_mpmc_peek,
+	.release = queue_mpmc_release,
+	.count = queue_mpmc_count,
+	.drop = queue_mpmc_drop,
+	.send_batch = queue_mpmc_send_batch,
+	.recv_batch = queue_mpmc_recv_batch,
+};
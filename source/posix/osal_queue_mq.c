@@ -0,0 +1,220 @@
+/* BSD 2-Clause License
+*
+* Copyright (c) 2025, nguyenvannam142@gmail.com
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*
+* 1. Redistributions of source code must retain the above copyright notice, this
+*    list of conditions and the following disclaimer.
+*
+* 2. Redistributions in binary form must reproduce the above copyright notice,
+*    this list of conditions and the following disclaimer in the documentation
+*    and/or other materials provided with the distribution.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#define _GNU_SOURCE /* ppoll */
+#include <stdio.h>
+#include <string.h>
+#include <mqueue.h>
+#include <fcntl.h>           /* For O_* constants */
+#include <sys/stat.h>        /* For mode constants */
+#include <time.h>
+#include <errno.h>
+#include <poll.h>
+#include "osal_time.h"
+#include "osal_assert.h"
+#include "osal_log.h"
+#include "osal_queue_backend.h"
+#define OSALOG_MODULE OSAL_LOG_MODULE_INDEX
+
+static void queue_mq_destroy(osal_queue_t *queue)
+{
+	if (queue->fd > 0) {
+		mq_close(queue->fd);
+	}
+	if (queue->create) {
+		mq_unlink(queue->name);
+	}
+}
+
+static osal_error_t queue_mq_create(osal_queue_t *queue, osal_queue_cfg_t *cfg)
+{
+	int res = 0;
+	struct mq_attr attr;
+
+	snprintf(queue->name, OSAL_QUEUE_NAME_SIZE+1, "/%s", cfg->name);
+	memset(&attr, 0, sizeof(attr));
+	attr.mq_maxmsg = cfg->qsize;
+	attr.mq_msgsize = cfg->msglen;
+	/* Opening queue is very important and happen at the beginning.
+	 * If we can not open the queue, we should terminate the program */
+	res = mq_open(queue->name, O_CREAT|O_RDWR|O_EXCL, S_IRWXU, &attr);
+	if (res < 0) {
+		if (errno != EEXIST) {
+			OSALOG_ERROR("mq_open(%s):%s\n", queue->name, strerror(errno));
+			OSAL_RUNTIME_ASSERT(false);
+		}
+		res = mq_open(queue->name, O_RDWR);
+		if (res < 0) {
+			OSALOG_ERROR("mq_open(%s):%s\n", queue->name, strerror(errno));
+			OSAL_RUNTIME_ASSERT(false);
+		}
+		OSALOG_INFO("Open existing queue: %s\n", queue->name);
+	} else {
+		OSALOG_INFO("Open new queue: %s qsize=%d msglen=%d\n",
+			   queue->name, cfg->qsize, cfg->msglen);
+		queue->create = true;
+	}
+	queue->fd = res;
+
+	return OSAL_E_OK;
+}
+
+/*
+ * A send or a receive is first tried with an expired mq_timed* deadline,
+ * which fails at once on a full or an empty queue. A blocking call then
+ * waits for the descriptor with ppoll() and tries again: the timeout is
+ * relative and kept against the monotonic clock, so that a step of the
+ * wall clock neither stretches nor cuts it, and a signal or a message
+ * taken by another receiver only costs a retry with the remaining time.
+ */
+static const struct timespec s_mq_expired;
+
+/* wait for the queue to become ready for events until the monotonic
+ * deadline in ns */
+static osal_error_t mq_poll(osal_queue_t *queue, short events, uint64_t deadline)
+{
+	struct pollfd pfd = { .fd = queue->fd, .events = events };
+	struct timespec ts;
+	uint64_t now = 0;
+	int res;
+
+	osal_clock_time(&now);
+	if (now >= deadline) {
+		return OSAL_E_TIMEOUT;
+	}
+	ts.tv_sec = (deadline - now) / OSAL_SEC_NSEC;
+	ts.tv_nsec = (deadline - now) % OSAL_SEC_NSEC;
+	res = ppoll(&pfd, 1, &ts, NULL);
+	if (res < 0) {
+		if (errno == EINTR) {
+			return OSAL_E_OK;
+		}
+		OSALOG_ERROR("ppoll(%s):%s\n", queue->name, strerror(errno));
+		return OSAL_E_OSCALL;
+	}
+	return (res == 0) ? OSAL_E_TIMEOUT : OSAL_E_OK;
+}
+
+static osal_error_t queue_mq_send(osal_queue_t *queue, uint8_t *msg, uint32_t msglen,
+								  uint32_t prio, uint32_t timeout_usec)
+{
+	uint64_t deadline = 0;
+	osal_error_t err;
+
+	if (queue->fd <= 0) {
+		return OSAL_E_PARAM;
+	}
+	for (;;) {
+		if (mq_timedsend(queue->fd, (const char *)msg, msglen, prio,
+						 &s_mq_expired) == 0) {
+			return OSAL_E_OK;
+		}
+		if (errno == EINTR) {
+			continue;
+		}
+		if ((errno != ETIMEDOUT) && (errno != EAGAIN)) {
+			OSALOG_ERROR("mq_timedsend: %s\n", strerror(errno));
+			return OSAL_E_OSCALL;
+		}
+		if (timeout_usec == 0) {
+			return OSAL_E_QFULL;
+		}
+		if (deadline == 0) {
+			osal_clock_time(&deadline);
+			deadline += (uint64_t)timeout_usec * OSAL_USEC_NSEC;
+		}
+		err = mq_poll(queue, POLLOUT, deadline);
+		if (err != OSAL_E_OK) {
+			return err;
+		}
+	}
+}
+
+static osal_error_t queue_mq_recv(osal_queue_t *queue, uint8_t *buf,
+								  uint32_t bufsize, uint32_t *msglen,
+								  uint32_t timeout_usec)
+{
+	uint64_t deadline = 0;
+	osal_error_t err;
+	ssize_t res;
+
+	if (queue->fd <= 0) {
+		return OSAL_E_PARAM;
+	}
+	for (;;) {
+		res = mq_timedreceive(queue->fd, (char *)buf, bufsize, NULL, &s_mq_expired);
+		if (res >= 0) {
+			*msglen = res;
+			return OSAL_E_OK;
+		}
+		if (errno == EINTR) {
+			continue;
+		}
+		if (errno == EMSGSIZE) {
+			return OSAL_E_PARAM;
+		}
+		if ((errno != ETIMEDOUT) && (errno != EAGAIN)) {
+			OSALOG_ERROR("mq_timedreceive:%s", strerror(errno));
+			return OSAL_E_OSCALL;
+		}
+		if (timeout_usec == 0) {
+			return OSAL_E_TIMEOUT;
+		}
+		if (deadline == 0) {
+			osal_clock_time(&deadline);
+			deadline += (uint64_t)timeout_usec * OSAL_USEC_NSEC;
+		}
+		err = mq_poll(queue, POLLIN, deadline);
+		if (err != OSAL_E_OK) {
+			return err;
+		}
+	}
+}
+
+static uint32_t queue_mq_count(osal_queue_t *queue)
+{
+	struct mq_attr attr;
+
+	if (mq_getattr(queue->fd, &attr) < 0) {
+		return 0;
+	}
+	return (uint32_t)attr.mq_curmsgs;
+}
+
+static int queue_mq_set_fd(osal_queue_t *queue)
+{
+	/* a message queue descriptor is pollable on Linux */
+	return queue->fd;
+}
+
+const queue_backend_t queue_mq_backend = {
+	.create = queue_mq_create,
+	.destroy = queue_mq_destroy,
+	.send = queue_mq_send,
+	.recv = queue_mq_recv,
+	.count = queue_mq_count,
+	.set_fd = queue_mq_set_fd,
+};
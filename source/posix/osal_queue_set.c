@@ -0,0 +1,320 @@
+/* BSD 2-Clause License
+*
+* Copyright (c) 2025, nguyenvannam142@gmail.com
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*
+* 1. Redistributions of source code must retain the above copyright notice, this
+*    list of conditions and the following disclaimer.
+*
+* 2. Redistributions in binary form must reproduce the above copyright notice,
+*    this list of conditions and the following disclaimer in the documentation
+*    and/or other materials provided with the distribution.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include "osal_queue.h"
+#include "osal_assert.h"
+#include "osal_log.h"
+#include "osal_rm.h"
+#include "osal_futex.h"
+#include "osal_queue_backend.h"
+#define OSALOG_MODULE OSAL_LOG_MODULE_INDEX
+
+/*
+ * Wait set of queues.
+ *
+ * The set polls one fd per queue with epoll: the descriptor of a POSIX
+ * queue, an eventfd for a ring. Before sleeping, the set counts itself as
+ * a waiter of every ring, so that a sender only writes the eventfd when the
+ * set may sleep, exactly as it only makes the futex call for a waiting
+ * receiver. The rings then tell by themselves whether they are readable.
+ */
+struct osal_queue_set {
+	osal_resrc_t *resrc;
+	int epfd;
+	uint32_t n_queues;
+	osal_queue_t *queues[OSAL_QUEUE_SET_SIZE];
+};
+
+typedef struct {
+	OSAL_RM_USEROBJMAN_DECLARE(
+		struct osal_queue_set,
+		OSAL_QUEUE_SET_NUM_MAX);
+	bool init;
+} queue_set_man_t;
+
+static queue_set_man_t s_queue_set_man;
+
+int queue_set_eventfd(osal_queue_t *queue)
+{
+	int efd;
+
+	if (queue->efd <= 0) {
+		efd = eventfd(0, EFD_NONBLOCK|EFD_CLOEXEC);
+		if (efd < 0) {
+			OSALOG_ERROR("eventfd:%s\n", strerror(errno));
+			return -1;
+		}
+		/* kept until the queue is deleted, a sender may be writing it */
+		__atomic_store_n(&queue->efd, efd, __ATOMIC_RELEASE);
+	}
+	return queue->efd;
+}
+
+void queue_set_notify(osal_queue_t *queue)
+{
+	int efd = __atomic_load_n(&queue->efd, __ATOMIC_ACQUIRE);
+
+	if (efd > 0) {
+		eventfd_write(efd, 1);
+	}
+}
+
+void queue_set_release(osal_queue_t *queue)
+{
+	if (queue->set != NULL) {
+		osal_queue_set_remove(queue->set, queue);
+	}
+	if (queue->efd > 0) {
+		close(queue->efd);
+		queue->efd = 0;
+	}
+}
+
+osal_error_t osal_queue_set_init(osal_mutex_t *mutex)
+{
+	if (s_queue_set_man.init == true) {
+		return OSAL_E_OK;
+	}
+	OSAL_RM_USEROBJMAN_INIT(&s_queue_set_man, OSAL_QUEUE_SET_NUM_MAX, mutex);
+	s_queue_set_man.init = true;
+
+	return OSAL_E_OK;
+}
+
+void osal_queue_set_deinit(void)
+{
+	if (s_queue_set_man.init == false) {
+		return;
+	}
+	osal_rm_deinit(&s_queue_set_man.rm);
+	s_queue_set_man.init = false;
+}
+
+osal_queue_set_t *osal_queue_set_create(void)
+{
+	osal_queue_set_t *set;
+	osal_resrc_t *resrc;
+
+	resrc = osal_rm_alloc(&s_queue_set_man.rm);
+	if (resrc == NULL) {
+		return NULL;
+	}
+	set = resrc->data;
+	OSAL_RUNTIME_ASSERT(set != NULL);
+	memset(set, 0, sizeof(osal_queue_set_t));
+	set->resrc = resrc;
+	set->epfd = epoll_create1(EPOLL_CLOEXEC);
+	if (set->epfd < 0) {
+		OSALOG_ERROR("epoll_create1:%s\n", strerror(errno));
+		osal_rm_free(&s_queue_set_man.rm, resrc);
+		return NULL;
+	}
+
+	return set;
+}
+
+void osal_queue_set_delete(osal_queue_set_t *set)
+{
+	osal_resrc_t *resrc;
+
+	if (set == NULL) {
+		return;
+	}
+	while (set->n_queues > 0) {
+		osal_queue_set_remove(set, set->queues[set->n_queues - 1]);
+	}
+	close(set->epfd);
+	resrc = set->resrc;
+	memset(set, 0, sizeof(osal_queue_set_t));
+	osal_rm_free(&s_queue_set_man.rm, resrc);
+}
+
+osal_error_t osal_queue_set_add(osal_queue_set_t *set, osal_queue_t *queue)
+{
+	struct epoll_event ev;
+	int fd;
+
+	if ((set == NULL) || (queue == NULL) || (queue->backend == NULL)) {
+		return OSAL_E_PARAM;
+	}
+	if (queue->backend->set_fd == NULL) {
+		return OSAL_E_NOSUPPORT;
+	}
+	if (queue->set != NULL) {
+		return OSAL_E_INUSE;
+	}
+	if (set->n_queues == OSAL_QUEUE_SET_SIZE) {
+		return OSAL_E_RESRC;
+	}
+	fd = queue->backend->set_fd(queue);
+	if (fd < 0) {
+		return OSAL_E_OSCALL;
+	}
+	memset(&ev, 0, sizeof(ev));
+	ev.events = EPOLLIN;
+	ev.data.ptr = queue;
+	if (epoll_ctl(set->epfd, EPOLL_CTL_ADD, fd, &ev) < 0) {
+		OSALOG_ERROR("epoll_ctl(%s):%s\n", queue->name, strerror(errno));
+		return OSAL_E_OSCALL;
+	}
+	queue->set = set;
+	queue->set_ready = false;
+	set->queues[set->n_queues++] = queue;
+
+	return OSAL_E_OK;
+}
+
+osal_error_t osal_queue_set_remove(osal_queue_set_t *set, osal_queue_t *queue)
+{
+	uint32_t i;
+
+	if ((set == NULL) || (queue == NULL) || (queue->set != set)) {
+		return OSAL_E_PARAM;
+	}
+	for (i = 0; i < set->n_queues; i++) {
+		if (set->queues[i] == queue) {
+			break;
+		}
+	}
+	OSAL_RUNTIME_ASSERT(i < set->n_queues);
+	epoll_ctl(set->epfd, EPOLL_CTL_DEL, queue->backend->set_fd(queue), NULL);
+	/* keep the order the queues were added in */
+	memmove(&set->queues[i], &set->queues[i + 1],
+			(set->n_queues - i - 1) * sizeof(set->queues[0]));
+	set->n_queues--;
+	queue->set = NULL;
+
+	return OSAL_E_OK;
+}
+
+/* count the set as a waiter of its rings (delta 1) or not anymore (-1),
+ * true if a ring has a message */
+static bool set_arm(osal_queue_set_t *set, int32_t delta)
+{
+	osal_queue_t *queue;
+	bool ready = false;
+	uint32_t i;
+
+	for (i = 0; i < set->n_queues; i++) {
+		queue = set->queues[i];
+		if (queue->backend->set_arm == NULL) {
+			continue;
+		}
+		queue->set_ready = queue->backend->set_arm(queue, delta);
+		ready |= queue->set_ready;
+	}
+	return ready;
+}
+
+/* epoll timeout rounded up to the next ms, the deadline being in ns */
+static int set_timeout_msec(uint64_t deadline)
+{
+	uint64_t now = 0;
+
+	if (deadline == 0) {
+		return 0;
+	}
+	osal_clock_time(&now);
+	if (now >= deadline) {
+		return 0;
+	}
+	return (deadline - now + OSAL_MSEC_NSEC - 1) / OSAL_MSEC_NSEC;
+}
+
+osal_error_t osal_queue_set_wait(osal_queue_set_t *set, osal_queue_t *ready[],
+								 uint32_t n, uint32_t *n_ready, uint32_t timeout_usec)
+{
+	struct epoll_event events[OSAL_QUEUE_SET_SIZE];
+	osal_queue_t *queue;
+	uint64_t deadline = 0;
+	eventfd_t val;
+	int timeout_msec;
+	int res;
+	int i;
+
+	if ((set == NULL) || (ready == NULL) || (n == 0) || (n_ready == NULL)) {
+		return OSAL_E_PARAM;
+	}
+	*n_ready = 0;
+	if (timeout_usec != 0) {
+		deadline = futex_deadline(timeout_usec);
+	}
+	for (;;) {
+		/* a ring already readable cancels the sleep, the POSIX queues
+		 * are still polled to be reported along */
+		timeout_msec = set_arm(set, 1) ? 0 : set_timeout_msec(deadline);
+		res = epoll_wait(set->epfd, events, OSAL_QUEUE_SET_SIZE, timeout_msec);
+		if ((res < 0) && (errno != EINTR)) {
+			OSALOG_ERROR("epoll_wait:%s\n", strerror(errno));
+			set_arm(set, -1);
+			return OSAL_E_OSCALL;
+		}
+		for (i = 0; i < res; i++) {
+			queue = events[i].data.ptr;
+			queue->set_ready = true;
+			if (queue->efd > 0) {
+				eventfd_read(queue->efd, &val);
+			}
+		}
+		/* the rings are readable from their indices, not from the eventfd */
+		set_arm(set, -1);
+
+		for (i = 0; i < (int)set->n_queues; i++) {
+			queue = set->queues[i];
+			if (queue->set_ready && (*n_ready < n)) {
+				ready[(*n_ready)++] = queue;
+			}
+			queue->set_ready = false;
+		}
+		if (*n_ready != 0) {
+			return OSAL_E_OK;
+		}
+		if (set_timeout_msec(deadline) == 0) {
+			return OSAL_E_TIMEOUT;
+		}
+	}
+}
+
+uint32_t osal_queue_set_use(void)
+{
+	if (s_queue_set_man.init == false) {
+		return 0;
+	}
+	return osal_rm_use(&s_queue_set_man.rm);
+}
+
+uint32_t osal_queue_set_avail(void)
+{
+	if (s_queue_set_man.init == false) {
+		return 0;
+	}
+	return osal_rm_avail(&s_queue_set_man.rm);
+}
@@ -0,0 +1,485 @@
+/* BSD 2-Clause License
+*
+* Copyright (c) 2025, nguyenvannam142@gmail.com
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*
+* 1. Redistributions of source code must retain the above copyright notice, this
+*    list of conditions and the following disclaimer.
+*
+* 2. Redistributions in binary form must reproduce the above copyright notice,
+*    this list of conditions and the following disclaimer in the documentation
+*    and/or other materials provided with the distribution.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <stdio.h>
+#include <string.h>
+#include "osal_mem.h"
+#include "osal_futex.h"
+#include "osal_queue_backend.h"
+
+/*
+ * Single-producer single-consumer ring.
+ *
+ * The producer owns head and the consumer owns tail, both run freely and
+ * are masked into a power of two number of slots. Each side keeps a cached
+ * copy of the other index on its own cache line and only reads the shared
+ * one when the cache says the ring is full (or empty). The consumer sleeps
+ * on the signal futex when the ring is empty, the producer only bumps it and
+ * makes the wake up call when a consumer announced itself in waiters.
+ *
+ * A ring created with priorities has one such lane of slots per priority,
+ * the consumer takes from the highest lane that is not empty.
+ */
+typedef struct {
+	/* producer cache line */
+	uint32_t head __attribute__((aligned(OSAL_CACHELINE_SIZE)));
+	uint32_t tail_cache;
+	/* consumer cache line */
+	uint32_t tail __attribute__((aligned(OSAL_CACHELINE_SIZE)));
+	uint32_t head_cache;
+} spsc_lane_t;
+
+typedef struct {
+	uint32_t signal __attribute__((aligned(OSAL_CACHELINE_SIZE)));
+	uint32_t waiters;
+	/* the same for the producer waiting for a free slot */
+	uint32_t space_signal;
+	uint32_t space_waiters;
+	/* read-only after create */
+	uint32_t qsize __attribute__((aligned(OSAL_CACHELINE_SIZE)));
+	uint32_t mask;
+	uint32_t slot_size;
+	uint32_t n_lanes;
+	spsc_lane_t lanes[OSAL_QUEUE_PRIO_NUM];
+	uint8_t slots[] __attribute__((aligned(OSAL_CACHELINE_SIZE)));
+} spsc_ring_t;
+
+typedef struct {
+#if OSAL_QUEUE_STATS
+	uint64_t stamp; /* send time */
+#endif
+	uint32_t len;
+	uint8_t data[];
+} spsc_slot_t;
+
+static spsc_slot_t *spsc_slot(spsc_ring_t *ring, uint32_t lane, uint32_t index)
+{
+	size_t n = (size_t)lane * (ring->mask + 1) + (index & ring->mask);
+
+	return (spsc_slot_t *)&ring->slots[n * ring->slot_size];
+}
+
+static osal_error_t queue_spsc_create(osal_queue_t *queue, osal_queue_cfg_t *cfg)
+{
+	spsc_ring_t *ring;
+	uint32_t n_lanes = cfg->prio ? OSAL_QUEUE_PRIO_NUM : 1;
+	uint32_t n_slots = 1;
+	uint32_t slot_size;
+
+	while (n_slots < cfg->qsize) {
+		n_slots <<= 1;
+	}
+	slot_size = (sizeof(spsc_slot_t) + cfg->msglen + 7) & ~7U;
+	ring = osal_mem_alloc(sizeof(spsc_ring_t) + (size_t)n_lanes * n_slots * slot_size);
+	if (ring == NULL) {
+		return OSAL_E_RESRC;
+	}
+	memset(ring, 0, sizeof(spsc_ring_t));
+	ring->qsize = cfg->qsize;
+	ring->mask = n_slots - 1;
+	ring->slot_size = slot_size;
+	ring->n_lanes = n_lanes;
+	snprintf(queue->name, OSAL_QUEUE_NAME_SIZE+1, "%s", cfg->name);
+	queue->ring = ring;
+	return OSAL_E_OK;
+}
+
+static void queue_spsc_destroy(osal_queue_t *queue)
+{
+	osal_mem_free(queue->ring);
+}
+
+/* free slots of a lane, only read from the producer */
+static uint32_t spsc_space(spsc_ring_t *ring, spsc_lane_t *lane, uint32_t n)
+{
+	uint32_t space = ring->qsize - (lane->head - lane->tail_cache);
+
+	if (space < n) {
+		lane->tail_cache = __atomic_load_n(&lane->tail, __ATOMIC_ACQUIRE);
+		space = ring->qsize - (lane->head - lane->tail_cache);
+	}
+	return space;
+}
+
+/* hand the slots of a lane up to head over to the consumer */
+static void spsc_publish(osal_queue_t *queue, spsc_lane_t *lane, uint32_t head)
+{
+	spsc_ring_t *ring = queue->ring;
+
+	__atomic_store_n(&lane->head, head, __ATOMIC_RELEASE);
+
+	/* pairs with the waiters increment of the consumer */
+	__atomic_thread_fence(__ATOMIC_SEQ_CST);
+	if (__atomic_load_n(&ring->waiters, __ATOMIC_RELAXED) != 0) {
+		__atomic_fetch_add(&ring->signal, 1, __ATOMIC_RELEASE);
+		futex_wake(&ring->signal, 1, false);
+		queue_set_notify(queue);
+	}
+}
+
+static osal_error_t queue_spsc_reserve(osal_queue_t *queue, uint8_t **ptr)
+{
+	spsc_ring_t *ring = queue->ring;
+	spsc_lane_t *lane = &ring->lanes[0];
+
+	if (spsc_space(ring, lane, 1) == 0) {
+		return OSAL_E_QFULL;
+	}
+	*ptr = spsc_slot(ring, 0, lane->head)->data;
+	return OSAL_E_OK;
+}
+
+static osal_error_t queue_spsc_commit(osal_queue_t *queue, uint8_t *ptr, uint32_t msglen)
+{
+	spsc_ring_t *ring = queue->ring;
+	spsc_lane_t *lane = &ring->lanes[0];
+	spsc_slot_t *slot = spsc_slot(ring, 0, lane->head);
+
+	if (ptr != slot->data) {
+		return OSAL_E_PARAM;
+	}
+	slot->len = msglen;
+#if OSAL_QUEUE_STATS
+	slot->stamp = queue_stats_stamp();
+#endif
+	spsc_publish(queue, lane, lane->head + 1);
+	return OSAL_E_OK;
+}
+
+/* wait until a lane has a free slot, its tail_cache is up to date then */
+static osal_error_t spsc_space_wait(spsc_ring_t *ring, spsc_lane_t *lane,
+									uint32_t timeout_usec)
+{
+	osal_error_t res = OSAL_E_OK;
+	uint64_t deadline;
+	uint32_t signal;
+
+	if (timeout_usec == 0) {
+		return OSAL_E_QFULL;
+	}
+	deadline = futex_deadline(timeout_usec);
+	while (res == OSAL_E_OK) {
+		__atomic_fetch_add(&ring->space_waiters, 1, __ATOMIC_SEQ_CST);
+		signal = __atomic_load_n(&ring->space_signal, __ATOMIC_SEQ_CST);
+		__atomic_thread_fence(__ATOMIC_SEQ_CST);
+		if (spsc_space(ring, lane, 1) == 0) {
+			res = futex_wait(&ring->space_signal, signal, deadline, false);
+		}
+		__atomic_fetch_sub(&ring->space_waiters, 1, __ATOMIC_RELAXED);
+		if (spsc_space(ring, lane, 1) != 0) {
+			return OSAL_E_OK;
+		}
+	}
+	return res;
+}
+
+/* hand the slots of a lane up to tail back to the producer */
+static void spsc_consume(spsc_ring_t *ring, spsc_lane_t *lane, uint32_t tail)
+{
+	__atomic_store_n(&lane->tail, tail, __ATOMIC_RELEASE);
+
+	/* pairs with the space_waiters increment of the producer */
+	__atomic_thread_fence(__ATOMIC_SEQ_CST);
+	if (__atomic_load_n(&ring->space_waiters, __ATOMIC_RELAXED) != 0) {
+		__atomic_fetch_add(&ring->space_signal, 1, __ATOMIC_RELEASE);
+		futex_wake(&ring->space_signal, 1, false);
+	}
+}
+
+static osal_error_t queue_spsc_send(osal_queue_t *queue, uint8_t *msg,
+									uint32_t msglen, uint32_t prio,
+									uint32_t timeout_usec)
+{
+	spsc_ring_t *ring = queue->ring;
+	spsc_lane_t *lane;
+	spsc_slot_t *slot;
+	osal_error_t res;
+
+	if (prio >= ring->n_lanes) {
+		return OSAL_E_NOSUPPORT;
+	}
+	lane = &ring->lanes[prio];
+	if (spsc_space(ring, lane, 1) == 0) {
+		res = spsc_space_wait(ring, lane, timeout_usec);
+		if (res != OSAL_E_OK) {
+			return res;
+		}
+	}
+	slot = spsc_slot(ring, prio, lane->head);
+	slot->len = msglen;
+#if OSAL_QUEUE_STATS
+	slot->stamp = queue_stats_stamp();
+#endif
+	memcpy(slot->data, msg, msglen);
+	spsc_publish(queue, lane, lane->head + 1);
+	return OSAL_E_OK;
+}
+
+/* the highest lane with a message, -1 if all are empty */
+static int32_t spsc_ready(spsc_ring_t *ring)
+{
+	spsc_lane_t *lane;
+	int32_t i;
+
+	for (i = ring->n_lanes - 1; i >= 0; i--) {
+		lane = &ring->lanes[i];
+		if (lane->tail != lane->head_cache) {
+			return i;
+		}
+		lane->head_cache = __atomic_load_n(&lane->head, __ATOMIC_ACQUIRE);
+		if (lane->tail != lane->head_cache) {
+			return i;
+		}
+	}
+	return -1;
+}
+
+/* wait until a lane is not empty, its head_cache is up to date then */
+static osal_error_t spsc_wait(spsc_ring_t *ring, uint32_t timeout_usec, int32_t *ready)
+{
+	osal_error_t res = OSAL_E_OK;
+	uint64_t deadline;
+	uint32_t signal;
+
+	*ready = spsc_ready(ring);
+	if (*ready >= 0) {
+		return OSAL_E_OK;
+	}
+	if (timeout_usec == 0) {
+		return OSAL_E_TIMEOUT;
+	}
+	deadline = futex_deadline(timeout_usec);
+	while (res == OSAL_E_OK) {
+		__atomic_fetch_add(&ring->waiters, 1, __ATOMIC_SEQ_CST);
+		signal = __atomic_load_n(&ring->signal, __ATOMIC_SEQ_CST);
+		__atomic_thread_fence(__ATOMIC_SEQ_CST);
+		*ready = spsc_ready(ring);
+		if (*ready < 0) {
+			res = futex_wait(&ring->signal, signal, deadline, false);
+			*ready = spsc_ready(ring);
+		}
+		__atomic_fetch_sub(&ring->waiters, 1, __ATOMIC_RELAXED);
+		if (*ready >= 0) {
+			return OSAL_E_OK;
+		}
+	}
+	return res;
+}
+
+static osal_error_t queue_spsc_peek(osal_queue_t *queue, uint8_t **ptr,
+									uint32_t *msglen, uint32_t timeout_usec)
+{
+	spsc_ring_t *ring = queue->ring;
+	spsc_slot_t *slot;
+	osal_error_t res;
+	int32_t ready;
+
+	res = spsc_wait(ring, timeout_usec, &ready);
+	if (res != OSAL_E_OK) {
+		return res;
+	}
+	slot = spsc_slot(ring, ready, ring->lanes[ready].tail);
+	*ptr = slot->data;
+	*msglen = slot->len;
+	return OSAL_E_OK;
+}
+
+static osal_error_t queue_spsc_release(osal_queue_t *queue, uint8_t *ptr)
+{
+	spsc_ring_t *ring = queue->ring;
+	spsc_lane_t *lane;
+	spsc_slot_t *slot;
+	uint32_t i;
+
+	for (i = 0; i < ring->n_lanes; i++) {
+		lane = &ring->lanes[i];
+		slot = spsc_slot(ring, i, lane->tail);
+		if ((lane->tail != lane->head_cache) && (ptr == slot->data)) {
+#if OSAL_QUEUE_STATS
+			queue_stats_latency(queue, slot->stamp);
+#endif
+			spsc_consume(ring, lane, lane->tail + 1);
+			return OSAL_E_OK;
+		}
+	}
+	return OSAL_E_PARAM;
+}
+
+static osal_error_t queue_spsc_recv(osal_queue_t *queue, uint8_t *buf,
+									uint32_t bufsize, uint32_t *msglen,
+									uint32_t timeout_usec)
+{
+	spsc_ring_t *ring = queue->ring;
+	spsc_lane_t *lane;
+	spsc_slot_t *slot;
+	osal_error_t res;
+	int32_t ready;
+
+	res = spsc_wait(ring, timeout_usec, &ready);
+	if (res != OSAL_E_OK) {
+		return res;
+	}
+	lane = &ring->lanes[ready];
+	slot = spsc_slot(ring, ready, lane->tail);
+	if (slot->len > bufsize) {
+		return OSAL_E_PARAM;
+	}
+	*msglen = slot->len;
+	memcpy(buf, slot->data, slot->len);
+#if OSAL_QUEUE_STATS
+	queue_stats_latency(queue, slot->stamp);
+#endif
+	spsc_consume(ring, lane, lane->tail + 1);
+	return OSAL_E_OK;
+}
+
+static osal_error_t queue_spsc_send_batch(osal_queue_t *queue, uint8_t *msgs[],
+										  uint32_t lens[], uint32_t n, uint32_t *sent)
+{
+	spsc_ring_t *ring = queue->ring;
+	spsc_lane_t *lane = &ring->lanes[0];
+	uint32_t head = lane->head;
+	spsc_slot_t *slot;
+	uint32_t space;
+	uint32_t i;
+#if OSAL_QUEUE_STATS
+	uint64_t stamp = queue_stats_stamp();
+#endif
+
+	space = spsc_space(ring, lane, n);
+	for (i = 0; (i < n) && (i < space); i++) {
+		slot = spsc_slot(ring, 0, head + i);
+		slot->len = lens[i];
+#if OSAL_QUEUE_STATS
+		slot->stamp = stamp;
+#endif
+		memcpy(slot->data, msgs[i], lens[i]);
+	}
+	*sent = i;
+	if (i == 0) {
+		return OSAL_E_QFULL;
+	}
+	spsc_publish(queue, lane, head + i);
+	return (i == n) ? OSAL_E_OK : OSAL_E_QFULL;
+}
+
+static osal_error_t queue_spsc_recv_batch(osal_queue_t *queue, uint8_t *bufs[],
+										  uint32_t lens[], uint32_t bufsize,
+										  uint32_t n, uint32_t *got,
+										  uint32_t timeout_usec)
+{
+	spsc_ring_t *ring = queue->ring;
+	spsc_lane_t *lane;
+	spsc_slot_t *slot;
+	osal_error_t res;
+	int32_t ready;
+	uint32_t tail;
+	uint32_t i = 0;
+
+	*got = 0;
+	res = spsc_wait(ring, timeout_usec, &ready);
+	if (res != OSAL_E_OK) {
+		return res;
+	}
+	/* drain the lanes from the highest, each tail is stored once */
+	for (; (ready >= 0) && (i < n); ready--) {
+		lane = &ring->lanes[ready];
+		if (lane->head_cache - lane->tail < n - i) {
+			lane->head_cache = __atomic_load_n(&lane->head, __ATOMIC_ACQUIRE);
+		}
+		for (tail = lane->tail; (i < n) && (tail != lane->head_cache); tail++, i++) {
+			slot = spsc_slot(ring, ready, tail);
+			if (slot->len > bufsize) {
+				break;
+			}
+			lens[i] = slot->len;
+			memcpy(bufs[i], slot->data, slot->len);
+#if OSAL_QUEUE_STATS
+			queue_stats_latency(queue, slot->stamp);
+#endif
+		}
+		spsc_consume(ring, lane, tail);
+		if ((tail != lane->head_cache) && (i < n)) {
+			/* stopped on a message longer than the buffers */
+			break;
+		}
+	}
+	if (i == 0) {
+		return OSAL_E_PARAM;
+	}
+	*got = i;
+	return OSAL_E_OK;
+}
+
+static uint32_t queue_spsc_count(osal_queue_t *queue)
+{
+	spsc_ring_t *ring = queue->ring;
+	spsc_lane_t *lane;
+	uint32_t count = 0;
+	uint32_t i;
+
+	for (i = 0; i < ring->n_lanes; i++) {
+		lane = &ring->lanes[i];
+		count += __atomic_load_n(&lane->head, __ATOMIC_RELAXED) -
+			__atomic_load_n(&lane->tail, __ATOMIC_RELAXED);
+	}
+	return count;
+}
+
+static bool queue_spsc_set_arm(osal_queue_t *queue, int32_t delta)
+{
+	spsc_ring_t *ring = queue->ring;
+	spsc_lane_t *lane;
+	uint32_t i;
+
+	/* pairs with the fence of spsc_publish, as in spsc_wait */
+	__atomic_fetch_add(&ring->waiters, delta, __ATOMIC_SEQ_CST);
+	/* the head caches belong to the consumer, read the indexes themselves */
+	for (i = 0; i < ring->n_lanes; i++) {
+		lane = &ring->lanes[i];
+		if (__atomic_load_n(&lane->head, __ATOMIC_SEQ_CST) !=
+			__atomic_load_n(&lane->tail, __ATOMIC_RELAXED)) {
+			return true;
+		}
+	}
+	return false;
+}
+
+const queue_backend_t queue_spsc_backend = {
+	.create = queue_spsc_create,
+	.destroy = queue_spsc_destroy,
+	.send = queue_spsc_send,
+	.recv = queue_spsc_recv,
+	.reserve = queue_spsc_reserve,
+	.commit = queue_spsc_commit,
+	.peek = queue_spsc_peek,
+	.release = queue_spsc_release,
+	.count = queue_spsc_count,
+	.send_batch = queue_spsc_send_batch,
+	.recv_batch = queue_spsc_recv_batch,
+	.set_fd = queue_set_eventfd,
+	.set_arm = queue_spsc_set_arm,
+};
@@ -146,6 +146,28 @@ osal_error_t osal_sem_waittime(osal_sem_t *sem, uint32_t usec)
 	return OSAL_E_OK;
 }
 
+osal_handle_t osal_sem_handle(osal_sem_t *sem)
+{
+	if (sem == NULL) {
+		return OSAL_HANDLE_INVALID;
+	}
+	return osal_rm_handle(&s_sem_man.rm, sem->resrc);
+}
+
+osal_sem_t *osal_sem_resolve(osal_handle_t handle)
+{
+	osal_resrc_t *resrc;
+
+	if (s_sem_man.init == false) {
+		return NULL;
+	}
+	resrc = osal_rm_resolve(&s_sem_man.rm, handle);
+	if (resrc == NULL) {
+		return NULL;
+	}
+	return resrc->data;
+}
+
 uint32_t osal_sem_use(void)
 {
 	if (s_sem_man.init == false) {
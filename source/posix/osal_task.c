@@ -106,6 +106,28 @@ void osal_task_delete(osal_task_t *task)
 	osal_rm_free(&s_task_man.rm, task->resrc);
 }
 
+osal_handle_t osal_task_handle(osal_task_t *task)
+{
+	if (task == NULL) {
+		return OSAL_HANDLE_INVALID;
+	}
+	return osal_rm_handle(&s_task_man.rm, task->resrc);
+}
+
+osal_task_t *osal_task_resolve(osal_handle_t handle)
+{
+	osal_resrc_t *resrc;
+
+	if (s_task_man.init == false) {
+		return NULL;
+	}
+	resrc = osal_rm_resolve(&s_task_man.rm, handle);
+	if (resrc == NULL) {
+		return NULL;
+	}
+	return resrc->data;
+}
+
 uint32_t osal_task_use(void)
 {
 	if (s_task_man.init == false) {
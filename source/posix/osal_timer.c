@@ -118,14 +118,17 @@ osal_timer_t *osal_timer_create(void (*expire)(void *arg), void *arg)
 
 void osal_timer_delete(osal_timer_t *timer)
 {
+	osal_resrc_t *resrc;
+
 	if (timer == NULL) {
 		return;
 	}
 	if (timer->timerid) {
 		timer_delete(timer->timerid);
 	}
+	resrc = timer->resrc;
 	memset(timer, 0, sizeof(osal_timer_t));
-	osal_rm_free(&s_timer_man.rm, timer->resrc);
+	osal_rm_free(&s_timer_man.rm, resrc);
 }
 
 osal_error_t osal_timer_start(osal_timer_t *timer, uint32_t usec, bool repeat)
@@ -162,6 +165,28 @@ void osal_timer_stop(osal_timer_t *timer)
 	}
 }
 
+osal_handle_t osal_timer_handle(osal_timer_t *timer)
+{
+	if (timer == NULL) {
+		return OSAL_HANDLE_INVALID;
+	}
+	return osal_rm_handle(&s_timer_man.rm, timer->resrc);
+}
+
+osal_timer_t *osal_timer_resolve(osal_handle_t handle)
+{
+	osal_resrc_t *resrc;
+
+	if (s_timer_man.init == false) {
+		return NULL;
+	}
+	resrc = osal_rm_resolve(&s_timer_man.rm, handle);
+	if (resrc == NULL) {
+		return NULL;
+	}
+	return resrc->data;
+}
+
 uint32_t osal_timer_use(void)
 {
 	if (s_timer_man.init == false) {
@@ -0,0 +1,274 @@
+/* BSD 2-Clause License
+*
+* Copyright (c) 2025, nguyenvannam142@gmail.com
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*
+* 1. Redistributions of source code must retain the above copyright notice, this
+*    list of conditions and the following disclaimer.
+*
+* 2. Redistributions in binary form must reproduce the above copyright notice,
+*    this list of conditions and the following disclaimer in the documentation
+*    and/or other materials provided with the distribution.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <pthread.h>
+#include "cmocka_include.h"
+#include "osal.h"
+
+#define MSG_LEN 64
+#define QUEUE_SIZE 8
+#define NUM_MSGS 100000
+#define NUM_SUBS 3
+#define RECV_TIMEOUT_USEC OSAL_SEC_USEC
+
+static osal_channel_t *channel_create(osal_channel_policy_t policy)
+{
+	osal_channel_cfg_t cfg = {
+		.msglen = MSG_LEN,
+		.qsize = QUEUE_SIZE,
+		.policy = policy,
+	};
+
+	return osal_channel_create(&cfg);
+}
+
+static void test_channel_cfg(void **state)
+{
+	osal_channel_cfg_t cfg = {
+		.msglen = MSG_LEN,
+		.qsize = QUEUE_SIZE,
+	};
+	osal_channel_sub_t *subs[OSAL_CHANNEL_SUB_MAX];
+	osal_channel_t *channel;
+	uint8_t buf[MSG_LEN];
+	uint32_t len;
+	uint32_t i;
+	(void)state;
+
+	assert_int_equal(osal_init(NULL), OSAL_E_OK);
+	assert_null(osal_channel_create(NULL));
+	cfg.policy = OSAL_CHANNEL_POLICY_MAX;
+	assert_null(osal_channel_create(&cfg));
+	cfg.policy = OSAL_CHANNEL_DROP_OLDEST;
+	cfg.qsize = 0;
+	assert_null(osal_channel_create(&cfg));
+	cfg.qsize = QUEUE_SIZE;
+	channel = osal_channel_create(&cfg);
+	assert_non_null(channel);
+	assert_int_equal(osal_channel_use(), 1);
+
+	assert_int_equal(osal_channel_publish(channel, buf, MSG_LEN+1, 0), OSAL_E_PARAM);
+	assert_int_equal(osal_channel_recv(NULL, buf, sizeof(buf), &len, 0), OSAL_E_PARAM);
+	for (i = 0; i < OSAL_CHANNEL_SUB_MAX; i++) {
+		subs[i] = osal_channel_subscribe(channel);
+		assert_non_null(subs[i]);
+	}
+	assert_null(osal_channel_subscribe(channel));
+	osal_channel_unsubscribe(subs[0]);
+	assert_int_equal(osal_channel_recv(subs[0], buf, sizeof(buf), &len, 0), OSAL_E_PARAM);
+	assert_ptr_equal(osal_channel_subscribe(channel), subs[0]);
+
+	/* a too long message is left for a larger buffer */
+	assert_int_equal(osal_channel_publish(channel, buf, MSG_LEN, 0), OSAL_E_OK);
+	assert_int_equal(osal_channel_recv(subs[0], buf, 1, &len, 0), OSAL_E_PARAM);
+	assert_int_equal(osal_channel_recv(subs[0], buf, sizeof(buf), &len, 0), OSAL_E_OK);
+	assert_int_equal(len, MSG_LEN);
+
+	osal_channel_delete(channel);
+	assert_int_equal(osal_channel_use(), 0);
+	osal_deinit();
+}
+
+static void test_channel_fanout(void **state)
+{
+	osal_channel_sub_t *subs[NUM_SUBS];
+	osal_channel_t *channel;
+	uint8_t buf[MSG_LEN];
+	uint8_t msg[MSG_LEN];
+	uint32_t len;
+	uint32_t i;
+	uint32_t j;
+	(void)state;
+
+	assert_int_equal(osal_init(NULL), OSAL_E_OK);
+	channel = channel_create(OSAL_CHANNEL_DROP_OLDEST);
+	assert_non_null(channel);
+
+	/* a subscriber only gets what is published after it subscribed */
+	assert_int_equal(osal_channel_publish(channel, msg, 1, 0), OSAL_E_OK);
+	for (j = 0; j < NUM_SUBS; j++) {
+		subs[j] = osal_channel_subscribe(channel);
+		assert_non_null(subs[j]);
+		assert_int_equal(osal_channel_recv(subs[j], buf, sizeof(buf), &len, 0),
+						 OSAL_E_TIMEOUT);
+	}
+
+	for (i = 0; i < QUEUE_SIZE; i++) {
+		memset(msg, i, i+1);
+		assert_int_equal(osal_channel_publish(channel, msg, i+1, 0), OSAL_E_OK);
+	}
+	for (j = 0; j < NUM_SUBS; j++) {
+		for (i = 0; i < QUEUE_SIZE; i++) {
+			assert_int_equal(osal_channel_recv(subs[j], buf, sizeof(buf), &len, 0),
+							 OSAL_E_OK);
+			assert_int_equal(len, i+1);
+			assert_int_equal(buf[i], i);
+		}
+		assert_int_equal(osal_channel_recv(subs[j], buf, sizeof(buf), &len, 1000),
+						 OSAL_E_TIMEOUT);
+		assert_int_equal(osal_channel_dropped(subs[j]), 0);
+	}
+
+	osal_channel_delete(channel);
+	osal_deinit();
+}
+
+static void test_channel_drop(void **state)
+{
+	osal_channel_sub_t *fast;
+	osal_channel_sub_t *slow;
+	osal_channel_t *channel;
+	uint8_t buf[MSG_LEN];
+	uint8_t msg;
+	uint32_t len;
+	uint32_t i;
+	(void)state;
+
+	assert_int_equal(osal_init(NULL), OSAL_E_OK);
+	channel = channel_create(OSAL_CHANNEL_DROP_OLDEST);
+	assert_non_null(channel);
+	fast = osal_channel_subscribe(channel);
+	slow = osal_channel_subscribe(channel);
+
+	/* the publisher never waits, the slow subscriber loses the oldest */
+	for (i = 0; i < QUEUE_SIZE+3; i++) {
+		msg = i;
+		assert_int_equal(osal_channel_publish(channel, &msg, 1, 0), OSAL_E_OK);
+		assert_int_equal(osal_channel_recv(fast, buf, sizeof(buf), &len, 0), OSAL_E_OK);
+		assert_int_equal(buf[0], i);
+	}
+	for (i = 3; i < QUEUE_SIZE+3; i++) {
+		assert_int_equal(osal_channel_recv(slow, buf, sizeof(buf), &len, 0), OSAL_E_OK);
+		assert_int_equal(buf[0], i);
+	}
+	assert_int_equal(osal_channel_dropped(slow), 3);
+	assert_int_equal(osal_channel_dropped(fast), 0);
+
+	osal_channel_delete(channel);
+	osal_deinit();
+}
+
+static void test_channel_block(void **state)
+{
+	osal_channel_sub_t *fast;
+	osal_channel_sub_t *slow;
+	osal_channel_t *channel;
+	uint8_t buf[MSG_LEN];
+	uint8_t msg = 0;
+	uint32_t len;
+	uint32_t i;
+	(void)state;
+
+	assert_int_equal(osal_init(NULL), OSAL_E_OK);
+	channel = channel_create(OSAL_CHANNEL_BLOCK);
+	assert_non_null(channel);
+	fast = osal_channel_subscribe(channel);
+	slow = osal_channel_subscribe(channel);
+
+	/* the publisher stops a ring ahead of the slowest subscriber */
+	for (i = 0; i < QUEUE_SIZE; i++) {
+		assert_int_equal(osal_channel_publish(channel, &msg, 1, 0), OSAL_E_OK);
+		assert_int_equal(osal_channel_recv(fast, buf, sizeof(buf), &len, 0), OSAL_E_OK);
+	}
+	assert_int_equal(osal_channel_publish(channel, &msg, 1, 0), OSAL_E_QFULL);
+	assert_int_equal(osal_channel_publish(channel, &msg, 1, 1000), OSAL_E_TIMEOUT);
+	assert_int_equal(osal_channel_recv(slow, buf, sizeof(buf), &len, 0), OSAL_E_OK);
+	assert_int_equal(osal_channel_publish(channel, &msg, 1, 0), OSAL_E_OK);
+	assert_int_equal(osal_channel_publish(channel, &msg, 1, 0), OSAL_E_QFULL);
+
+	/* a subscriber leaving does not hold the publisher anymore */
+	osal_channel_unsubscribe(slow);
+	assert_int_equal(osal_channel_publish(channel, &msg, 1, 0), OSAL_E_OK);
+	assert_int_equal(osal_channel_dropped(fast), 0);
+
+	osal_channel_delete(channel);
+	osal_deinit();
+}
+
+static void *channel_subscriber(void *arg)
+{
+	osal_channel_sub_t *sub = arg;
+	uint8_t buf[MSG_LEN];
+	uint32_t val;
+	uint32_t len;
+	uint32_t i;
+
+	for (i = 0; i < NUM_MSGS; i++) {
+		if (osal_channel_recv(sub, buf, sizeof(buf), &len,
+							  RECV_TIMEOUT_USEC) != OSAL_E_OK) {
+			break;
+		}
+		memcpy(&val, buf, sizeof(val));
+		if (val != i) {
+			break;
+		}
+	}
+	return (void *)(uintptr_t)i;
+}
+
+static void test_channel_thread(void **state)
+{
+	osal_channel_sub_t *subs[NUM_SUBS];
+	pthread_t tids[NUM_SUBS];
+	osal_channel_t *channel;
+	void *received;
+	uint32_t i;
+	(void)state;
+
+	assert_int_equal(osal_init(NULL), OSAL_E_OK);
+	channel = channel_create(OSAL_CHANNEL_BLOCK);
+	assert_non_null(channel);
+
+	/* each subscriber sleeps on the empty ring and gets all in order */
+	for (i = 0; i < NUM_SUBS; i++) {
+		subs[i] = osal_channel_subscribe(channel);
+		assert_non_null(subs[i]);
+		assert_int_equal(pthread_create(&tids[i], NULL, channel_subscriber, subs[i]), 0);
+	}
+	for (i = 0; i < NUM_MSGS; i++) {
+		assert_int_equal(osal_channel_publish(channel, (uint8_t *)&i, sizeof(i),
+											  RECV_TIMEOUT_USEC), OSAL_E_OK);
+	}
+	for (i = 0; i < NUM_SUBS; i++) {
+		pthread_join(tids[i], &received);
+		assert_int_equal((uintptr_t)received, NUM_MSGS);
+	}
+
+	osal_channel_delete(channel);
+	osal_deinit();
+}
+
+int main(void)
+{
+	const struct CMUnitTest tests[] = {
+		cmocka_unit_test(test_channel_cfg),
+		cmocka_unit_test(test_channel_fanout),
+		cmocka_unit_test(test_channel_drop),
+		cmocka_unit_test(test_channel_block),
+		cmocka_unit_test(test_channel_thread),
+	};
+	return cmocka_run_group_tests(tests, NULL, NULL);
+}
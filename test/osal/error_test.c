@@ -63,6 +63,8 @@ static void test_error(void **state)
 	assert_string_equal(estr, "OSAL_E_INUSE");
 	estr = osal_errstr(OSAL_E_NOINIT);
 	assert_string_equal(estr, "OSAL_E_NOINIT");
+	estr = osal_errstr(OSAL_E_NOSUPPORT);
+	assert_string_equal(estr, "OSAL_E_NOSUPPORT");
 }
 
 int main(void)
@@ -0,0 +1,171 @@
+/* BSD 2-Clause License
+*
+* Copyright (c) 2025, nguyenvannam142@gmail.com
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*
+* 1. Redistributions of source code must retain the above copyright notice, this
+*    list of conditions and the following disclaimer.
+*
+* 2. Redistributions in binary form must reproduce the above copyright notice,
+*    this list of conditions and the following disclaimer in the documentation
+*    and/or other materials provided with the distribution.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <pthread.h>
+#include "cmocka_include.h"
+#include "osal.h"
+
+#define NUM_NODES 100
+#define NUM_THREADS 4
+#define NUM_LOOPS 100000
+
+typedef struct {
+	osal_fifo_node_t node;
+	int data;
+} fifo_data_t;
+
+static void test_fifo(void **state)
+{
+	fifo_data_t fifodatas[NUM_NODES];
+	osal_fifo_t fifo;
+	fifo_data_t *nodedata;
+	int i;
+	(void)state;
+
+	osal_fifo_init(&fifo);
+	assert_int_equal(osal_fifo_size(&fifo), 0);
+	assert_true(osal_fifo_is_empty(&fifo));
+	assert_null(osal_fifo_pop(&fifo));
+
+	for (i = 0; i < NUM_NODES; i++) {
+		fifodatas[i].data = i+1;
+		osal_fifo_push(&fifo, &fifodatas[i].node);
+		assert_int_equal(osal_fifo_size(&fifo), i+1);
+	}
+
+	/* the nodes come back in the push order */
+	for (i = 0; i < NUM_NODES; i++) {
+		nodedata = (fifo_data_t *)osal_fifo_pop(&fifo);
+		assert_non_null(nodedata);
+		assert_int_equal(nodedata->data, i+1);
+		assert_int_equal(osal_fifo_size(&fifo), NUM_NODES-i-1);
+	}
+	assert_null(osal_fifo_pop(&fifo));
+	assert_true(osal_fifo_is_empty(&fifo));
+
+	/* a node can be pushed again once popped, also into an emptied FIFO */
+	for (i = 0; i < NUM_NODES; i++) {
+		osal_fifo_push(&fifo, &fifodatas[i].node);
+		nodedata = (fifo_data_t *)osal_fifo_pop(&fifo);
+		assert_ptr_equal(nodedata, &fifodatas[i]);
+		assert_null(osal_fifo_pop(&fifo));
+	}
+}
+
+static void test_fifo_drain(void **state)
+{
+	fifo_data_t fifodatas[NUM_NODES];
+	osal_fifo_node_t *nodes[NUM_NODES];
+	osal_fifo_t fifo;
+	uint32_t n;
+	int i;
+	(void)state;
+
+	osal_fifo_init(&fifo);
+	assert_int_equal(osal_fifo_drain(&fifo, nodes, NUM_NODES), 0);
+	for (i = 0; i < NUM_NODES; i++) {
+		fifodatas[i].data = i;
+		osal_fifo_push(&fifo, &fifodatas[i].node);
+	}
+	n = osal_fifo_drain(&fifo, nodes, 30);
+	assert_int_equal(n, 30);
+	n += osal_fifo_drain(&fifo, &nodes[n], NUM_NODES);
+	assert_int_equal(n, NUM_NODES);
+	for (i = 0; i < NUM_NODES; i++) {
+		assert_int_equal(((fifo_data_t *)nodes[i])->data, i);
+	}
+	assert_true(osal_fifo_is_empty(&fifo));
+}
+
+typedef struct {
+	osal_fifo_t *fifo;
+	fifo_data_t *datas;
+} fifo_producer_t;
+
+static void *fifo_producer(void *arg)
+{
+	fifo_producer_t *producer = arg;
+	int i;
+
+	for (i = 0; i < NUM_LOOPS; i++) {
+		producer->datas[i].data = i;
+		osal_fifo_push(producer->fifo, &producer->datas[i].node);
+	}
+	return NULL;
+}
+
+static void test_fifo_threads(void **state)
+{
+	static fifo_data_t fifodatas[NUM_THREADS][NUM_LOOPS];
+	fifo_producer_t producers[NUM_THREADS];
+	pthread_t tids[NUM_THREADS];
+	int expected[NUM_THREADS] = {0};
+	fifo_data_t *nodedata;
+	osal_fifo_t fifo;
+	int popped = 0;
+	int producer;
+	int i;
+	(void)state;
+
+	osal_fifo_init(&fifo);
+	for (i = 0; i < NUM_THREADS; i++) {
+		producers[i].fifo = &fifo;
+		producers[i].datas = fifodatas[i];
+		assert_int_equal(pthread_create(&tids[i], NULL, fifo_producer,
+										&producers[i]), 0);
+	}
+
+	/* every node comes out once and in the order of its producer */
+	while (popped < NUM_THREADS * NUM_LOOPS) {
+		nodedata = (fifo_data_t *)osal_fifo_pop(&fifo);
+		if (nodedata == NULL) {
+			continue;
+		}
+		producer = (nodedata - &fifodatas[0][0]) / NUM_LOOPS;
+		assert_true((producer >= 0) && (producer < NUM_THREADS));
+		assert_int_equal(nodedata->data, expected[producer]);
+		expected[producer]++;
+		popped++;
+	}
+	for (i = 0; i < NUM_THREADS; i++) {
+		pthread_join(tids[i], NULL);
+		assert_int_equal(expected[i], NUM_LOOPS);
+	}
+	assert_null(osal_fifo_pop(&fifo));
+	assert_int_equal(osal_fifo_size(&fifo), 0);
+}
+
+int main(void)
+{
+	setenv("CMOCKA_TEST_ABORT", "1", 1);
+
+	const struct CMUnitTest tests[] = {
+		cmocka_unit_test(test_fifo),
+		cmocka_unit_test(test_fifo_drain),
+		cmocka_unit_test(test_fifo_threads),
+	};
+	return cmocka_run_group_tests(tests, NULL, NULL);
+}
@@ -24,10 +24,13 @@
 * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 */
 
+#include <pthread.h>
 #include "cmocka_include.h"
 #include "osal.h"
 
 #define NUM_NODES 100
+#define NUM_THREADS 4
+#define NUM_LOOPS 100000
 
 typedef struct {
 	osal_lifo_node_t node;
@@ -68,12 +71,165 @@ static void test_lifo(void **state)
 	assert_null(nodedata);
 }
 
+static void test_lifo_atomic(void **state)
+{
+	(void)state;
+	lifo_data_t lifodatas[NUM_NODES];
+	osal_lifo_atomic_t lifo;
+	int size;
+	int i;
+	lifo_data_t *nodedata;
+
+	osal_lifo_atomic_init(&lifo, &lifodatas[0].node, sizeof(lifo_data_t));
+	size = osal_lifo_atomic_size(&lifo);
+	assert_int_equal(size, 0);
+
+	for (i = 0; i < NUM_NODES; i++) {
+		lifodatas[i].data = i+1;
+		osal_lifo_atomic_push(&lifo, &lifodatas[i].node);
+		size = osal_lifo_atomic_size(&lifo);
+		assert_int_equal(size, i+1);
+	}
+
+	for (i = 0; i < NUM_NODES; i++) {
+		size = osal_lifo_atomic_size(&lifo);
+		assert_int_equal(size, NUM_NODES-i);
+
+		nodedata = (lifo_data_t *)osal_lifo_atomic_pop(&lifo);
+		assert_non_null(nodedata);
+		assert_int_equal(nodedata->data, NUM_NODES-i);
+	}
+	size = osal_lifo_atomic_size(&lifo);
+	assert_int_equal(size, 0);
+	nodedata = (lifo_data_t *)osal_lifo_atomic_pop(&lifo);
+	assert_null(nodedata);
+}
+
+static void test_lifo_chain(void **state)
+{
+	(void)state;
+	lifo_data_t lifodatas[NUM_NODES];
+	osal_lifo_t lifo;
+	osal_lifo_atomic_t alifo;
+	osal_lifo_node_t *node;
+	uint32_t popped;
+	int i;
+
+	for (i = 0; i < NUM_NODES; i++) {
+		lifodatas[i].data = i+1;
+		if (i + 1 < NUM_NODES) {
+			lifodatas[i].node.next = &lifodatas[i+1].node;
+		}
+	}
+	osal_lifo_init(&lifo);
+	osal_lifo_push(&lifo, &lifodatas[NUM_NODES-1].node);
+	osal_lifo_push_chain(&lifo, &lifodatas[0].node,
+						 &lifodatas[NUM_NODES-2].node, NUM_NODES-1);
+	assert_int_equal(osal_lifo_size(&lifo), NUM_NODES);
+
+	node = osal_lifo_pop_n(&lifo, 10, &popped);
+	assert_int_equal(popped, 10);
+	assert_int_equal(osal_lifo_size(&lifo), NUM_NODES-10);
+	for (i = 0; i < 10; i++) {
+		assert_non_null(node);
+		assert_int_equal(((lifo_data_t *)node)->data, i+1);
+		node = node->next;
+	}
+	assert_null(node);
+	node = osal_lifo_pop_n(&lifo, NUM_NODES, &popped);
+	assert_int_equal(popped, NUM_NODES-10);
+	assert_int_equal(((lifo_data_t *)node)->data, 11);
+	assert_true(osal_lifo_is_empty(&lifo));
+	assert_null(osal_lifo_pop_n(&lifo, 1, &popped));
+	assert_int_equal(popped, 0);
+
+	for (i = 0; i + 1 < NUM_NODES; i++) {
+		lifodatas[i].node.next = &lifodatas[i+1].node;
+	}
+	osal_lifo_atomic_init(&alifo, &lifodatas[0].node, sizeof(lifo_data_t));
+	osal_lifo_atomic_push(&alifo, &lifodatas[NUM_NODES-1].node);
+	osal_lifo_atomic_push_chain(&alifo, &lifodatas[0].node,
+								&lifodatas[NUM_NODES-2].node, NUM_NODES-1);
+	assert_int_equal(osal_lifo_atomic_size(&alifo), NUM_NODES);
+
+	node = osal_lifo_atomic_pop_n(&alifo, 10, &popped);
+	assert_int_equal(popped, 10);
+	assert_int_equal(osal_lifo_atomic_size(&alifo), NUM_NODES-10);
+	for (i = 0; i < 10; i++) {
+		assert_non_null(node);
+		assert_int_equal(((lifo_data_t *)node)->data, i+1);
+		node = node->next;
+	}
+	assert_null(node);
+	node = osal_lifo_atomic_pop(&alifo);
+	assert_int_equal(((lifo_data_t *)node)->data, 11);
+	node = osal_lifo_atomic_pop_n(&alifo, NUM_NODES, &popped);
+	assert_int_equal(popped, NUM_NODES-11);
+	assert_int_equal(osal_lifo_atomic_size(&alifo), 0);
+	assert_null(osal_lifo_atomic_pop_n(&alifo, 1, &popped));
+	assert_int_equal(popped, 0);
+}
+
+static void *lifo_atomic_thread(void *arg)
+{
+	osal_lifo_atomic_t *lifo = arg;
+	lifo_data_t *nodedata;
+	int i;
+
+	for (i = 0; i < NUM_LOOPS; i++) {
+		nodedata = (lifo_data_t *)osal_lifo_atomic_pop(lifo);
+		if (nodedata == NULL) {
+			continue;
+		}
+		/* nobody else may hold the same node */
+		assert_int_equal(__atomic_fetch_add(&nodedata->data, 1,
+											__ATOMIC_RELAXED), 0);
+		__atomic_store_n(&nodedata->data, 0, __ATOMIC_RELAXED);
+		osal_lifo_atomic_push(lifo, &nodedata->node);
+	}
+	return NULL;
+}
+
+static void test_lifo_atomic_threads(void **state)
+{
+	(void)state;
+	lifo_data_t lifodatas[NUM_THREADS];
+	osal_lifo_atomic_t lifo;
+	pthread_t tids[NUM_THREADS];
+	lifo_data_t *nodedata;
+	int i;
+
+	osal_lifo_atomic_init(&lifo, &lifodatas[0].node, sizeof(lifo_data_t));
+	/* less nodes than threads, so the pop races on the same nodes */
+	for (i = 0; i < NUM_THREADS-1; i++) {
+		lifodatas[i].data = 0;
+		osal_lifo_atomic_push(&lifo, &lifodatas[i].node);
+	}
+	for (i = 0; i < NUM_THREADS; i++) {
+		assert_int_equal(pthread_create(&tids[i], NULL, lifo_atomic_thread,
+										&lifo), 0);
+	}
+	for (i = 0; i < NUM_THREADS; i++) {
+		pthread_join(tids[i], NULL);
+	}
+	assert_int_equal(osal_lifo_atomic_size(&lifo), NUM_THREADS-1);
+	for (i = 0; i < NUM_THREADS-1; i++) {
+		nodedata = (lifo_data_t *)osal_lifo_atomic_pop(&lifo);
+		assert_non_null(nodedata);
+		assert_int_equal(nodedata->data, 0);
+	}
+	assert_null(osal_lifo_atomic_pop(&lifo));
+}
+
 int main(void)
 {
 	setenv("CMOCKA_TEST_ABORT", "1", 1);
 
 	const struct CMUnitTest tests[] = {
 		cmocka_unit_test(test_lifo),
+		cmocka_unit_test(test_lifo_atomic),
+		cmocka_unit_test(test_lifo_atomic_threads),
+		cmocka_unit_test(test_lifo_chain),
 	};
 	return cmocka_run_group_tests(tests, NULL, NULL);
 }
@@ -0,0 +1,163 @@
+/* BSD 2-Clause License
+*
+* Copyright (c) 2025, nguyenvannam142@gmail.com
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*
+* 1. Redistributions of source code must retain the above copyright notice, this
+*    list of conditions and the following disclaimer.
+*
+* 2. Redistributions in binary form must reproduce the above copyright notice,
+*    this list of conditions and the following disclaimer in the documentation
+*    and/or other materials provided with the distribution.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <sys/resource.h>
+#include "cmocka_include.h"
+#include "osal.h"
+
+#define REGION_SIZE (1024 * 1024)
+
+static long minor_faults(void)
+{
+	struct rusage usage;
+
+	getrusage(RUSAGE_SELF, &usage);
+	return usage.ru_minflt;
+}
+
+static void test_mem_heap(void **state)
+{
+	osal_mem_info_t info;
+	uint8_t *ptr;
+	(void)state;
+
+	assert_int_equal(osal_mem_init(NULL), OSAL_E_OK);
+	osal_mem_info(&info);
+	assert_int_equal(info.size, 0);
+
+	/* without a region the memory comes from the heap */
+	assert_null(osal_mem_alloc(0));
+	ptr = osal_mem_alloc(100);
+	assert_non_null(ptr);
+	assert_int_equal((uintptr_t)ptr % OSAL_MEM_ALIGN, 0);
+	osal_mem_free(ptr);
+	osal_mem_deinit();
+}
+
+static void test_mem_region(void **state)
+{
+	osal_mem_cfg_t cfg = {0};
+	osal_mem_info_t info;
+	uint8_t *ptr;
+	uint8_t *heap;
+	long faults;
+	(void)state;
+
+	cfg.size = REGION_SIZE;
+	cfg.hugepage = true;
+	assert_int_equal(osal_mem_init(&cfg), OSAL_E_OK);
+	osal_mem_info(&info);
+	assert_true(info.size >= REGION_SIZE);
+	assert_int_equal(info.used, 0);
+
+	/* each block takes a header of OSAL_MEM_ALIGN bytes */
+	ptr = osal_mem_alloc(REGION_SIZE - OSAL_MEM_ALIGN);
+	assert_non_null(ptr);
+	assert_int_equal((uintptr_t)ptr % OSAL_MEM_ALIGN, 0);
+	osal_mem_info(&info);
+	assert_int_equal(info.used, REGION_SIZE);
+	assert_int_equal(info.free, 0);
+
+	/* the pages were faulted in by the init */
+	faults = minor_faults();
+	memset(ptr, 0x5a, REGION_SIZE - OSAL_MEM_ALIGN);
+	assert_true(minor_faults() - faults < 16);
+
+	/* an exhausted region falls back to the heap, and counts it */
+	if (info.size == REGION_SIZE) {
+		heap = osal_mem_alloc(1);
+		assert_non_null(heap);
+		assert_true((heap < ptr) || (heap >= ptr + info.size));
+		osal_mem_free(heap);
+		osal_mem_info(&info);
+		assert_int_equal(info.heap_allocs, 1);
+	}
+
+	/* a freed block is handed out again */
+	osal_mem_free(ptr);
+	osal_mem_info(&info);
+	assert_int_equal(info.used, REGION_SIZE);
+	assert_int_equal(info.free, REGION_SIZE);
+	assert_ptr_equal(osal_mem_alloc(REGION_SIZE - OSAL_MEM_ALIGN), ptr);
+	osal_mem_info(&info);
+	assert_int_equal(info.free, 0);
+	osal_mem_free(ptr);
+
+	osal_mem_deinit();
+	osal_mem_info(&info);
+	assert_int_equal(info.size, 0);
+}
+
+static void test_mem_osal_init(void **state)
+{
+	osal_config_t config = {0};
+	osal_queue_cfg_t qcfg = {
+		.msglen = 64,
+		.qsize = 16,
+		.type = OSAL_QUEUE_TYPE_MPMC,
+	};
+	osal_mem_info_t info;
+	size_t used;
+	int i;
+	(void)state;
+
+	config.osal_level = OSALOG_LEVEL_INFO;
+	config.mem.size = REGION_SIZE;
+	assert_int_equal(osal_init(&config), OSAL_E_OK);
+
+	/* the memory pool took its blocks from the region */
+	osal_mem_info(&info);
+	assert_true(info.used > 0);
+	assert_non_null(osal_mempool_alloc(1));
+
+	/* deleted queues give their rings back to the next ones */
+	osal_queue_delete(osal_queue_create(&qcfg));
+	osal_mem_info(&info);
+	used = info.used;
+	for (i = 0; i < 100; i++) {
+		osal_queue_delete(osal_queue_create(&qcfg));
+	}
+	osal_mem_info(&info);
+	assert_int_equal(info.used, used);
+	assert_int_equal(info.heap_allocs, 0);
+	osal_print_resource();
+
+	osal_deinit();
+	osal_mem_info(&info);
+	assert_int_equal(info.size, 0);
+}
+
+int main(void)
+{
+	setenv("CMOCKA_TEST_ABORT", "1", 1);
+
+	const struct CMUnitTest tests[] = {
+		cmocka_unit_test(test_mem_heap),
+		cmocka_unit_test(test_mem_region),
+		cmocka_unit_test(test_mem_osal_init),
+	};
+	return cmocka_run_group_tests(tests, NULL, NULL);
+}
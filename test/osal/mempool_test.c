@@ -0,0 +1,120 @@
+/* BSD 2-Clause License
+*
+* Copyright (c) 2025, nguyenvannam142@gmail.com
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*
+* 1. Redistributions of source code must retain the above copyright notice, this
+*    list of conditions and the following disclaimer.
+*
+* 2. Redistributions in binary form must reproduce the above copyright notice,
+*    this list of conditions and the following disclaimer in the documentation
+*    and/or other materials provided with the distribution.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "cmocka_include.h"
+#include "osal.h"
+
+static const uint32_t s_nums[OSAL_MEMPOOL_CLASS_NUM] = {
+	OSAL_MEMPOOL_NUM_0,
+	OSAL_MEMPOOL_NUM_1,
+	OSAL_MEMPOOL_NUM_2,
+	OSAL_MEMPOOL_NUM_3,
+};
+
+static void test_mempool_class(void **state)
+{
+	uint8_t *blocks[OSAL_MEMPOOL_NUM_0];
+	uint32_t size;
+	uint32_t i;
+	uint32_t j;
+	(void)state;
+
+	assert_null(osal_mempool_alloc(1));
+	assert_int_equal(osal_mempool_init(NULL), OSAL_E_OK);
+
+	for (i = 0; i < OSAL_MEMPOOL_CLASS_NUM; i++) {
+		size = osal_mempool_class_size(i);
+		assert_int_equal(osal_mempool_use(i), 0);
+		assert_int_equal(osal_mempool_avail(i), s_nums[i]);
+
+		/* the block is taken from the smallest fitting class */
+		blocks[0] = osal_mempool_alloc(size);
+		assert_non_null(blocks[0]);
+		assert_int_equal((uintptr_t)blocks[0] % OSAL_MEMPOOL_ALIGN, 0);
+		memset(blocks[0], 0xa5, size);
+		assert_int_equal(osal_mempool_use(i), 1);
+		for (j = 0; j < OSAL_MEMPOOL_CLASS_NUM; j++) {
+			if (j != i) {
+				assert_int_equal(osal_mempool_use(j), 0);
+			}
+		}
+		osal_mempool_free(blocks[0]);
+		assert_int_equal(osal_mempool_use(i), 0);
+	}
+	assert_int_equal(osal_mempool_class_size(OSAL_MEMPOOL_CLASS_NUM), 0);
+	assert_null(osal_mempool_alloc(OSAL_MEMPOOL_SIZE_3 + 1));
+	assert_null(osal_mempool_alloc(0));
+
+	/* a block in the middle of a block is rejected */
+	blocks[0] = osal_mempool_alloc(1);
+	osal_mempool_free(blocks[0] + 1);
+	assert_int_equal(osal_mempool_use(0), 1);
+	osal_mempool_free(blocks[0]);
+	assert_int_equal(osal_mempool_use(0), 0);
+
+	osal_mempool_deinit();
+}
+
+static void test_mempool_overflow(void **state)
+{
+	uint8_t *blocks[OSAL_MEMPOOL_NUM_0];
+	uint8_t *block;
+	uint32_t i;
+	(void)state;
+
+	assert_int_equal(osal_mempool_init(NULL), OSAL_E_OK);
+
+	for (i = 0; i < OSAL_MEMPOOL_NUM_0; i++) {
+		blocks[i] = osal_mempool_alloc(OSAL_MEMPOOL_SIZE_0);
+		assert_non_null(blocks[i]);
+	}
+	assert_int_equal(osal_mempool_avail(0), 0);
+
+	/* the next larger class takes over an exhausted class */
+	block = osal_mempool_alloc(OSAL_MEMPOOL_SIZE_0);
+	assert_non_null(block);
+	assert_int_equal(osal_mempool_use(1), 1);
+	osal_mempool_free(block);
+	assert_int_equal(osal_mempool_use(1), 0);
+
+	for (i = 0; i < OSAL_MEMPOOL_NUM_0; i++) {
+		osal_mempool_free(blocks[i]);
+	}
+	assert_int_equal(osal_mempool_avail(0), OSAL_MEMPOOL_NUM_0);
+
+	osal_mempool_deinit();
+}
+
+int main(void)
+{
+	setenv("CMOCKA_TEST_ABORT", "1", 1);
+
+	const struct CMUnitTest tests[] = {
+		cmocka_unit_test(test_mempool_class),
+		cmocka_unit_test(test_mempool_overflow),
+	};
+	return cmocka_run_group_tests(tests, NULL, NULL);
+}
@@ -0,0 +1,246 @@
+/* BSD 2-Clause License
+*
+* Copyright (c) 2025, nguyenvannam142@gmail.com
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*
+* 1. Redistributions of source code must retain the above copyright notice, this
+*    list of conditions and the following disclaimer.
+*
+* 2. Redistributions in binary form must reproduce the above copyright notice,
+*    this list of conditions and the following disclaimer in the documentation
+*    and/or other materials provided with the distribution.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <pthread.h>
+#include "cmocka_include.h"
+#include "osal.h"
+
+#define MSG_LEN 100
+#define BUF_SIZE 256
+#define NUM_MSGS 100000
+#define RECV_TIMEOUT_USEC OSAL_SEC_USEC
+
+static osal_msgbuf_t *msgbuf_create(void)
+{
+	osal_msgbuf_cfg_t cfg = {
+		.size = BUF_SIZE,
+		.msglen = MSG_LEN,
+	};
+
+	return osal_msgbuf_create(&cfg);
+}
+
+/* message n is n+1 bytes long, up to MSG_LEN, and filled with n */
+static uint32_t msg_fill(uint8_t *msg, uint32_t n)
+{
+	uint32_t len = n % MSG_LEN + 1;
+
+	memset(msg, (uint8_t)n, len);
+	return len;
+}
+
+static bool msg_check(uint8_t *msg, uint32_t len, uint32_t n)
+{
+	uint32_t i;
+
+	if (len != n % MSG_LEN + 1) {
+		return false;
+	}
+	for (i = 0; i < len; i++) {
+		if (msg[i] != (uint8_t)n) {
+			return false;
+		}
+	}
+	return true;
+}
+
+static void test_msgbuf_cfg(void **state)
+{
+	osal_msgbuf_cfg_t cfg = {
+		.size = BUF_SIZE,
+		.msglen = 0,
+	};
+	osal_msgbuf_t *msgbuf;
+	uint8_t buf[MSG_LEN];
+	uint32_t len;
+	(void)state;
+
+	assert_int_equal(osal_init(NULL), OSAL_E_OK);
+	assert_null(osal_msgbuf_create(NULL));
+	assert_null(osal_msgbuf_create(&cfg));
+	/* a record takes at most half the ring */
+	cfg.msglen = BUF_SIZE/2;
+	assert_null(osal_msgbuf_create(&cfg));
+	cfg.msglen = MSG_LEN;
+	cfg.size = 0;
+	assert_null(osal_msgbuf_create(&cfg));
+	/* the size is rounded up to a power of two */
+	cfg.size = BUF_SIZE - 1;
+	msgbuf = osal_msgbuf_create(&cfg);
+	assert_non_null(msgbuf);
+	assert_int_equal(osal_msgbuf_use(), 1);
+
+	assert_int_equal(osal_msgbuf_send(msgbuf, buf, 0, 0), OSAL_E_PARAM);
+	assert_int_equal(osal_msgbuf_send(msgbuf, buf, MSG_LEN+1, 0), OSAL_E_PARAM);
+	assert_int_equal(osal_msgbuf_recv(msgbuf, buf, sizeof(buf), &len, 0), OSAL_E_TIMEOUT);
+	assert_int_equal(osal_msgbuf_recv(msgbuf, buf, sizeof(buf), &len, 1000), OSAL_E_TIMEOUT);
+
+	/* a message longer than the buffer stays in place */
+	assert_int_equal(osal_msgbuf_send(msgbuf, buf, 10, 0), OSAL_E_OK);
+	assert_int_equal(osal_msgbuf_used(msgbuf), 24);
+	assert_int_equal(osal_msgbuf_recv(msgbuf, buf, 9, &len, 0), OSAL_E_PARAM);
+	assert_int_equal(osal_msgbuf_recv(msgbuf, buf, sizeof(buf), &len, 0), OSAL_E_OK);
+	assert_int_equal(len, 10);
+	assert_int_equal(osal_msgbuf_used(msgbuf), 0);
+
+	osal_msgbuf_delete(msgbuf);
+	assert_int_equal(osal_msgbuf_use(), 0);
+	osal_deinit();
+}
+
+static void test_msgbuf_wrap(void **state)
+{
+	osal_msgbuf_t *msgbuf;
+	uint8_t buf[MSG_LEN];
+	uint32_t sent = 0;
+	uint32_t len;
+	uint32_t n;
+	(void)state;
+
+	assert_int_equal(osal_init(NULL), OSAL_E_OK);
+	msgbuf = msgbuf_create();
+	assert_non_null(msgbuf);
+
+	/* fill with mixed lengths then drain, around the ring many times */
+	for (n = 0; n < 10*MSG_LEN; n++) {
+		while (osal_msgbuf_send(msgbuf, buf, msg_fill(buf, sent), 0) == OSAL_E_OK) {
+			sent++;
+		}
+		assert_true(osal_msgbuf_used(msgbuf) > 0);
+		assert_int_equal(osal_msgbuf_recv(msgbuf, buf, sizeof(buf), &len, 0), OSAL_E_OK);
+		assert_true(msg_check(buf, len, n));
+	}
+	for (; n < sent; n++) {
+		assert_int_equal(osal_msgbuf_recv(msgbuf, buf, sizeof(buf), &len, 0), OSAL_E_OK);
+		assert_true(msg_check(buf, len, n));
+	}
+	assert_int_equal(osal_msgbuf_recv(msgbuf, buf, sizeof(buf), &len, 0), OSAL_E_TIMEOUT);
+	assert_int_equal(osal_msgbuf_used(msgbuf), 0);
+
+	/* small messages fit many more than the slots of a queue */
+	for (n = 0; n < BUF_SIZE/16; n++) {
+		assert_int_equal(osal_msgbuf_send(msgbuf, buf, 8, 0), OSAL_E_OK);
+	}
+	assert_int_equal(osal_msgbuf_send(msgbuf, buf, 8, 0), OSAL_E_QFULL);
+	assert_int_equal(osal_msgbuf_send(msgbuf, buf, 8, 1000), OSAL_E_TIMEOUT);
+
+	osal_msgbuf_delete(msgbuf);
+	osal_deinit();
+}
+
+static void test_msgbuf_zerocopy(void **state)
+{
+	osal_msgbuf_t *msgbuf;
+	uint8_t buf[MSG_LEN];
+	uint8_t *wptr;
+	uint8_t *rptr;
+	uint32_t len;
+	uint32_t n;
+	(void)state;
+
+	assert_int_equal(osal_init(NULL), OSAL_E_OK);
+	msgbuf = msgbuf_create();
+	assert_non_null(msgbuf);
+
+	assert_int_equal(osal_msgbuf_reserve(msgbuf, MSG_LEN+1, &wptr), OSAL_E_PARAM);
+	assert_int_equal(osal_msgbuf_commit(msgbuf, buf, 1), OSAL_E_PARAM);
+	assert_int_equal(osal_msgbuf_release(msgbuf, buf), OSAL_E_PARAM);
+
+	for (n = 0; n < 10*MSG_LEN; n++) {
+		/* reserve the longest, commit what was written */
+		assert_int_equal(osal_msgbuf_reserve(msgbuf, MSG_LEN, &wptr), OSAL_E_OK);
+		len = msg_fill(wptr, n);
+		assert_int_equal(osal_msgbuf_commit(msgbuf, wptr, MSG_LEN+1), OSAL_E_PARAM);
+		assert_int_equal(osal_msgbuf_commit(msgbuf, wptr, len), OSAL_E_OK);
+		assert_int_equal(osal_msgbuf_commit(msgbuf, wptr, len), OSAL_E_PARAM);
+
+		/* the record is read in place, contiguous across the wrap */
+		assert_int_equal(osal_msgbuf_peek(msgbuf, &rptr, &len, 0), OSAL_E_OK);
+		assert_ptr_equal(rptr, wptr);
+		assert_true(msg_check(rptr, len, n));
+		assert_int_equal(osal_msgbuf_release(msgbuf, rptr + 1), OSAL_E_PARAM);
+		assert_int_equal(osal_msgbuf_release(msgbuf, rptr), OSAL_E_OK);
+	}
+	assert_int_equal(osal_msgbuf_peek(msgbuf, &rptr, &len, 0), OSAL_E_TIMEOUT);
+
+	osal_msgbuf_delete(msgbuf);
+	osal_deinit();
+}
+
+static void *msgbuf_receiver(void *arg)
+{
+	osal_msgbuf_t *msgbuf = arg;
+	uint8_t buf[MSG_LEN];
+	uint32_t len;
+	uint32_t n;
+
+	for (n = 0; n < NUM_MSGS; n++) {
+		if ((osal_msgbuf_recv(msgbuf, buf, sizeof(buf), &len,
+							  RECV_TIMEOUT_USEC) != OSAL_E_OK) ||
+			!msg_check(buf, len, n)) {
+			break;
+		}
+	}
+	return (void *)(uintptr_t)n;
+}
+
+static void test_msgbuf_thread(void **state)
+{
+	osal_msgbuf_t *msgbuf;
+	uint8_t buf[MSG_LEN];
+	void *received;
+	pthread_t tid;
+	uint32_t len;
+	uint32_t n;
+	(void)state;
+
+	assert_int_equal(osal_init(NULL), OSAL_E_OK);
+	msgbuf = msgbuf_create();
+	assert_non_null(msgbuf);
+
+	/* each side sleeps on the other */
+	assert_int_equal(pthread_create(&tid, NULL, msgbuf_receiver, msgbuf), 0);
+	for (n = 0; n < NUM_MSGS; n++) {
+		len = msg_fill(buf, n);
+		assert_int_equal(osal_msgbuf_send(msgbuf, buf, len, RECV_TIMEOUT_USEC), OSAL_E_OK);
+	}
+	pthread_join(tid, &received);
+	assert_int_equal((uintptr_t)received, NUM_MSGS);
+
+	osal_msgbuf_delete(msgbuf);
+	osal_deinit();
+}
+
+int main(void)
+{
+	const struct CMUnitTest tests[] = {
+		cmocka_unit_test(test_msgbuf_cfg),
+		cmocka_unit_test(test_msgbuf_wrap),
+		cmocka_unit_test(test_msgbuf_zerocopy),
+		cmocka_unit_test(test_msgbuf_thread),
+	};
+	return cmocka_run_group_tests(tests, NULL, NULL);
+}
@@ -24,15 +24,21 @@
 * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 */
 
+#include <pthread.h>
+#include <sched.h>
 #include "cmocka_include.h"
 #include "osal.h"
 
+#define NUM_THREADS 4
+#define NUM_LOOPS 100000
+
 static void test_mutex_loop(void)
 {
 	int res;
 	int i;
 	uint32_t use;
 	uint32_t avail;
+	osal_handle_t handle;
 
 	osal_mutex_t *mutex = osal_mutex_create();
 	assert_null(mutex);
@@ -91,7 +97,14 @@ static void test_mutex_loop(void)
 	mutex = osal_mutex_create();
 	assert_non_null(mutex);
 
+	handle = osal_mutex_handle(mutex);
+	assert_int_not_equal(handle, OSAL_HANDLE_INVALID);
+	assert_ptr_equal(osal_mutex_resolve(handle), mutex);
+	osal_mutex_delete(mutex);
+	assert_null(osal_mutex_resolve(handle));
+
 	osal_mutex_deinit();
+	assert_null(osal_mutex_resolve(handle));
 }
 
 static void test_mutex(void **state)
@@ -103,12 +116,62 @@ static void test_mutex(void **state)
 	}
 }
 
+static osal_mutex_t *s_contended;
+static uint32_t s_counter;
+
+static void *mutex_thread(void *arg)
+{
+	uint32_t i;
+	(void)arg;
+
+	for (i = 0; i < NUM_LOOPS; i++) {
+		osal_mutex_lock(s_contended);
+		/* a non-atomic update loses counts without mutual exclusion */
+		s_counter = s_counter + 1;
+		if ((i % 1000) == 0) {
+			sched_yield();
+		}
+		osal_mutex_unlock(s_contended);
+	}
+	return NULL;
+}
+
+static void test_mutex_contention(void **state)
+{
+	pthread_t tids[NUM_THREADS];
+	uint32_t i;
+	(void)state;
+
+	assert_int_equal(osal_mutex_init(), OSAL_E_OK);
+	s_contended = osal_mutex_create();
+	assert_non_null(s_contended);
+	s_counter = 0;
+
+	/* the holder yields now and then for the others to sleep on the lock */
+	for (i = 0; i < NUM_THREADS; i++) {
+		assert_int_equal(pthread_create(&tids[i], NULL, mutex_thread, NULL), 0);
+	}
+	for (i = 0; i < NUM_THREADS; i++) {
+		pthread_join(tids[i], NULL);
+	}
+	assert_int_equal(s_counter, NUM_THREADS*NUM_LOOPS);
+
+	/* a released mutex is free again */
+	assert_int_equal(osal_mutex_lock(s_contended), OSAL_E_OK);
+	assert_int_equal(osal_mutex_unlock(s_contended), OSAL_E_OK);
+	assert_int_equal(osal_mutex_lock(NULL), OSAL_E_PARAM);
+
+	osal_mutex_delete(s_contended);
+	osal_mutex_deinit();
+}
+
 int main(void)
 {
 	setenv("CMOCKA_TEST_ABORT", "1", 1);
 
 	const struct CMUnitTest tests[] = {
 		cmocka_unit_test(test_mutex),
+		cmocka_unit_test(test_mutex_contention),
 	};
 	return cmocka_run_group_tests(tests, NULL, NULL);
 }
@@ -0,0 +1,1123 @@
+/* BSD 2-Clause License
+*
+* Copyright (c) 2025, nguyenvannam142@gmail.com
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*
+* 1. Redistributions of source code must retain the above copyright notice, this
+*    list of conditions and the following disclaimer.
+*
+* 2. Redistributions in binary form must reproduce the above copyright notice,
+*    this list of conditions and the following disclaimer in the documentation
+*    and/or other materials provided with the distribution.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <pthread.h>
+#include <sched.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#include "cmocka_include.h"
+#include "osal.h"
+
+#define MSG_LEN 64
+#define QUEUE_SIZE 8
+#define NUM_MSGS 100000
+#define RECV_TIMEOUT_USEC OSAL_SEC_USEC
+#define NUM_WORKERS 4
+
+static osal_queue_t *queue_create(osal_queue_type_t type)
+{
+	osal_queue_cfg_t cfg = {
+		.name = "osal_queue_test",
+		.msglen = MSG_LEN,
+		.qsize = QUEUE_SIZE,
+		.type = type,
+	};
+
+	return osal_queue_create(&cfg);
+}
+
+static void test_queue_cfg(void **state)
+{
+	osal_queue_cfg_t cfg = {
+		.msglen = MSG_LEN,
+		.qsize = QUEUE_SIZE,
+	};
+	osal_queue_t *queue;
+	(void)state;
+
+	assert_int_equal(osal_init(NULL), OSAL_E_OK);
+	assert_null(osal_queue_create(NULL));
+	/* a POSIX queue needs a name, an in-process one does not */
+	assert_null(osal_queue_create(&cfg));
+	cfg.type = OSAL_QUEUE_TYPE_SPSC;
+	queue = osal_queue_create(&cfg);
+	assert_non_null(queue);
+	osal_queue_delete(queue);
+	cfg.qsize = 0;
+	assert_null(osal_queue_create(&cfg));
+	cfg.qsize = QUEUE_SIZE;
+	cfg.type = OSAL_QUEUE_TYPE_MAX;
+	assert_null(osal_queue_create(&cfg));
+	assert_int_equal(osal_queue_use(), 0);
+	osal_deinit();
+}
+
+static void test_queue_type(osal_queue_type_t type)
+{
+	uint8_t msg[MSG_LEN];
+	uint8_t buf[MSG_LEN];
+	osal_queue_t *queue;
+	uint32_t len;
+	int i;
+
+	assert_int_equal(osal_init(NULL), OSAL_E_OK);
+	queue = queue_create(type);
+	assert_non_null(queue);
+	assert_int_equal(osal_queue_use(), 1);
+
+	assert_int_equal(osal_queue_recv(queue, buf, sizeof(buf), 0), OSAL_E_TIMEOUT);
+	assert_int_equal(osal_queue_send(queue, msg, MSG_LEN+1), OSAL_E_PARAM);
+
+	for (i = 0; i < QUEUE_SIZE; i++) {
+		memset(msg, i, sizeof(msg));
+		assert_int_equal(osal_queue_send(queue, msg, i+1), OSAL_E_OK);
+	}
+	assert_int_equal(osal_queue_send(queue, msg, 1), OSAL_E_QFULL);
+
+	for (i = 0; i < QUEUE_SIZE; i++) {
+		memset(buf, 0xff, sizeof(buf));
+		assert_int_equal(osal_queue_recv_len(queue, buf, sizeof(buf), &len, 0),
+						 OSAL_E_OK);
+		assert_int_equal(len, i+1);
+		assert_int_equal(buf[0], i);
+		assert_int_equal(buf[i], i);
+	}
+	assert_int_equal(osal_queue_recv(queue, buf, sizeof(buf), 1000), OSAL_E_TIMEOUT);
+
+	/* a message longer than the buffer stays in the queue */
+	assert_int_equal(osal_queue_send(queue, msg, MSG_LEN), OSAL_E_OK);
+	assert_int_equal(osal_queue_recv(queue, buf, MSG_LEN-1, 0), OSAL_E_PARAM);
+	assert_int_equal(osal_queue_recv_len(queue, buf, sizeof(buf), &len, 0), OSAL_E_OK);
+	assert_int_equal(len, MSG_LEN);
+
+	osal_queue_delete(queue);
+	assert_int_equal(osal_queue_use(), 0);
+	osal_deinit();
+}
+
+static void test_queue_handle(void **state)
+{
+	osal_handle_t handle;
+	osal_handle_t old_handle;
+	osal_queue_t *queue;
+	(void)state;
+
+	assert_int_equal(osal_init(NULL), OSAL_E_OK);
+	queue = queue_create(OSAL_QUEUE_TYPE_SPSC);
+	assert_non_null(queue);
+	handle = osal_queue_handle(queue);
+	assert_int_not_equal(handle, OSAL_HANDLE_INVALID);
+	assert_ptr_equal(osal_queue_resolve(handle), queue);
+	assert_int_equal(osal_queue_handle(NULL), OSAL_HANDLE_INVALID);
+	assert_null(osal_queue_resolve(OSAL_HANDLE_INVALID));
+
+	/* the generation changes with the delete */
+	osal_queue_delete(queue);
+	assert_null(osal_queue_resolve(handle));
+	old_handle = handle;
+	queue = queue_create(OSAL_QUEUE_TYPE_SPSC);
+	assert_non_null(queue);
+	handle = osal_queue_handle(queue);
+	assert_int_not_equal(handle, old_handle);
+	assert_null(osal_queue_resolve(old_handle));
+	assert_ptr_equal(osal_queue_resolve(handle), queue);
+
+	/* nothing resolves before the init, nor from a previous one */
+	osal_queue_delete(queue);
+	osal_deinit();
+	assert_null(osal_queue_resolve(handle));
+	assert_int_equal(osal_init(NULL), OSAL_E_OK);
+	assert_null(osal_queue_resolve(handle));
+	assert_null(osal_queue_resolve(old_handle));
+	osal_deinit();
+}
+
+static void test_queue_types(void **state)
+{
+	(void)state;
+
+	test_queue_type(OSAL_QUEUE_TYPE_POSIX);
+	test_queue_type(OSAL_QUEUE_TYPE_SPSC);
+	test_queue_type(OSAL_QUEUE_TYPE_MPMC);
+	test_queue_type(OSAL_QUEUE_TYPE_SHM);
+}
+
+static void *queue_producer(void *arg)
+{
+	osal_queue_t *queue = arg;
+	uint32_t i;
+
+	for (i = 0; i < NUM_MSGS; i++) {
+		while (osal_queue_send(queue, (uint8_t *)&i, sizeof(i)) == OSAL_E_QFULL) {
+			sched_yield();
+		}
+	}
+	return NULL;
+}
+
+static void test_queue_thread(osal_queue_type_t type)
+{
+	osal_queue_t *queue;
+	pthread_t tid;
+	uint8_t buf[MSG_LEN];
+	uint32_t val;
+	uint32_t i;
+
+	assert_int_equal(osal_init(NULL), OSAL_E_OK);
+	queue = queue_create(type);
+	assert_non_null(queue);
+
+	/* the receiver sleeps on the empty queue and gets all in order */
+	assert_int_equal(pthread_create(&tid, NULL, queue_producer, queue), 0);
+	for (i = 0; i < NUM_MSGS; i++) {
+		assert_int_equal(osal_queue_recv(queue, buf, sizeof(buf),
+										 RECV_TIMEOUT_USEC), OSAL_E_OK);
+		memcpy(&val, buf, sizeof(val));
+		assert_int_equal(val, i);
+	}
+	pthread_join(tid, NULL);
+
+	osal_queue_delete(queue);
+	osal_deinit();
+}
+
+static void test_queue_threads(void **state)
+{
+	(void)state;
+
+	test_queue_thread(OSAL_QUEUE_TYPE_POSIX);
+	test_queue_thread(OSAL_QUEUE_TYPE_SPSC);
+	test_queue_thread(OSAL_QUEUE_TYPE_MPMC);
+	test_queue_thread(OSAL_QUEUE_TYPE_SHM);
+}
+
+typedef struct {
+	osal_queue_t *queue;
+	uint32_t first;
+	uint64_t sum;
+	uint32_t count;
+} queue_worker_t;
+
+static void *queue_mpmc_producer(void *arg)
+{
+	queue_worker_t *worker = arg;
+	uint32_t i;
+	uint32_t val;
+
+	for (i = 0; i < NUM_MSGS / NUM_WORKERS; i++) {
+		val = worker->first + i;
+		while (osal_queue_send(worker->queue, (uint8_t *)&val,
+							   sizeof(val)) == OSAL_E_QFULL) {
+			sched_yield();
+		}
+	}
+	return NULL;
+}
+
+static void *queue_mpmc_consumer(void *arg)
+{
+	queue_worker_t *worker = arg;
+	uint8_t buf[MSG_LEN];
+	uint32_t val;
+
+	/* the queue stays empty for the timeout once all is received */
+	while (osal_queue_recv(worker->queue, buf, sizeof(buf),
+						   RECV_TIMEOUT_USEC / 10) == OSAL_E_OK) {
+		memcpy(&val, buf, sizeof(val));
+		worker->sum += val;
+		worker->count++;
+	}
+	return NULL;
+}
+
+static void test_queue_mpmc(void **state)
+{
+	queue_worker_t producers[NUM_WORKERS];
+	queue_worker_t consumers[NUM_WORKERS];
+	pthread_t ptids[NUM_WORKERS];
+	pthread_t ctids[NUM_WORKERS];
+	osal_queue_t *queue;
+	uint64_t sum = 0;
+	uint32_t count = 0;
+	int i;
+	(void)state;
+
+	assert_int_equal(osal_init(NULL), OSAL_E_OK);
+	queue = queue_create(OSAL_QUEUE_TYPE_MPMC);
+	assert_non_null(queue);
+
+	memset(producers, 0, sizeof(producers));
+	memset(consumers, 0, sizeof(consumers));
+	for (i = 0; i < NUM_WORKERS; i++) {
+		consumers[i].queue = queue;
+		assert_int_equal(pthread_create(&ctids[i], NULL, queue_mpmc_consumer,
+										&consumers[i]), 0);
+	}
+	for (i = 0; i < NUM_WORKERS; i++) {
+		producers[i].queue = queue;
+		producers[i].first = i * (NUM_MSGS / NUM_WORKERS);
+		assert_int_equal(pthread_create(&ptids[i], NULL, queue_mpmc_producer,
+										&producers[i]), 0);
+	}
+	for (i = 0; i < NUM_WORKERS; i++) {
+		pthread_join(ptids[i], NULL);
+	}
+	for (i = 0; i < NUM_WORKERS; i++) {
+		pthread_join(ctids[i], NULL);
+		sum += consumers[i].sum;
+		count += consumers[i].count;
+	}
+	/* every message has been received exactly once */
+	assert_int_equal(count, NUM_MSGS);
+	assert_true(sum == (uint64_t)NUM_MSGS * (NUM_MSGS - 1) / 2);
+
+	osal_queue_delete(queue);
+	osal_deinit();
+}
+
+static void test_queue_zerocopy_type(osal_queue_type_t type)
+{
+	osal_queue_t *queue;
+	uint8_t *ptrs[QUEUE_SIZE];
+	uint8_t buf[MSG_LEN];
+	uint8_t *ptr;
+	uint32_t len;
+	int i;
+
+	assert_int_equal(osal_init(NULL), OSAL_E_OK);
+	queue = queue_create(type);
+	assert_non_null(queue);
+
+	assert_int_equal(osal_queue_peek(queue, &ptr, &len, 0), OSAL_E_TIMEOUT);
+	for (i = 0; i < QUEUE_SIZE; i++) {
+		assert_int_equal(osal_queue_reserve(queue, &ptrs[i]), OSAL_E_OK);
+		memset(ptrs[i], i, MSG_LEN);
+		/* only the slot of the reservation can be committed, once */
+		assert_int_equal(osal_queue_commit(queue, buf, i+1), OSAL_E_PARAM);
+		assert_int_equal(osal_queue_commit(queue, ptrs[i] + 1, i+1), OSAL_E_PARAM);
+		assert_int_equal(osal_queue_commit(queue, ptrs[i], i+1), OSAL_E_OK);
+		assert_int_equal(osal_queue_commit(queue, ptrs[i], i+1), OSAL_E_PARAM);
+	}
+	assert_int_equal(osal_queue_reserve(queue, &ptr), OSAL_E_QFULL);
+
+	/* the messages are read from the slots they were built in */
+	for (i = 0; i < QUEUE_SIZE; i++) {
+		assert_int_equal(osal_queue_peek(queue, &ptr, &len, 0), OSAL_E_OK);
+		assert_ptr_equal(ptr, ptrs[i]);
+		assert_int_equal(len, i+1);
+		assert_int_equal(ptr[i], i);
+		/* only the slot of the peeked message can be released */
+		assert_int_equal(osal_queue_release(queue, ptr + 1), OSAL_E_PARAM);
+		if (i + 1 < QUEUE_SIZE) {
+			assert_int_equal(osal_queue_release(queue, ptrs[i+1]), OSAL_E_PARAM);
+		}
+		assert_int_equal(osal_queue_release(queue, ptr), OSAL_E_OK);
+		assert_int_equal(osal_queue_release(queue, ptr), OSAL_E_PARAM);
+	}
+	assert_int_equal(osal_queue_peek(queue, &ptr, &len, 1000), OSAL_E_TIMEOUT);
+
+	/* the copying calls interleave with the in-place ones */
+	assert_int_equal(osal_queue_reserve(queue, &ptr), OSAL_E_OK);
+	ptr[0] = 0x5a;
+	assert_int_equal(osal_queue_commit(queue, ptr, 1), OSAL_E_OK);
+	assert_int_equal(osal_queue_recv(queue, ptrs[0], MSG_LEN, 0), OSAL_E_OK);
+
+	osal_queue_delete(queue);
+	osal_deinit();
+}
+
+static void test_queue_zerocopy_small(osal_queue_type_t type)
+{
+	osal_queue_cfg_t cfg = {
+		.name = "osal_queue_test",
+		.msglen = MSG_LEN,
+		.qsize = 1,
+		.type = type,
+	};
+	osal_queue_t *queue;
+	uint8_t *first;
+	uint8_t *ptr;
+	uint32_t len;
+	uint8_t msg = 0;
+
+	/* a single slot could not tell a stale release from a claimed slot */
+	assert_int_equal(osal_init(NULL), OSAL_E_OK);
+	assert_null(osal_queue_create(&cfg));
+	cfg.qsize = 2;
+	queue = osal_queue_create(&cfg);
+	assert_non_null(queue);
+
+	/* a slot released twice on the next lap, claimed again or not */
+	assert_int_equal(osal_queue_send(queue, &msg, 1), OSAL_E_OK);
+	assert_int_equal(osal_queue_peek(queue, &first, &len, 0), OSAL_E_OK);
+	assert_int_equal(osal_queue_release(queue, first), OSAL_E_OK);
+	assert_int_equal(osal_queue_send(queue, &msg, 1), OSAL_E_OK);
+	assert_int_equal(osal_queue_peek(queue, &ptr, &len, 0), OSAL_E_OK);
+	assert_int_equal(osal_queue_release(queue, ptr), OSAL_E_OK);
+	assert_int_equal(osal_queue_release(queue, first), OSAL_E_PARAM);
+	assert_int_equal(osal_queue_send(queue, &msg, 1), OSAL_E_OK);
+	assert_int_equal(osal_queue_peek(queue, &ptr, &len, 0), OSAL_E_OK);
+	assert_ptr_equal(ptr, first);
+	assert_int_equal(osal_queue_release(queue, ptr), OSAL_E_OK);
+	assert_int_equal(osal_queue_release(queue, first), OSAL_E_PARAM);
+
+	osal_queue_delete(queue);
+	osal_deinit();
+}
+
+static void test_queue_zerocopy(void **state)
+{
+	osal_queue_t *queue;
+	uint8_t *ptr;
+	uint32_t len;
+	(void)state;
+
+	test_queue_zerocopy_type(OSAL_QUEUE_TYPE_SPSC);
+	test_queue_zerocopy_type(OSAL_QUEUE_TYPE_MPMC);
+	test_queue_zerocopy_type(OSAL_QUEUE_TYPE_SHM);
+	test_queue_zerocopy_small(OSAL_QUEUE_TYPE_MPMC);
+	test_queue_zerocopy_small(OSAL_QUEUE_TYPE_SHM);
+
+	/* a POSIX queue copies through the kernel */
+	assert_int_equal(osal_init(NULL), OSAL_E_OK);
+	queue = queue_create(OSAL_QUEUE_TYPE_POSIX);
+	assert_non_null(queue);
+	assert_int_equal(osal_queue_reserve(queue, &ptr), OSAL_E_NOSUPPORT);
+	assert_int_equal(osal_queue_peek(queue, &ptr, &len, 0), OSAL_E_NOSUPPORT);
+	assert_int_equal(osal_queue_reserve(NULL, &ptr), OSAL_E_PARAM);
+	osal_queue_delete(queue);
+	osal_deinit();
+}
+
+static void test_queue_batch_type(osal_queue_type_t type)
+{
+	uint8_t data[QUEUE_SIZE+2][MSG_LEN];
+	uint8_t *msgs[QUEUE_SIZE+2];
+	uint32_t lens[QUEUE_SIZE+2];
+	osal_queue_t *queue;
+	uint32_t sent;
+	uint32_t got;
+	uint32_t i;
+
+	assert_int_equal(osal_init(NULL), OSAL_E_OK);
+	queue = queue_create(type);
+	assert_non_null(queue);
+
+	for (i = 0; i < QUEUE_SIZE+2; i++) {
+		memset(data[i], i, MSG_LEN);
+		msgs[i] = data[i];
+		lens[i] = i+1;
+	}
+	lens[0] = MSG_LEN+1;
+	assert_int_equal(osal_queue_send_batch(queue, msgs, lens, 1, &sent), OSAL_E_PARAM);
+	lens[0] = 1;
+
+	/* the batch stops at the queue size */
+	assert_int_equal(osal_queue_send_batch(queue, msgs, lens, QUEUE_SIZE+2, &sent),
+					 OSAL_E_QFULL);
+	assert_int_equal(sent, QUEUE_SIZE);
+	assert_int_equal(osal_queue_send_batch(queue, msgs, lens, 1, &sent), OSAL_E_QFULL);
+	assert_int_equal(sent, 0);
+
+	memset(data, 0xff, sizeof(data));
+	memset(lens, 0, sizeof(lens));
+	assert_int_equal(osal_queue_recv_batch(queue, msgs, lens, MSG_LEN, 3, &got, 0),
+					 OSAL_E_OK);
+	assert_int_equal(got, 3);
+	assert_int_equal(osal_queue_recv_batch(queue, &msgs[3], &lens[3], MSG_LEN,
+										   QUEUE_SIZE, &got, 0), OSAL_E_OK);
+	assert_int_equal(got, QUEUE_SIZE-3);
+	for (i = 0; i < QUEUE_SIZE; i++) {
+		assert_int_equal(lens[i], i+1);
+		assert_int_equal(data[i][i], i);
+	}
+	assert_int_equal(osal_queue_recv_batch(queue, msgs, lens, MSG_LEN,
+										   QUEUE_SIZE, &got, 1000), OSAL_E_TIMEOUT);
+	assert_int_equal(got, 0);
+
+	osal_queue_delete(queue);
+	osal_deinit();
+}
+
+static void test_queue_batch(void **state)
+{
+	(void)state;
+
+	test_queue_batch_type(OSAL_QUEUE_TYPE_POSIX);
+	test_queue_batch_type(OSAL_QUEUE_TYPE_SPSC);
+	test_queue_batch_type(OSAL_QUEUE_TYPE_MPMC);
+	test_queue_batch_type(OSAL_QUEUE_TYPE_SHM);
+}
+
+static void test_queue_prio_type(osal_queue_type_t type)
+{
+	osal_queue_cfg_t cfg = {
+		.name = "osal_queue_test",
+		.msglen = MSG_LEN,
+		.qsize = QUEUE_SIZE,
+		.type = type,
+	};
+	uint32_t prios[] = {0, 2, 1, 3, 0};
+	uint8_t data[5][MSG_LEN];
+	uint8_t *bufs[5];
+	uint32_t lens[5];
+	uint8_t msg[MSG_LEN];
+	osal_queue_t *queue;
+	uint32_t msglen;
+	uint32_t got;
+	uint32_t i;
+
+	assert_int_equal(osal_init(NULL), OSAL_E_OK);
+	if (type != OSAL_QUEUE_TYPE_POSIX) {
+		/* a ring has a single lane unless asked */
+		queue = osal_queue_create(&cfg);
+		assert_non_null(queue);
+		msg[0] = 0;
+		assert_int_equal(osal_queue_send_prio(queue, msg, 1, 1), OSAL_E_NOSUPPORT);
+		assert_int_equal(osal_queue_send_prio(queue, msg, 1, 0), OSAL_E_OK);
+		osal_queue_delete(queue);
+	}
+	cfg.prio = true;
+	queue = osal_queue_create(&cfg);
+	assert_non_null(queue);
+	assert_int_equal(osal_queue_send_prio(queue, msg, 1, OSAL_QUEUE_PRIO_NUM),
+					 OSAL_E_PARAM);
+
+	/* highest priority first, in order within a priority */
+	for (i = 0; i < 5; i++) {
+		msg[0] = i;
+		assert_int_equal(osal_queue_send_prio(queue, msg, 1, prios[i]), OSAL_E_OK);
+	}
+	assert_int_equal(osal_queue_recv_len(queue, msg, MSG_LEN, &msglen, 0), OSAL_E_OK);
+	assert_int_equal(msg[0], 3);
+	assert_int_equal(osal_queue_recv_len(queue, msg, MSG_LEN, &msglen, 0), OSAL_E_OK);
+	assert_int_equal(msg[0], 1);
+	assert_int_equal(osal_queue_recv_len(queue, msg, MSG_LEN, &msglen, 0), OSAL_E_OK);
+	assert_int_equal(msg[0], 2);
+	assert_int_equal(osal_queue_recv_len(queue, msg, MSG_LEN, &msglen, 0), OSAL_E_OK);
+	assert_int_equal(msg[0], 0);
+	assert_int_equal(osal_queue_recv_len(queue, msg, MSG_LEN, &msglen, 0), OSAL_E_OK);
+	assert_int_equal(msg[0], 4);
+	assert_int_equal(osal_queue_recv(queue, msg, MSG_LEN, 0), OSAL_E_TIMEOUT);
+
+	/* a batch follows the same order */
+	for (i = 0; i < 5; i++) {
+		msg[0] = i;
+		assert_int_equal(osal_queue_send_prio(queue, msg, 1, prios[i]), OSAL_E_OK);
+		bufs[i] = data[i];
+	}
+	assert_int_equal(osal_queue_recv_batch(queue, bufs, lens, MSG_LEN, 5, &got, 0),
+					 OSAL_E_OK);
+	assert_int_equal(got, 5);
+	assert_int_equal(data[0][0], 3);
+	assert_int_equal(data[1][0], 1);
+	assert_int_equal(data[2][0], 2);
+	assert_int_equal(data[3][0], 0);
+	assert_int_equal(data[4][0], 4);
+
+	osal_queue_delete(queue);
+	osal_deinit();
+}
+
+static void test_queue_prio(void **state)
+{
+	(void)state;
+
+	test_queue_prio_type(OSAL_QUEUE_TYPE_POSIX);
+	test_queue_prio_type(OSAL_QUEUE_TYPE_SPSC);
+	test_queue_prio_type(OSAL_QUEUE_TYPE_MPMC);
+	test_queue_prio_type(OSAL_QUEUE_TYPE_SHM);
+}
+
+static void *queue_timed_producer(void *arg)
+{
+	osal_queue_t *queue = arg;
+	uint32_t i;
+
+	for (i = 0; i < NUM_MSGS; i++) {
+		if (osal_queue_send_timed(queue, (uint8_t *)&i, sizeof(i),
+								  RECV_TIMEOUT_USEC) != OSAL_E_OK) {
+			break;
+		}
+	}
+	return NULL;
+}
+
+static void queue_watermark_cb(osal_queue_t *queue, bool high, void *arg)
+{
+	int32_t *level = arg;
+	(void)queue;
+
+	/* the calls alternate, starting with high */
+	*level += high ? 1 : -1;
+	assert_true((*level == 0) || (*level == 1));
+}
+
+static void test_queue_timed_type(osal_queue_type_t type)
+{
+	osal_queue_t *queue;
+	pthread_t tid;
+	uint8_t buf[MSG_LEN];
+	int32_t level = 0;
+	uint64_t start = 0;
+	uint64_t now = 0;
+	uint32_t val;
+	uint32_t i;
+
+	assert_int_equal(osal_init(NULL), OSAL_E_OK);
+	queue = queue_create(type);
+	assert_non_null(queue);
+
+	assert_int_equal(osal_queue_watermark(queue, QUEUE_SIZE+1, 0,
+										  queue_watermark_cb, &level), OSAL_E_PARAM);
+	assert_int_equal(osal_queue_watermark(queue, 2, 2,
+										  queue_watermark_cb, &level), OSAL_E_PARAM);
+	assert_int_equal(osal_queue_watermark(queue, QUEUE_SIZE-2, 2,
+										  queue_watermark_cb, &level), OSAL_E_OK);
+
+	/* a full queue fails at once without timeout, else after it */
+	for (i = 0; i < QUEUE_SIZE; i++) {
+		assert_int_equal(osal_queue_send_timed(queue, buf, 1, 0), OSAL_E_OK);
+		assert_int_equal(level, (i+1 >= QUEUE_SIZE-2) ? 1 : 0);
+	}
+	assert_int_equal(osal_queue_send_timed(queue, buf, 1, 0), OSAL_E_QFULL);
+	assert_int_equal(osal_queue_send_timed(queue, buf, 1, 1000), OSAL_E_TIMEOUT);
+	for (i = 0; i < QUEUE_SIZE; i++) {
+		assert_int_equal(osal_queue_recv(queue, buf, sizeof(buf), 0), OSAL_E_OK);
+		assert_int_equal(level, (QUEUE_SIZE-i-1 <= 2) ? 0 : 1);
+	}
+	assert_int_equal(osal_queue_watermark(queue, 0, 0, NULL, NULL), OSAL_E_OK);
+
+	/* a signal does not cut the wait short */
+	osal_clock_time(&start);
+	ualarm(10000, 0);
+	assert_int_equal(osal_queue_recv(queue, buf, sizeof(buf), 50000), OSAL_E_TIMEOUT);
+	osal_clock_time(&now);
+	assert_true(now - start >= 50000 * OSAL_USEC_NSEC);
+
+	/* the producer sleeps on the full queue and sends all in order */
+	assert_int_equal(pthread_create(&tid, NULL, queue_timed_producer, queue), 0);
+	for (i = 0; i < NUM_MSGS; i++) {
+		assert_int_equal(osal_queue_recv(queue, buf, sizeof(buf),
+										 RECV_TIMEOUT_USEC), OSAL_E_OK);
+		memcpy(&val, buf, sizeof(val));
+		assert_int_equal(val, i);
+		if (i % (NUM_MSGS/10) == 0) {
+			/* let the producer block on a full queue */
+			usleep(1000);
+		}
+	}
+	pthread_join(tid, NULL);
+
+	osal_queue_delete(queue);
+	osal_deinit();
+}
+
+static void queue_alarm(int sig)
+{
+	(void)sig;
+}
+
+static void test_queue_timed(void **state)
+{
+	struct sigaction sa = { .sa_handler = queue_alarm };
+	(void)state;
+
+	/* without SA_RESTART, the alarm interrupts a waiting receiver */
+	sigaction(SIGALRM, &sa, NULL);
+	test_queue_timed_type(OSAL_QUEUE_TYPE_POSIX);
+	test_queue_timed_type(OSAL_QUEUE_TYPE_SPSC);
+	test_queue_timed_type(OSAL_QUEUE_TYPE_MPMC);
+	test_queue_timed_type(OSAL_QUEUE_TYPE_SHM);
+	signal(SIGALRM, SIG_DFL);
+}
+
+static void *queue_late_producer(void *arg)
+{
+	osal_queue_t *queue = arg;
+	uint8_t msg = 0;
+
+	usleep(5000);
+	osal_queue_send(queue, &msg, sizeof(msg));
+	return NULL;
+}
+
+static void test_queue_spin_type(osal_queue_type_t type)
+{
+	osal_queue_recv_stats_t stats;
+	osal_queue_t *queue;
+	pthread_t tid;
+	uint8_t buf[MSG_LEN];
+
+	assert_int_equal(osal_init(NULL), OSAL_E_OK);
+	queue = queue_create(type);
+	assert_non_null(queue);
+	assert_int_equal(osal_queue_recv_mode(queue, OSAL_QUEUE_RECV_MAX, 0), OSAL_E_PARAM);
+	assert_int_equal(osal_queue_recv_stats(queue, NULL), OSAL_E_PARAM);
+
+	/* the message comes within the spin window */
+	assert_int_equal(osal_queue_recv_mode(queue, OSAL_QUEUE_RECV_SPIN,
+										  RECV_TIMEOUT_USEC / 2), OSAL_E_OK);
+	assert_int_equal(pthread_create(&tid, NULL, queue_late_producer, queue), 0);
+	assert_int_equal(osal_queue_recv(queue, buf, sizeof(buf), RECV_TIMEOUT_USEC), OSAL_E_OK);
+	pthread_join(tid, NULL);
+	assert_int_equal(osal_queue_recv_stats(queue, &stats), OSAL_E_OK);
+	assert_int_equal(stats.spun, 1);
+	assert_int_equal(stats.blocked, 0);
+
+	/* the message comes after the spin window */
+	assert_int_equal(osal_queue_recv_mode(queue, OSAL_QUEUE_RECV_SPIN, 1), OSAL_E_OK);
+	assert_int_equal(pthread_create(&tid, NULL, queue_late_producer, queue), 0);
+	assert_int_equal(osal_queue_recv(queue, buf, sizeof(buf), RECV_TIMEOUT_USEC), OSAL_E_OK);
+	pthread_join(tid, NULL);
+	assert_int_equal(osal_queue_recv_stats(queue, &stats), OSAL_E_OK);
+	assert_int_equal(stats.spun, 1);
+	assert_int_equal(stats.blocked, 1);
+
+	/* a spin window as long as the timeout leaves nothing to sleep */
+	assert_int_equal(osal_queue_recv_mode(queue, OSAL_QUEUE_RECV_SPIN, 1000), OSAL_E_OK);
+	assert_int_equal(osal_queue_recv(queue, buf, sizeof(buf), 1000), OSAL_E_TIMEOUT);
+	assert_int_equal(osal_queue_recv_stats(queue, &stats), OSAL_E_OK);
+	assert_int_equal(stats.blocked, 1);
+
+	/* polling never sleeps and times out on its own */
+	assert_int_equal(osal_queue_recv_mode(queue, OSAL_QUEUE_RECV_POLL, 0), OSAL_E_OK);
+	assert_int_equal(osal_queue_recv(queue, buf, sizeof(buf), 1000), OSAL_E_TIMEOUT);
+	assert_int_equal(pthread_create(&tid, NULL, queue_late_producer, queue), 0);
+	assert_int_equal(osal_queue_recv(queue, buf, sizeof(buf), RECV_TIMEOUT_USEC), OSAL_E_OK);
+	pthread_join(tid, NULL);
+	assert_int_equal(osal_queue_recv_stats(queue, &stats), OSAL_E_OK);
+	assert_int_equal(stats.spun, 2);
+	assert_int_equal(stats.blocked, 1);
+
+	osal_queue_delete(queue);
+	osal_deinit();
+}
+
+static void test_queue_spin(void **state)
+{
+	(void)state;
+
+	test_queue_spin_type(OSAL_QUEUE_TYPE_POSIX);
+	test_queue_spin_type(OSAL_QUEUE_TYPE_SPSC);
+	test_queue_spin_type(OSAL_QUEUE_TYPE_MPMC);
+	test_queue_spin_type(OSAL_QUEUE_TYPE_SHM);
+}
+
+static void test_queue_overwrite_type(osal_queue_type_t type)
+{
+	osal_queue_cfg_t cfg = {
+		.name = "osal_queue_test",
+		.msglen = MSG_LEN,
+		.qsize = QUEUE_SIZE,
+		.type = type,
+		.overflow = OSAL_QUEUE_OVERFLOW_OVERWRITE,
+	};
+	uint8_t buf[MSG_LEN];
+	osal_queue_t *queue;
+	uint8_t *ptr;
+	uint8_t msg;
+	uint32_t i;
+
+	assert_int_equal(osal_init(NULL), OSAL_E_OK);
+	queue = osal_queue_create(&cfg);
+	if (type == OSAL_QUEUE_TYPE_POSIX) {
+		assert_null(queue);
+		osal_deinit();
+		return;
+	}
+	assert_non_null(queue);
+
+	/* the newest messages are kept */
+	for (i = 0; i < QUEUE_SIZE+3; i++) {
+		msg = i;
+		assert_int_equal(osal_queue_send(queue, &msg, 1), OSAL_E_OK);
+	}
+	assert_int_equal(osal_queue_send_timed(queue, &msg, 1, RECV_TIMEOUT_USEC), OSAL_E_OK);
+	for (i = 4; i < QUEUE_SIZE+4; i++) {
+		assert_int_equal(osal_queue_recv(queue, buf, sizeof(buf), 0), OSAL_E_OK);
+		assert_int_equal(buf[0], (i < QUEUE_SIZE+3) ? i : QUEUE_SIZE+2);
+	}
+	assert_int_equal(osal_queue_recv(queue, buf, sizeof(buf), 0), OSAL_E_TIMEOUT);
+
+	for (i = 0; i < QUEUE_SIZE+1; i++) {
+		assert_int_equal(osal_queue_reserve(queue, &ptr), OSAL_E_OK);
+		ptr[0] = i;
+		assert_int_equal(osal_queue_commit(queue, ptr, 1), OSAL_E_OK);
+	}
+	assert_int_equal(osal_queue_recv(queue, buf, sizeof(buf), 0), OSAL_E_OK);
+	assert_int_equal(buf[0], 1);
+	assert_int_equal(osal_queue_send_keyed(queue, &msg, 1, 0), OSAL_E_NOSUPPORT);
+
+	osal_queue_delete(queue);
+	osal_deinit();
+}
+
+static void test_queue_conflate_type(osal_queue_type_t type)
+{
+	osal_queue_cfg_t cfg = {
+		.name = "osal_queue_test",
+		.msglen = MSG_LEN,
+		.qsize = QUEUE_SIZE,
+		.type = type,
+		.overflow = OSAL_QUEUE_OVERFLOW_CONFLATE,
+	};
+	uint8_t buf[MSG_LEN];
+	osal_queue_t *queue;
+	uint32_t msglen;
+	uint8_t *ptr;
+	uint8_t msg;
+	uint32_t i;
+
+	assert_int_equal(osal_init(NULL), OSAL_E_OK);
+	queue = osal_queue_create(&cfg);
+	if ((type == OSAL_QUEUE_TYPE_POSIX) || (type == OSAL_QUEUE_TYPE_SHM)) {
+		assert_null(queue);
+		osal_deinit();
+		return;
+	}
+	assert_non_null(queue);
+	msg = 0;
+	assert_int_equal(osal_queue_send_prio(queue, &msg, 1, 1), OSAL_E_NOSUPPORT);
+	assert_int_equal(osal_queue_reserve(queue, &ptr), OSAL_E_NOSUPPORT);
+
+	/* a key keeps its place with the latest value */
+	msg = 10;
+	assert_int_equal(osal_queue_send_keyed(queue, &msg, 1, 1), OSAL_E_OK);
+	msg = 20;
+	assert_int_equal(osal_queue_send_keyed(queue, &msg, 1, 2), OSAL_E_OK);
+	msg = 30;
+	assert_int_equal(osal_queue_send(queue, &msg, 1), OSAL_E_OK);
+	msg = 11;
+	assert_int_equal(osal_queue_send_keyed(queue, &msg, 1, 1), OSAL_E_OK);
+	assert_int_equal(osal_queue_recv_len(queue, buf, sizeof(buf), &msglen, 0), OSAL_E_OK);
+	assert_int_equal(buf[0], 11);
+	assert_int_equal(osal_queue_recv_len(queue, buf, sizeof(buf), &msglen, 0), OSAL_E_OK);
+	assert_int_equal(buf[0], 20);
+	assert_int_equal(osal_queue_recv_len(queue, buf, sizeof(buf), &msglen, 0), OSAL_E_OK);
+	assert_int_equal(buf[0], 30);
+	assert_int_equal(osal_queue_recv(queue, buf, sizeof(buf), 1000), OSAL_E_TIMEOUT);
+
+	/* the ring stays bounded with one message per key */
+	for (i = 0; i < 4*QUEUE_SIZE; i++) {
+		msg = i;
+		assert_int_equal(osal_queue_send_keyed(queue, &msg, 1, i % QUEUE_SIZE), OSAL_E_OK);
+	}
+	for (i = 3*QUEUE_SIZE; i < 4*QUEUE_SIZE; i++) {
+		assert_int_equal(osal_queue_recv(queue, buf, sizeof(buf), 0), OSAL_E_OK);
+		assert_int_equal(buf[0], i);
+	}
+	/* a full ring drops its oldest */
+	for (i = 0; i < QUEUE_SIZE+1; i++) {
+		msg = i;
+		assert_int_equal(osal_queue_send_keyed(queue, &msg, 1, i), OSAL_E_OK);
+	}
+	assert_int_equal(osal_queue_recv(queue, buf, sizeof(buf), 0), OSAL_E_OK);
+	assert_int_equal(buf[0], 1);
+
+	osal_queue_delete(queue);
+	osal_deinit();
+}
+
+static void test_queue_overflow(void **state)
+{
+	osal_queue_cfg_t cfg = {
+		.msglen = MSG_LEN,
+		.qsize = QUEUE_SIZE,
+		.type = OSAL_QUEUE_TYPE_MPMC,
+		.overflow = OSAL_QUEUE_OVERFLOW_MAX,
+	};
+	(void)state;
+
+	assert_int_equal(osal_init(NULL), OSAL_E_OK);
+	assert_null(osal_queue_create(&cfg));
+	cfg.overflow = OSAL_QUEUE_OVERFLOW_CONFLATE;
+	cfg.prio = true;
+	assert_null(osal_queue_create(&cfg));
+	osal_deinit();
+
+	test_queue_overwrite_type(OSAL_QUEUE_TYPE_POSIX);
+	test_queue_overwrite_type(OSAL_QUEUE_TYPE_SPSC);
+	test_queue_overwrite_type(OSAL_QUEUE_TYPE_MPMC);
+	test_queue_overwrite_type(OSAL_QUEUE_TYPE_SHM);
+	test_queue_conflate_type(OSAL_QUEUE_TYPE_POSIX);
+	test_queue_conflate_type(OSAL_QUEUE_TYPE_SPSC);
+	test_queue_conflate_type(OSAL_QUEUE_TYPE_MPMC);
+	test_queue_conflate_type(OSAL_QUEUE_TYPE_SHM);
+}
+
+static void test_queue_stats_type(osal_queue_type_t type)
+{
+	osal_queue_cfg_t cfg = {
+		.name = "osal_queue_test",
+		.msglen = MSG_LEN,
+		.qsize = QUEUE_SIZE,
+		.type = type,
+	};
+	uint8_t buf[MSG_LEN] = { 0 };
+	osal_queue_stats_t stats;
+	osal_queue_t *queue;
+	uint64_t total = 0;
+	uint32_t i;
+
+	assert_int_equal(osal_init(NULL), OSAL_E_OK);
+	queue = osal_queue_create(&cfg);
+	assert_non_null(queue);
+	for (i = 0; i < QUEUE_SIZE; i++) {
+		assert_int_equal(osal_queue_send(queue, buf, MSG_LEN), OSAL_E_OK);
+	}
+	assert_int_equal(osal_queue_send(queue, buf, MSG_LEN), OSAL_E_QFULL);
+	for (i = 0; i < QUEUE_SIZE/2; i++) {
+		assert_int_equal(osal_queue_recv(queue, buf, sizeof(buf), 0), OSAL_E_OK);
+	}
+	assert_int_equal(osal_queue_send(queue, buf, MSG_LEN), OSAL_E_OK);
+
+	assert_int_equal(osal_queue_stats(NULL, &stats), OSAL_E_PARAM);
+	assert_int_equal(osal_queue_stats(queue, &stats), OSAL_E_OK);
+	assert_int_equal(stats.sent, QUEUE_SIZE+1);
+	assert_int_equal(stats.recvd, QUEUE_SIZE/2);
+	assert_int_equal(stats.qfull, 1);
+	assert_int_equal(stats.dropped, 0);
+	assert_int_equal(stats.depth, QUEUE_SIZE/2+1);
+	assert_int_equal(stats.depth_max, QUEUE_SIZE);
+	for (i = 0; i < OSAL_QUEUE_LATENCY_BUCKETS; i++) {
+		total += stats.latency[i];
+	}
+	/* POSIX messages carry no send time */
+	assert_int_equal(total, (type == OSAL_QUEUE_TYPE_POSIX) ? 0 : QUEUE_SIZE/2);
+
+	osal_queue_delete(queue);
+	osal_deinit();
+}
+
+static void test_queue_stats(void **state)
+{
+	(void)state;
+
+#if OSAL_QUEUE_STATS
+	test_queue_stats_type(OSAL_QUEUE_TYPE_POSIX);
+	test_queue_stats_type(OSAL_QUEUE_TYPE_SPSC);
+	test_queue_stats_type(OSAL_QUEUE_TYPE_MPMC);
+	test_queue_stats_type(OSAL_QUEUE_TYPE_SHM);
+#else
+	osal_queue_cfg_t cfg = {
+		.name = "osal_queue_test",
+		.msglen = MSG_LEN,
+		.qsize = QUEUE_SIZE,
+		.type = OSAL_QUEUE_TYPE_SPSC,
+	};
+	osal_queue_stats_t stats;
+	osal_queue_t *queue;
+
+	(void)test_queue_stats_type;
+	assert_int_equal(osal_init(NULL), OSAL_E_OK);
+	queue = osal_queue_create(&cfg);
+	assert_non_null(queue);
+	assert_int_equal(osal_queue_stats(queue, &stats), OSAL_E_NOSUPPORT);
+	osal_queue_delete(queue);
+	osal_deinit();
+#endif
+}
+
+static void test_queue_shm(void **state)
+{
+	osal_queue_cfg_t cfg = {
+		.name = "osal_queue_shm_test",
+		.msglen = MSG_LEN,
+		.qsize = QUEUE_SIZE,
+		.type = OSAL_QUEUE_TYPE_SHM,
+	};
+	osal_queue_t *queue;
+	osal_queue_t *peer;
+	uint8_t buf[MSG_LEN];
+	uint32_t val;
+	uint32_t i;
+	int status;
+	pid_t pid;
+	(void)state;
+
+	assert_int_equal(osal_init(NULL), OSAL_E_OK);
+	queue = osal_queue_create(&cfg);
+	assert_non_null(queue);
+
+	/* an attacher must agree on the geometry */
+	cfg.msglen = MSG_LEN * 2;
+	assert_null(osal_queue_create(&cfg));
+	/* even one of the same size: half the slots, each as long as two with
+	 * the sequence, length and send time header of a slot */
+	cfg.qsize = QUEUE_SIZE / 2;
+	cfg.msglen = MSG_LEN * 2 + 16 + 8 * OSAL_QUEUE_STATS;
+	assert_null(osal_queue_create(&cfg));
+	cfg.qsize = QUEUE_SIZE;
+	cfg.msglen = MSG_LEN;
+	if (QUEUE_SIZE % OSAL_QUEUE_PRIO_NUM == 0) {
+		cfg.qsize = QUEUE_SIZE / OSAL_QUEUE_PRIO_NUM;
+		cfg.prio = true;
+		assert_null(osal_queue_create(&cfg));
+		cfg.qsize = QUEUE_SIZE;
+		cfg.prio = false;
+	}
+
+	/* the child attaches by name and sends all in order to the parent */
+	pid = fork();
+	assert_true(pid >= 0);
+	if (pid == 0) {
+		peer = osal_queue_create(&cfg);
+		if (peer == NULL) {
+			_exit(1);
+		}
+		for (i = 0; i < NUM_MSGS; i++) {
+			while (osal_queue_send(peer, (uint8_t *)&i, sizeof(i)) == OSAL_E_QFULL) {
+				sched_yield();
+			}
+		}
+		osal_queue_delete(peer);
+		_exit(0);
+	}
+	for (i = 0; i < NUM_MSGS; i++) {
+		assert_int_equal(osal_queue_recv(queue, buf, sizeof(buf),
+										 RECV_TIMEOUT_USEC), OSAL_E_OK);
+		memcpy(&val, buf, sizeof(val));
+		assert_int_equal(val, i);
+	}
+	assert_int_equal(waitpid(pid, &status, 0), pid);
+	assert_true(WIFEXITED(status) && (WEXITSTATUS(status) == 0));
+
+	osal_queue_delete(queue);
+	osal_deinit();
+}
+
+static void *queue_set_producer(void *arg)
+{
+	osal_queue_t *queue = arg;
+	uint8_t msg[MSG_LEN] = {0};
+
+	/* let the set go to sleep first */
+	osal_usleep(10000);
+	assert_int_equal(osal_queue_send(queue, msg, sizeof(msg)), OSAL_E_OK);
+	return NULL;
+}
+
+static void test_queue_set(void **state)
+{
+	osal_queue_t *queues[OSAL_QUEUE_TYPE_SHM];
+	osal_queue_t *ready[OSAL_QUEUE_TYPE_SHM];
+	osal_queue_set_t *set;
+	osal_queue_t *shm;
+	uint8_t buf[MSG_LEN];
+	uint32_t n_ready;
+	pthread_t tid;
+	int i;
+	(void)state;
+
+	assert_int_equal(osal_init(NULL), OSAL_E_OK);
+	set = osal_queue_set_create();
+	assert_non_null(set);
+	assert_int_equal(osal_queue_set_use(), 1);
+	for (i = 0; i < OSAL_QUEUE_TYPE_SHM; i++) {
+		queues[i] = queue_create(i);
+		assert_non_null(queues[i]);
+		assert_int_equal(osal_queue_set_add(set, queues[i]), OSAL_E_OK);
+	}
+	assert_int_equal(osal_queue_set_add(set, queues[0]), OSAL_E_INUSE);
+	shm = queue_create(OSAL_QUEUE_TYPE_SHM);
+	assert_non_null(shm);
+	assert_int_equal(osal_queue_set_add(set, shm), OSAL_E_NOSUPPORT);
+	osal_queue_delete(shm);
+
+	assert_int_equal(osal_queue_set_wait(set, ready, OSAL_QUEUE_TYPE_SHM,
+										 &n_ready, 0), OSAL_E_TIMEOUT);
+	assert_int_equal(osal_queue_set_wait(set, ready, OSAL_QUEUE_TYPE_SHM,
+										 &n_ready, 1000), OSAL_E_TIMEOUT);
+	assert_int_equal(n_ready, 0);
+
+	/* every queue with a message is reported, in the order of the set */
+	assert_int_equal(osal_queue_send(queues[OSAL_QUEUE_TYPE_MPMC], buf, 1), OSAL_E_OK);
+	assert_int_equal(osal_queue_send(queues[OSAL_QUEUE_TYPE_POSIX], buf, 1), OSAL_E_OK);
+	assert_int_equal(osal_queue_set_wait(set, ready, OSAL_QUEUE_TYPE_SHM,
+										 &n_ready, 0), OSAL_E_OK);
+	assert_int_equal(n_ready, 2);
+	assert_ptr_equal(ready[0], queues[OSAL_QUEUE_TYPE_POSIX]);
+	assert_ptr_equal(ready[1], queues[OSAL_QUEUE_TYPE_MPMC]);
+	assert_int_equal(osal_queue_set_wait(set, ready, 1, &n_ready, 0), OSAL_E_OK);
+	assert_int_equal(n_ready, 1);
+	for (i = 0; i < 2; i++) {
+		assert_int_equal(osal_queue_recv(queues[i * 2], buf, sizeof(buf), 0), OSAL_E_OK);
+	}
+
+	/* each type wakes up the set sleeping on all of them */
+	for (i = 0; i < OSAL_QUEUE_TYPE_SHM; i++) {
+		assert_int_equal(pthread_create(&tid, NULL, queue_set_producer, queues[i]), 0);
+		assert_int_equal(osal_queue_set_wait(set, ready, OSAL_QUEUE_TYPE_SHM,
+											 &n_ready, RECV_TIMEOUT_USEC), OSAL_E_OK);
+		assert_int_equal(n_ready, 1);
+		assert_ptr_equal(ready[0], queues[i]);
+		assert_int_equal(osal_queue_recv(queues[i], buf, sizeof(buf), 0), OSAL_E_OK);
+		pthread_join(tid, NULL);
+	}
+
+	/* a deleted queue leaves the set */
+	osal_queue_delete(queues[OSAL_QUEUE_TYPE_SPSC]);
+	assert_int_equal(osal_queue_send(queues[OSAL_QUEUE_TYPE_MPMC], buf, 1), OSAL_E_OK);
+	assert_int_equal(osal_queue_set_wait(set, ready, OSAL_QUEUE_TYPE_SHM,
+										 &n_ready, 0), OSAL_E_OK);
+	assert_int_equal(n_ready, 1);
+	assert_ptr_equal(ready[0], queues[OSAL_QUEUE_TYPE_MPMC]);
+	assert_int_equal(osal_queue_set_remove(set, queues[OSAL_QUEUE_TYPE_MPMC]), OSAL_E_OK);
+	assert_int_equal(osal_queue_set_remove(set, queues[OSAL_QUEUE_TYPE_MPMC]), OSAL_E_PARAM);
+	assert_int_equal(osal_queue_set_wait(set, ready, OSAL_QUEUE_TYPE_SHM,
+										 &n_ready, 0), OSAL_E_TIMEOUT);
+
+	osal_queue_set_delete(set);
+	assert_int_equal(osal_queue_set_use(), 0);
+	osal_queue_delete(queues[OSAL_QUEUE_TYPE_POSIX]);
+	osal_queue_delete(queues[OSAL_QUEUE_TYPE_MPMC]);
+	osal_deinit();
+}
+
+int main(void)
+{
+	setenv("CMOCKA_TEST_ABORT", "1", 1);
+
+	const struct CMUnitTest tests[] = {
+		cmocka_unit_test(test_queue_cfg),
+		cmocka_unit_test(test_queue_types),
+		cmocka_unit_test(test_queue_handle),
+		cmocka_unit_test(test_queue_threads),
+		cmocka_unit_test(test_queue_mpmc),
+		cmocka_unit_test(test_queue_zerocopy),
+		cmocka_unit_test(test_queue_shm),
+		cmocka_unit_test(test_queue_batch),
+		cmocka_unit_test(test_queue_prio),
+		cmocka_unit_test(test_queue_timed),
+		cmocka_unit_test(test_queue_spin),
+		cmocka_unit_test(test_queue_overflow),
+		cmocka_unit_test(test_queue_stats),
+		cmocka_unit_test(test_queue_set),
+	};
+	return cmocka_run_group_tests(tests, NULL, NULL);
+}
@@ -24,16 +24,20 @@
 * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 */
 
+#include <pthread.h>
+#include <semaphore.h>
 #include "cmocka_include.h"
 #include "osal.h"
 
 #define MAX_RES 100
+#define NUM_THREADS 4
+#define NUM_LOOPS 100000
 
 typedef struct {
 	osal_resrc_t *resrc;
 } rmdata_t;
 
-static void test_rm(bool use_mutex)
+static void test_rm(bool use_mutex, osal_rm_lock_t lock)
 {
 	osal_rm_t rm;
 	rmdata_t rmdatas[MAX_RES];
@@ -53,6 +57,8 @@ static void test_rm(bool use_mutex)
 	}
 	rmcfg.n_resrces = MAX_RES;
 	rmcfg.resrces = resrces;
+	rmcfg.lock = lock;
+	rmcfg.magazine = (OSAL_RM_MAGAZINE_SIZE > 0);
 	for (i = 0; i < MAX_RES; i++) {
 		resrces[i].data = &rmdatas[i];
 	}
@@ -99,11 +105,11 @@ static void test_rm(bool use_mutex)
 	use = osal_rm_use(&rm);
 	assert_int_equal(use, MAX_RES);
 
+	osal_rm_deinit(&rm);
 	if (use_mutex) {
 		osal_mutex_delete(rmcfg.mutex);
 		osal_mutex_deinit();
 	}
-	osal_rm_deinit(&rm);
 }
 
 static void test_rm_run(void **state)
@@ -112,9 +118,340 @@ static void test_rm_run(void **state)
 	int i;
 
 	for (i = 0; i < 10; i++) {
-		test_rm(true);
-		test_rm(false);
+		test_rm(true, OSAL_RM_LOCK_MUTEX);
+		test_rm(false, OSAL_RM_LOCK_MUTEX);
+		test_rm(false, OSAL_RM_LOCK_NONE);
+		test_rm(false, OSAL_RM_LOCK_SPIN);
+		test_rm(false, OSAL_RM_LOCK_LOCKFREE);
+	}
+}
+
+static void test_rm_bulk(osal_rm_lock_t lock)
+{
+	osal_rm_t rm;
+	rmdata_t rmdatas[MAX_RES];
+	osal_resrc_t resrces[MAX_RES];
+	osal_resrc_t *bulk[MAX_RES];
+	osal_rm_cfg_t rmcfg;
+	uint32_t n;
+	int i;
+
+	memset(&rmcfg, 0, sizeof(rmcfg));
+	rmcfg.n_resrces = MAX_RES;
+	rmcfg.resrces = resrces;
+	rmcfg.lock = lock;
+	for (i = 0; i < MAX_RES; i++) {
+		resrces[i].data = &rmdatas[i];
+	}
+	assert_int_equal(osal_rm_init(&rm, &rmcfg), OSAL_E_OK);
+
+	n = osal_rm_alloc_bulk(&rm, bulk, 30);
+	assert_int_equal(n, 30);
+	assert_int_equal(osal_rm_use(&rm), 30);
+	for (i = 0; i < 30; i++) {
+		assert_true(bulk[i]->used);
+	}
+	osal_rm_free_bulk(&rm, bulk, 30);
+	assert_int_equal(osal_rm_use(&rm), 0);
+
+	/* a request larger than the pool gets what is left */
+	assert_non_null(osal_rm_alloc(&rm));
+	n = osal_rm_alloc_bulk(&rm, bulk, MAX_RES);
+	assert_int_equal(n, MAX_RES-1);
+	assert_int_equal(osal_rm_avail(&rm), 0);
+	assert_int_equal(osal_rm_alloc_bulk(&rm, bulk, 1), 0);
+	osal_rm_free_bulk(&rm, bulk, n);
+	assert_int_equal(osal_rm_avail(&rm), MAX_RES-1);
+
+	osal_rm_deinit(&rm);
+}
+
+static void test_rm_bulk_run(void **state)
+{
+	(void)state;
+
+	test_rm_bulk(OSAL_RM_LOCK_MUTEX);
+	test_rm_bulk(OSAL_RM_LOCK_SPIN);
+	test_rm_bulk(OSAL_RM_LOCK_LOCKFREE);
+}
+
+/* a pool with more resources than a handle can index */
+static osal_resrc_t s_big_resrces[OSAL_HANDLE_INDEX_MAX + 2];
+
+static void test_rm_handle(void **state)
+{
+	osal_rm_t rm;
+	rmdata_t rmdatas[MAX_RES];
+	osal_resrc_t resrces[MAX_RES];
+	osal_rm_cfg_t rmcfg;
+	osal_resrc_t *resrc;
+	osal_handle_t handle;
+	osal_handle_t old_handle;
+	uint32_t n;
+	int i;
+	(void)state;
+
+	/* the resources past the index of a handle work without one */
+	memset(&rmcfg, 0, sizeof(rmcfg));
+	rmcfg.n_resrces = OSAL_HANDLE_INDEX_MAX + 2;
+	rmcfg.resrces = s_big_resrces;
+	assert_int_equal(osal_rm_init(&rm, &rmcfg), OSAL_E_OK);
+	for (n = 0; n < OSAL_HANDLE_INDEX_MAX + 2; n++) {
+		resrc = osal_rm_alloc(&rm);
+		assert_non_null(resrc);
+		handle = osal_rm_handle(&rm, resrc);
+		if (resrc - s_big_resrces > OSAL_HANDLE_INDEX_MAX) {
+			assert_int_equal(handle, OSAL_HANDLE_INVALID);
+		} else {
+			assert_ptr_equal(osal_rm_resolve(&rm, handle), resrc);
+		}
+	}
+	assert_null(osal_rm_alloc(&rm));
+	osal_rm_deinit(&rm);
+
+	memset(&rmcfg, 0, sizeof(rmcfg));
+	rmcfg.resrces = resrces;
+	rmcfg.n_resrces = MAX_RES;
+	for (i = 0; i < MAX_RES; i++) {
+		resrces[i].data = &rmdatas[i];
+	}
+	assert_int_equal(osal_rm_init(&rm, &rmcfg), OSAL_E_OK);
+
+	assert_null(osal_rm_resolve(&rm, OSAL_HANDLE_INVALID));
+	resrc = osal_rm_alloc(&rm);
+	assert_non_null(resrc);
+	handle = osal_rm_handle(&rm, resrc);
+	assert_int_not_equal(handle, OSAL_HANDLE_INVALID);
+	assert_ptr_equal(osal_rm_resolve(&rm, handle), resrc);
+	assert_null(osal_rm_resolve(&rm, handle | OSAL_HANDLE_INDEX_MAX));
+
+	/* the same resource comes back with another handle */
+	for (i = 0; i < 10; i++) {
+		osal_rm_free(&rm, resrc);
+		assert_int_equal(osal_rm_handle(&rm, resrc), OSAL_HANDLE_INVALID);
+		assert_null(osal_rm_resolve(&rm, handle));
+		old_handle = handle;
+		resrc = osal_rm_alloc(&rm);
+		handle = osal_rm_handle(&rm, resrc);
+		assert_int_not_equal(handle, old_handle);
+		assert_null(osal_rm_resolve(&rm, old_handle));
+		assert_ptr_equal(osal_rm_resolve(&rm, handle), resrc);
+	}
+	osal_rm_deinit(&rm);
+}
+
+static void *rm_thread(void *arg)
+{
+	osal_rm_t *rm = arg;
+	osal_resrc_t *resrc;
+	int i;
+
+	for (i = 0; i < NUM_LOOPS; i++) {
+		resrc = osal_rm_alloc(rm);
+		if (resrc != NULL) {
+			osal_rm_free(rm, resrc);
+		}
+	}
+	return NULL;
+}
+
+static struct {
+	OSAL_RM_USEROBJMAN_DECLARE_CACHELINE(rmdata_t, MAX_RES)
+} s_cacheline;
+
+static void test_rm_cacheline(void **state)
+{
+	osal_resrc_t *resrces[MAX_RES];
+	uint8_t *obj;
+	int i;
+	(void)state;
+
+	OSAL_RM_USEROBJMAN_INIT_LAYOUT(&s_cacheline, MAX_RES, NULL, CACHELINE);
+	assert_int_equal(sizeof(s_cacheline.entries[0]) % OSAL_CACHELINE_SIZE, 0);
+	assert_int_equal(osal_rm_avail(&s_cacheline.rm), MAX_RES);
+
+	/* every entry holds its resource and its object on its own cache lines */
+	for (i = 0; i < MAX_RES; i++) {
+		resrces[i] = osal_rm_alloc(&s_cacheline.rm);
+		assert_non_null(resrces[i]);
+		assert_int_equal((uintptr_t)resrces[i] % OSAL_CACHELINE_SIZE, 0);
+		obj = resrces[i]->data;
+		assert_true(obj > (uint8_t *)resrces[i]);
+		assert_true(obj < (uint8_t *)resrces[i] + sizeof(s_cacheline.entries[0]));
+		assert_ptr_equal(osal_rm_resolve(&s_cacheline.rm,
+										 osal_rm_handle(&s_cacheline.rm, resrces[i])),
+						 resrces[i]);
+	}
+	assert_null(osal_rm_alloc(&s_cacheline.rm));
+	for (i = 0; i < MAX_RES; i++) {
+		osal_rm_free(&s_cacheline.rm, resrces[i]);
+	}
+	assert_int_equal(osal_rm_avail(&s_cacheline.rm), MAX_RES);
+	osal_rm_deinit(&s_cacheline.rm);
+}
+
+static void test_rm_threads(osal_rm_lock_t lock, osal_rm_policy_t policy)
+{
+	osal_rm_t rm;
+	rmdata_t rmdatas[NUM_THREADS];
+	osal_resrc_t resrces[NUM_THREADS];
+	uint64_t bitmap[OSAL_RM_BITMAP_WORDS(NUM_THREADS)];
+	osal_rm_cfg_t rmcfg;
+	pthread_t tids[NUM_THREADS];
+	int i;
+
+	memset(&rmcfg, 0, sizeof(rmcfg));
+	osal_mutex_init();
+	if (lock == OSAL_RM_LOCK_MUTEX) {
+		rmcfg.mutex = osal_mutex_create();
+		assert_non_null(rmcfg.mutex);
+	}
+	rmcfg.n_resrces = NUM_THREADS-1;
+	rmcfg.resrces = resrces;
+	rmcfg.lock = lock;
+	rmcfg.magazine = (OSAL_RM_MAGAZINE_SIZE > 0);
+	rmcfg.policy = policy;
+	rmcfg.bitmap = bitmap;
+	for (i = 0; i < NUM_THREADS; i++) {
+		resrces[i].data = &rmdatas[i];
+	}
+	assert_int_equal(osal_rm_init(&rm, &rmcfg), OSAL_E_OK);
+
+	for (i = 0; i < NUM_THREADS; i++) {
+		assert_int_equal(pthread_create(&tids[i], NULL, rm_thread, &rm), 0);
+	}
+	for (i = 0; i < NUM_THREADS; i++) {
+		pthread_join(tids[i], NULL);
+	}
+	/* the exited threads gave their cached resources back */
+	assert_int_equal(osal_rm_avail(&rm), NUM_THREADS-1);
+	assert_int_equal(osal_rm_use(&rm), 0);
+	for (i = 0; i < NUM_THREADS-1; i++) {
+		assert_non_null(osal_rm_alloc(&rm));
+	}
+	assert_null(osal_rm_alloc(&rm));
+	assert_int_equal(osal_rm_use(&rm), NUM_THREADS-1);
+
+	osal_rm_deinit(&rm);
+	if (rmcfg.mutex != NULL) {
+		osal_mutex_delete(rmcfg.mutex);
+	}
+	osal_mutex_deinit();
+}
+
+static void test_rm_threads_run(void **state)
+{
+	(void)state;
+
+	test_rm_threads(OSAL_RM_LOCK_MUTEX, OSAL_RM_POLICY_LIFO);
+	test_rm_threads(OSAL_RM_LOCK_SPIN, OSAL_RM_POLICY_LIFO);
+	test_rm_threads(OSAL_RM_LOCK_LOCKFREE, OSAL_RM_POLICY_LIFO);
+	test_rm_threads(OSAL_RM_LOCK_MUTEX, OSAL_RM_POLICY_BITMAP);
+}
+
+static sem_t s_cached;
+static sem_t s_exit;
+
+/* leave a resource in the magazine, then exit once told */
+static void *rm_cache_thread(void *arg)
+{
+	osal_rm_t *rm = arg;
+
+	osal_rm_free(rm, osal_rm_alloc(rm));
+	sem_post(&s_cached);
+	sem_wait(&s_exit);
+	return NULL;
+}
+
+static void test_rm_magazine_exit(void **state)
+{
+	osal_rm_t rm;
+	rmdata_t rmdatas[MAX_RES];
+	osal_resrc_t resrces[MAX_RES];
+	osal_rm_cfg_t rmcfg;
+	pthread_t tid;
+	uint32_t gen;
+	int i;
+	(void)state;
+
+	memset(&rmcfg, 0, sizeof(rmcfg));
+	rmcfg.n_resrces = MAX_RES;
+	rmcfg.resrces = resrces;
+	rmcfg.lock = OSAL_RM_LOCK_SPIN;
+	rmcfg.magazine = true;
+	for (i = 0; i < MAX_RES; i++) {
+		resrces[i].data = &rmdatas[i];
+	}
+	sem_init(&s_cached, 0, 0);
+	sem_init(&s_exit, 0, 0);
+	assert_int_equal(osal_rm_init(&rm, &rmcfg), OSAL_E_OK);
+	assert_int_equal(pthread_create(&tid, NULL, rm_cache_thread, &rm), 0);
+	sem_wait(&s_cached);
+
+	/* the pool is gone before the thread exits, its stale memory still
+	 * holding the generation the magazine was filled with */
+	gen = rm.mag_gen;
+	osal_rm_deinit(&rm);
+	rm.mag_gen = gen;
+	sem_post(&s_exit);
+	pthread_join(tid, NULL);
+	assert_int_equal(rm.n_cached, 0);
+	assert_int_equal(osal_rm_avail(&rm), 0);
+
+	sem_destroy(&s_cached);
+	sem_destroy(&s_exit);
+}
+
+static void test_rm_bitmap(void **state)
+{
+	osal_rm_t rm;
+	rmdata_t rmdatas[MAX_RES];
+	osal_resrc_t resrces[MAX_RES];
+	uint64_t bitmap[OSAL_RM_BITMAP_WORDS(MAX_RES)];
+	osal_resrc_t *bulk[MAX_RES];
+	osal_rm_cfg_t rmcfg;
+	int i;
+	(void)state;
+
+	memset(&rmcfg, 0, sizeof(rmcfg));
+	rmcfg.n_resrces = MAX_RES;
+	rmcfg.resrces = resrces;
+	rmcfg.policy = OSAL_RM_POLICY_BITMAP;
+	assert_int_equal(osal_rm_init(&rm, &rmcfg), OSAL_E_PARAM);
+
+	rmcfg.bitmap = bitmap;
+	for (i = 0; i < MAX_RES; i++) {
+		resrces[i].data = &rmdatas[i];
+	}
+	assert_int_equal(osal_rm_init(&rm, &rmcfg), OSAL_E_OK);
+	assert_int_equal(osal_rm_avail(&rm), MAX_RES);
+
+	/* the resources are taken in the index order */
+	for (i = 0; i < MAX_RES; i++) {
+		assert_ptr_equal(osal_rm_alloc(&rm), &resrces[i]);
+	}
+	assert_null(osal_rm_alloc(&rm));
+	assert_int_equal(osal_rm_use(&rm), MAX_RES);
+
+	/* the lowest free index comes back first, whatever the free order */
+	osal_rm_free(&rm, &resrces[70]);
+	osal_rm_free(&rm, &resrces[3]);
+	osal_rm_free(&rm, &resrces[64]);
+	assert_ptr_equal(osal_rm_alloc(&rm), &resrces[3]);
+	assert_ptr_equal(osal_rm_alloc(&rm), &resrces[64]);
+	assert_ptr_equal(osal_rm_alloc(&rm), &resrces[70]);
+
+	for (i = 0; i < MAX_RES; i++) {
+		bulk[i] = &resrces[MAX_RES-1-i];
+	}
+	osal_rm_free_bulk(&rm, bulk, MAX_RES);
+	assert_int_equal(osal_rm_avail(&rm), MAX_RES);
+	assert_int_equal(osal_rm_alloc_bulk(&rm, bulk, 10), 10);
+	for (i = 0; i < 10; i++) {
+		assert_ptr_equal(bulk[i], &resrces[i]);
 	}
+	assert_int_equal(osal_rm_use(&rm), 10);
+	osal_rm_deinit(&rm);
 }
 
 int main(void)
@@ -123,6 +460,12 @@ int main(void)
 
 	const struct CMUnitTest tests[] = {
 		cmocka_unit_test(test_rm_run),
+		cmocka_unit_test(test_rm_threads_run),
+		cmocka_unit_test(test_rm_bulk_run),
+		cmocka_unit_test(test_rm_handle),
+		cmocka_unit_test(test_rm_cacheline),
+		cmocka_unit_test(test_rm_bitmap),
+		cmocka_unit_test(test_rm_magazine_exit),
 	};
 	return cmocka_run_group_tests(tests, NULL, NULL);
 }
@@ -122,6 +122,40 @@ static void test_sem(void **state)
 	}
 }
 
+static void test_sem_handle(void **state)
+{
+	osal_handle_t handle;
+	osal_handle_t old_handle;
+	osal_sem_t *sem;
+	(void)state;
+
+	sem = osal_sem_create();
+	assert_non_null(sem);
+	handle = osal_sem_handle(sem);
+	assert_int_not_equal(handle, OSAL_HANDLE_INVALID);
+	assert_ptr_equal(osal_sem_resolve(handle), sem);
+	assert_int_equal(osal_sem_handle(NULL), OSAL_HANDLE_INVALID);
+	assert_null(osal_sem_resolve(OSAL_HANDLE_INVALID));
+
+	/* the generation changes with the delete */
+	osal_sem_delete(sem);
+	assert_null(osal_sem_resolve(handle));
+	old_handle = handle;
+	sem = osal_sem_create();
+	assert_non_null(sem);
+	handle = osal_sem_handle(sem);
+	assert_int_not_equal(handle, old_handle);
+	assert_null(osal_sem_resolve(old_handle));
+	assert_ptr_equal(osal_sem_resolve(handle), sem);
+
+	/* nothing resolves before the init, nor from a previous one */
+	osal_deinit();
+	assert_null(osal_sem_resolve(handle));
+	osal_init(NULL);
+	assert_null(osal_sem_resolve(handle));
+	assert_null(osal_sem_resolve(old_handle));
+}
+
 static int setup(void **state)
 {
 	(void)state;
@@ -142,6 +176,7 @@ int main(void)
 
 	const struct CMUnitTest tests[] = {
 		cmocka_unit_test_setup_teardown(test_sem, setup, teardown),
+		cmocka_unit_test_setup_teardown(test_sem_handle, setup, teardown),
 	};
 	return cmocka_run_group_tests(tests, NULL, NULL);
 }
@@ -121,6 +121,45 @@ static void test_task_delete(void **state)
 	assert_non_null(task);
 }
 
+static void test_task_handle(void **state)
+{
+	osal_task_cfg_t cfg = {
+		.task_handler = test_task_handler,
+		.task_arg = (void *)&test_task_handler
+	};
+	osal_handle_t handle;
+	osal_handle_t old_handle;
+	osal_task_t *task;
+	(void)state;
+
+	task = osal_task_create(&cfg);
+	assert_non_null(task);
+	handle = osal_task_handle(task);
+	assert_int_not_equal(handle, OSAL_HANDLE_INVALID);
+	assert_ptr_equal(osal_task_resolve(handle), task);
+	assert_int_equal(osal_task_handle(NULL), OSAL_HANDLE_INVALID);
+	assert_null(osal_task_resolve(OSAL_HANDLE_INVALID));
+
+	/* the generation changes with the delete */
+	osal_task_delete(task);
+	assert_null(osal_task_resolve(handle));
+	old_handle = handle;
+	task = osal_task_create(&cfg);
+	assert_non_null(task);
+	handle = osal_task_handle(task);
+	assert_int_not_equal(handle, old_handle);
+	assert_null(osal_task_resolve(old_handle));
+	assert_ptr_equal(osal_task_resolve(handle), task);
+
+	/* nothing resolves before the init, nor from a previous one */
+	osal_task_delete(task);
+	osal_deinit();
+	assert_null(osal_task_resolve(handle));
+	osal_init(NULL);
+	assert_null(osal_task_resolve(handle));
+	assert_null(osal_task_resolve(old_handle));
+}
+
 static int setup(void **state)
 {
 	(void)state;
@@ -143,6 +182,7 @@ int main(void)
 		cmocka_unit_test_setup_teardown(test_task_init, setup, teardown),
 		cmocka_unit_test_setup_teardown(test_task_create, setup, teardown),
 		cmocka_unit_test_setup_teardown(test_task_delete, setup, teardown),
+		cmocka_unit_test_setup_teardown(test_task_handle, setup, teardown),
 	};
 	return cmocka_run_group_tests(tests, NULL, NULL);
 }
@@ -0,0 +1,92 @@
+/* BSD 2-Clause License
+*
+* Copyright (c) 2025, nguyenvannam142@gmail.com
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*
+* 1. Redistributions of source code must retain the above copyright notice, this
+*    list of conditions and the following disclaimer.
+*
+* 2. Redistributions in binary form must reproduce the above copyright notice,
+*    this list of conditions and the following disclaimer in the documentation
+*    and/or other materials provided with the distribution.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "cmocka_include.h"
+#include "osal.h"
+
+static void test_timer_expire(void *arg)
+{
+	(void)arg;
+}
+
+static void test_timer_handle(void **state)
+{
+	osal_handle_t handle;
+	osal_handle_t old_handle;
+	osal_timer_t *timer;
+	(void)state;
+
+	timer = osal_timer_create(test_timer_expire, NULL);
+	assert_non_null(timer);
+	handle = osal_timer_handle(timer);
+	assert_int_not_equal(handle, OSAL_HANDLE_INVALID);
+	assert_ptr_equal(osal_timer_resolve(handle), timer);
+	assert_int_equal(osal_timer_handle(NULL), OSAL_HANDLE_INVALID);
+	assert_null(osal_timer_resolve(OSAL_HANDLE_INVALID));
+
+	/* the generation changes with the delete */
+	osal_timer_delete(timer);
+	assert_null(osal_timer_resolve(handle));
+	old_handle = handle;
+	timer = osal_timer_create(test_timer_expire, NULL);
+	assert_non_null(timer);
+	handle = osal_timer_handle(timer);
+	assert_int_not_equal(handle, old_handle);
+	assert_null(osal_timer_resolve(old_handle));
+	assert_ptr_equal(osal_timer_resolve(handle), timer);
+
+	/* nothing resolves before the init, nor from a previous one */
+	osal_timer_delete(timer);
+	osal_deinit();
+	assert_null(osal_timer_resolve(handle));
+	osal_init(NULL);
+	assert_null(osal_timer_resolve(handle));
+	assert_null(osal_timer_resolve(old_handle));
+}
+
+static int setup(void **state)
+{
+	(void)state;
+	osal_init(NULL);
+	return 0;
+}
+
+static int teardown(void **state)
+{
+	(void)state;
+	osal_deinit();
+	return 0;
+}
+
+int main(void)
+{
+	setenv("CMOCKA_TEST_ABORT", "1", 1);
+
+	const struct CMUnitTest tests[] = {
+		cmocka_unit_test_setup_teardown(test_timer_handle, setup, teardown),
+	};
+	return cmocka_run_group_tests(tests, NULL, NULL);
+}